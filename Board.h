@@ -63,6 +63,7 @@ extern "C" {
 #define transistorGatePin           EK_TM4C123GXL_PE1
 #define breathingPin                EK_TM4C123GXL_PE2
 #define howlingPin                  EK_TM4C123GXL_PE3
+#define servoPowerPin               EK_TM4C123GXL_PE4
 
 #define Board_I2C0                  EK_TM4C123GXL_I2C0
 #define Board_I2C1                  EK_TM4C123GXL_I2C3
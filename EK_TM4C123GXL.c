@@ -129,11 +129,13 @@ GPIO_PinConfig gpioPinConfigs[] = {
     /* EK_TM4C123GXL_PB7 */
     GPIOTiva_PB_7 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_HIGH | GPIO_CFG_OUT_LOW, //Distance Sensor Trigger
     /* EK_TM4C123GXL_PE1 */
-    GPIOTiva_PE_1 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_HIGH | GPIO_CFG_OUT_LOW, //transistor gate pin
+    GPIOTiva_PE_1 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_LOW, //transistor gate pin (low = solenoid off until a show)
     /* EK_TM4C123GXL_PE1 */
     GPIOTiva_PE_2 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_HIGH | GPIO_CFG_OUT_LOW, //breathing pin
     /* EK_TM4C123GXL_PE1 */
     GPIOTiva_PE_3 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_HIGH | GPIO_CFG_OUT_LOW, //howling pin
+    /* EK_TM4C123GXL_PE4 */
+    GPIOTiva_PE_4 | GPIO_CFG_OUT_STD | GPIO_CFG_OUT_STR_HIGH | GPIO_CFG_OUT_HIGH, //servo power rail (high = powered)
 };
 
 /*
@@ -166,6 +168,25 @@ void EK_TM4C123GXL_initGPIO(void)
 
 
 
+/*
+ *  =============================== UART ===============================
+ */
+/*
+ *  ======== EK_TM4C123GXL_initUART ========
+ *  UART0 is driven directly with driverlib and uDMA by uartLinkTiva.c, so
+ *  only the clock and pin muxing are set up here (no UART_config/UART_init).
+ */
+void EK_TM4C123GXL_initUART(void)
+{
+    /* Enable and configure the peripherals used by the uart. */
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UART0);
+    GPIOPinConfigure(GPIO_PA0_U0RX);
+    GPIOPinConfigure(GPIO_PA1_U0TX);
+    GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
+}
+
+
+
 /*
  *  =============================== PWM ===============================
  */
@@ -36,7 +36,9 @@
 
 MEMORY
 {
-    FLASH (RX) : origin = 0x00000000, length = 0x00040000
+    FLASH (RX) : origin = 0x00000000, length = 0x00020000
+    /* upper 128 KB: event log pages, written at run time (flashLog.h) */
+    FLASHLOG (R) : origin = 0x00020000, length = 0x00020000
     SRAM (RWX) : origin = 0x20000000, length = 0x00008000
 }
 
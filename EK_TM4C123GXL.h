@@ -64,6 +64,7 @@ typedef enum EK_TM4C123GXL_GPIOName {
     EK_TM4C123GXL_PE1,
     EK_TM4C123GXL_PE2,
     EK_TM4C123GXL_PE3,
+    EK_TM4C123GXL_PE4,
 
     EK_TM4C123GXL_GPIOCOUNT
 } EK_TM4C123GXL_GPIOName;
@@ -229,11 +230,9 @@ extern void EK_TM4C123GXL_initSPI(void);
 /*!
  *  @brief  Initialize board specific UART settings
  *
- *  This function initializes the board specific UART settings and then calls
- *  the UART_init API to initialize the UART module.
- *
- *  The UART peripherals controlled by the UART module are determined by the
- *  UART_config variable.
+ *  This function enables UART0 and muxes PA0/PA1 to it. The werewolf drives
+ *  UART0 directly with uDMA (see uartLinkTiva.c), so UART_init is not called
+ *  and there is no UART_config.
  */
 extern void EK_TM4C123GXL_initUART(void);
 
@@ -0,0 +1,16 @@
+/*
+ *  ======== appLog.c ========
+ *  Per-module log levels - see appLog.h.
+ */
+
+#include <stdint.h>
+
+#include "appLog.h"
+
+/* warnings and errors until main applies the configured levels */
+volatile uint8_t appLogLevels[AppLog_MODULES] = {
+    [AppLog_HeadTurn]       = AppLog_Warn,
+    [AppLog_HeadLift]       = AppLog_Warn,
+    [AppLog_MouthOpenClose] = AppLog_Warn,
+    [AppLog_DistSensor]     = AppLog_Warn,
+};
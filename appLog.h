@@ -0,0 +1,95 @@
+/*
+ *  ======== appLog.h ========
+ *  Per-module log levels that can be changed while the prop runs.
+ *
+ *  Each module's current level is one byte in appLogLevels[]. Change it
+ *  with AppLog_setLevel(), or write the array from the CCS expressions
+ *  window - no rebuild or reflash. A disabled check is a single load and
+ *  branch:
+ *
+ *      if (AppLog_enabled(AppLog_HeadLift, AppLog_Debug)) { ... }
+ *      AppLog_printf(AppLog_DistSensor, AppLog_Info, "Raising body...\n");
+ *
+ *  AppLog_CEILING is the most verbose level compiled in. Anything above it
+ *  folds to a constant false and the call disappears, so release builds
+ *  use --define=AppLog_CEILING=AppLog_Warn to drop Info and Debug
+ *  entirely.
+ *
+ *  AppLog_printf goes to System_printf, which SysMin buffers until the
+ *  next flush; it never flushes per message.
+ *
+ *  (Not xdc.runtime.Log - that module already owns the Log_ prefix.)
+ */
+
+#ifndef __APPLOG_H
+#define __APPLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/System.h>
+
+/*!
+ *  @def    AppLog_Level
+ */
+typedef enum AppLog_Level {
+    AppLog_Off = 0,
+    AppLog_Error,
+    AppLog_Warn,
+    AppLog_Info,
+    AppLog_Debug
+} AppLog_Level;
+
+#ifndef AppLog_CEILING
+#define AppLog_CEILING      AppLog_Debug
+#endif
+
+/*!
+ *  @def    AppLog_Module
+ */
+typedef enum AppLog_Module {
+    AppLog_HeadTurn = 0,
+    AppLog_HeadLift,
+    AppLog_MouthOpenClose,
+    AppLog_DistSensor,
+
+    AppLog_MODULES
+} AppLog_Module;
+
+extern volatile uint8_t appLogLevels[AppLog_MODULES];
+
+#define AppLog_enabled(module, level) \
+    ((level) <= AppLog_CEILING && appLogLevels[module] >= (level))
+
+#define AppLog_printf(module, level, ...) \
+    do { \
+        if (AppLog_enabled(module, level)) { \
+            System_printf(__VA_ARGS__); \
+        } \
+    } while (0)
+
+/*!
+ *  @brief  Set one module's level; callable from any context
+ */
+static inline void AppLog_setLevel(AppLog_Module module, AppLog_Level level)
+{
+    appLogLevels[module] = (uint8_t)level;
+}
+
+/*!
+ *  @brief  Current level of one module
+ */
+static inline AppLog_Level AppLog_getLevel(AppLog_Module module)
+{
+    return ((AppLog_Level)appLogLevels[module]);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APPLOG_H */
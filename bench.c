@@ -0,0 +1,331 @@
+/*
+ *  ======== bench.c ========
+ *  Kernels, budgets and the measurement loop - see bench.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/System.h>
+
+#include <ti/sysbios/knl/Task.h>
+#include <ti/drivers/PWM.h>
+
+#include "bench.h"
+#include "cycles.h"
+#include "detect.h"
+#include "easing.h"
+#include "servo.h"
+#include "motion.h"
+#include "trace.h"
+
+/* inputs cycle through a small table so the loads stay in cache */
+#define BENCH_INPUTS        64
+#define BENCH_INPUT_MASK    (BENCH_INPUTS - 1)
+
+#define BENCH_TASK_STACK    1024
+
+/* random echo durations up to past the 38 ms timeout, angles and phases */
+static uint16_t     benchDurations[BENCH_INPUTS];
+static uint16_t     benchDistances[BENCH_INPUTS];
+static Servo_Angle  benchAngles[BENCH_INPUTS];
+static Easing_Phase benchPhases[BENCH_INPUTS];
+static Detect_State benchDetect;
+static bool         benchServoOpen = false;
+
+static Task_Struct  benchTaskStruct;
+static UInt8        benchTaskStack[BENCH_TASK_STACK];
+
+/*
+ *  ======== benchSetupInputs ========
+ */
+static void benchSetupInputs(void)
+{
+    uint32_t random = 0x2545F491;
+    uint32_t i;
+
+    for (i = 0; i < BENCH_INPUTS; i++) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        benchDurations[i] = (uint16_t)(random % 40000);
+        benchDistances[i] = Detect_distance(benchDurations[i]);
+        benchAngles[i] = (Servo_Angle)(random % (Servo_ANGLE_MAX + 1));
+        benchPhases[i] = (Easing_Phase)(random >> 16);
+    }
+}
+
+/*
+ *  ======== benchNone ========
+ *  The loop every kernel runs in, without the kernel
+ */
+static uint32_t benchNone(uint32_t calls)
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < calls; i++) {
+        sum += benchDurations[i & BENCH_INPUT_MASK];
+    }
+
+    return (sum);
+}
+
+/*
+ *  ======== benchDistance ========
+ */
+static uint32_t benchDistance(uint32_t calls)
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < calls; i++) {
+        sum += Detect_distance(benchDurations[i & BENCH_INPUT_MASK]);
+    }
+
+    return (sum);
+}
+
+/*
+ *  ======== benchSetupFilter ========
+ */
+static void benchSetupFilter(void)
+{
+    Detect_Params params = { 10, 72, 2 };
+
+    Detect_init(&benchDetect, &params);
+}
+
+/*
+ *  ======== benchFilter ========
+ */
+static uint32_t benchFilter(uint32_t calls)
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < calls; i++) {
+        sum += Detect_sample(&benchDetect, benchDistances[i & BENCH_INPUT_MASK]);
+    }
+
+    return (sum);
+}
+
+/*
+ *  ======== benchEasing ========
+ */
+static uint32_t benchEasing(uint32_t calls)
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < calls; i++) {
+        sum += Easing_lerp(Easing_EaseInOut, benchPhases[i & BENCH_INPUT_MASK],
+                           Servo_ANGLE_MIN, Servo_ANGLE_MAX);
+    }
+
+    return (sum);
+}
+
+/*
+ *  ======== benchSetupServo ========
+ */
+static void benchSetupServo(void)
+{
+    if (!benchServoOpen) {
+        benchServoOpen = (Servo_open(Servo_HeadSideToSide, 20000) != NULL);
+        if (!benchServoOpen) {
+            System_abort("bench: Servo_open failed\n");
+        }
+    }
+    Motion_setNoise(Servo_HeadSideToSide, 30, 4000, 20, 40);
+}
+
+/*
+ *  ======== benchDuty ========
+ */
+static uint32_t benchDuty(uint32_t calls)
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < calls; i++) {
+        sum += Servo_dutyForAngle(Servo_HeadSideToSide, benchAngles[i & BENCH_INPUT_MASK]);
+    }
+
+    return (sum);
+}
+
+/*
+ *  ======== benchMotion ========
+ *  One motion task tick: new base position, mix, and out to the PWM
+ */
+static uint32_t benchMotion(uint32_t calls)
+{
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < calls; i++) {
+        Motion_setLayer(Servo_HeadSideToSide, Motion_Base, benchAngles[i & BENCH_INPUT_MASK]);
+        sum += Motion_update(Servo_HeadSideToSide);
+    }
+
+    return (sum);
+}
+
+/*
+ *  ======== benchTrace ========
+ */
+static uint32_t benchTrace(uint32_t calls)
+{
+    uint32_t i;
+
+    for (i = 0; i < calls; i++) {
+        Trace_event(Trace_Ping, benchDurations[i & BENCH_INPUT_MASK], i);
+    }
+
+    return (calls);
+}
+
+/*
+ * Budgets: cycles are for the TI compiler at -O2 on the TM4C123 (80 MHz,
+ * flash wait states included); ns are for the host build (-O2 -flto) on a
+ * desktop x86, about 4x what it measured when the budget was set.
+ * motionMix includes the PWM driver call in Servo_setAngle.
+ */
+const Bench_Kernel Bench_kernels[] = {
+    { "distance",     NULL,             benchDistance,   20,  1.0f },
+    { "filter",       benchSetupFilter, benchFilter,     30,  4.0f },
+    { "easing",       NULL,             benchEasing,     40,  2.5f },
+    { "dutyForAngle", benchSetupServo,  benchDuty,       80,  6.5f },
+    { "motionMix",    benchSetupServo,  benchMotion,   1500, 50.0f },
+    { "traceEvent",   NULL,             benchTrace,     120,  8.0f },
+};
+
+const uint32_t Bench_kernelCount = sizeof(Bench_kernels) / sizeof(Bench_kernels[0]);
+
+/* keeps every kernel's result live */
+volatile uint32_t benchSink;
+
+/*
+ *  ======== benchSort ========
+ */
+static void benchSort(float *values, uint32_t count)
+{
+    uint32_t i;
+    uint32_t j;
+    float    value;
+
+    for (i = 1; i < count; i++) {
+        value = values[i];
+        for (j = i; j > 0 && values[j - 1] > value; j--) {
+            values[j] = values[j - 1];
+        }
+        values[j] = value;
+    }
+}
+
+/*
+ *  ======== Bench_measure ========
+ */
+void Bench_measure(const Bench_Kernel *kernel, Bench_Clock clock,
+                   uint32_t minBatch, Bench_Result *result)
+{
+    float    samples[Bench_SAMPLES];
+    uint32_t calls = 1;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t base;
+    uint32_t sample;
+
+    benchSetupInputs();
+    if (kernel->setup != NULL) {
+        kernel->setup();
+    }
+
+    /* also warms the caches and the branch predictor */
+    for (;;) {
+        start = clock();
+        benchSink += kernel->run(calls);
+        elapsed = clock() - start;
+        if (elapsed >= minBatch || calls >= 0x40000000) {
+            break;
+        }
+        calls *= 2;
+    }
+
+    for (sample = 0; sample < Bench_SAMPLES; sample++) {
+        start = clock();
+        benchSink += kernel->run(calls);
+        elapsed = clock() - start;
+
+        start = clock();
+        benchSink += benchNone(calls);
+        base = clock() - start;
+
+        samples[sample] = ((float)elapsed - (float)base) / (float)calls;
+    }
+
+    benchSort(samples, Bench_SAMPLES);
+    result->calls = calls;
+    result->min = samples[0];
+    result->median = samples[Bench_SAMPLES / 2];
+    result->p90 = samples[(Bench_SAMPLES * 9) / 10];
+    result->max = samples[Bench_SAMPLES - 1];
+}
+
+/*
+ *  ======== benchRound ========
+ */
+static int benchRound(float value)
+{
+    return ((int)((value < 0.0f) ? value - 0.5f : value + 0.5f));
+}
+
+/*
+ *  ======== benchTaskFxn ========
+ *  On the board: a batch of at least 100 us per sample
+ */
+static Void benchTaskFxn(UArg arg0, UArg arg1)
+{
+    Bench_Result result;
+    uint32_t     kernel;
+    uint32_t     over = 0;
+
+    /* flushed line by line, the report being longer than SysMin's buffer */
+    Cycles_init();
+    System_printf("bench: cycles per call, median (min..p90) / budget\n");
+    System_flush();
+
+    for (kernel = 0; kernel < Bench_kernelCount; kernel++) {
+        Bench_measure(&Bench_kernels[kernel], Cycles_get, 8000, &result);
+        System_printf("bench: %-14s %6d (%d..%d) / %d%s\n", Bench_kernels[kernel].name,
+                      benchRound(result.median), benchRound(result.min), benchRound(result.p90),
+                      Bench_kernels[kernel].budgetCycles,
+                      (result.median > Bench_kernels[kernel].budgetCycles) ? "  OVER BUDGET" : "");
+        System_flush();
+        if (result.median > Bench_kernels[kernel].budgetCycles) {
+            over++;
+        }
+    }
+
+    if (over != 0) {
+        System_abort("bench: kernels over budget\n");
+    }
+    System_printf("bench: %d kernels within budget\n", Bench_kernelCount);
+    System_flush();
+}
+
+/*
+ *  ======== Bench_start ========
+ */
+void Bench_start(void)
+{
+    Task_Params params;
+
+    Task_Params_init(&params);
+    params.stackSize = BENCH_TASK_STACK;
+    params.stack = &benchTaskStack;
+    Task_construct(&benchTaskStruct, (Task_FuncPtr)benchTaskFxn, &params, NULL);
+}
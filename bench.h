@@ -0,0 +1,92 @@
+/*
+ *  ======== bench.h ========
+ *  Microbenchmarks for the kernels on the sensing and motion paths:
+ *  distance conversion and the trigger filter (detect.h), easing-curve
+ *  interpolation and the motion mixer (easing.h, motion.h), angle to duty
+ *  interpolation (servo.h) and trace record encoding (trace.h).
+ *
+ *  Every kernel has a budget per call, kept in Bench_kernels[] in bench.c
+ *  next to the kernel: CPU cycles on the board and nanoseconds on a host
+ *  build. A change that makes a kernel slower has to raise its budget in
+ *  the same commit.
+ *
+ *  Each sample times a batch of calls, then the same batch with the
+ *  kernel left out, and keeps the difference, so loop and input overhead
+ *  drop out. The median of Bench_SAMPLES samples is compared with the
+ *  budget.
+ *
+ *  On the board: build with --define=Bench_IMAGE=1 and main() starts the
+ *  benchmark task instead of the prop. It prints cycles per call for each
+ *  kernel with System_printf (DWT CYCCNT, cycles.h) and calls System_abort
+ *  if any kernel is over budget. On a host: host/benchMain.c times the
+ *  same kernels with the monotonic clock (make -C host bench).
+ */
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef Bench_IMAGE
+#define Bench_IMAGE         0
+#endif
+
+/* timed batches per kernel; odd, so there is a middle one */
+#ifndef Bench_SAMPLES
+#define Bench_SAMPLES       31
+#endif
+
+/*!
+ *  @def    Bench_Kernel
+ */
+typedef struct Bench_Kernel {
+    const char *name;
+    void      (*setup)(void);
+    uint32_t  (*run)(uint32_t calls);   /* returns a checksum so nothing is optimised away */
+    uint32_t    budgetCycles;           /* per call, on the board */
+    float       budgetNs;               /* per call, on a host build */
+} Bench_Kernel;
+
+/*!
+ *  @def    Bench_Result
+ *  @brief  Cost per call, in the units of the clock it was measured with
+ */
+typedef struct Bench_Result {
+    uint32_t calls;                     /* per sample */
+    float    min;
+    float    median;
+    float    p90;
+    float    max;
+} Bench_Result;
+
+/*!
+ *  @brief  A free-running counter; wraps modulo 2^32
+ */
+typedef uint32_t (*Bench_Clock)(void);
+
+extern const Bench_Kernel Bench_kernels[];
+extern const uint32_t     Bench_kernelCount;
+
+/*!
+ *  @brief  Time one kernel
+ *
+ *  Doubles the batch until it takes at least minBatch clock units, then
+ *  takes Bench_SAMPLES samples. Calls the kernel's setup first.
+ */
+extern void Bench_measure(const Bench_Kernel *kernel, Bench_Clock clock,
+                          uint32_t minBatch, Bench_Result *result);
+
+/*!
+ *  @brief  Start the on-target benchmark task; call before BIOS_start
+ */
+extern void Bench_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_H */
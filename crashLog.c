@@ -0,0 +1,145 @@
+/*
+ *  ======== crashLog.c ========
+ *  Crash flight recorder - see crashLog.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/System.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "crashLog.h"
+#include "taskMon.h"
+#include "trace.h"
+
+static bool               crashLogOpen = false;
+static bool               crashLogSaved = false;
+static bool               crashLogHavePrevious = false;
+static CrashLog_Snapshot  crashLogPrevious;
+static CrashLog_Snapshot  crashLogSnapshot;     /* assembled here, not on a faulted stack */
+static CrashLog_StateNote crashLogStates[CrashLog_STATES];
+static uint32_t           crashLogStateWrites;
+
+/*
+ *  ======== CrashLog_init ========
+ */
+bool CrashLog_init(void)
+{
+    CrashLog_Snapshot *prev = &crashLogPrevious;
+
+    if (!CrashLog_portOpen()) {
+        return (false);
+    }
+    crashLogOpen = true;
+
+    CrashLog_portRead(prev);
+    if (prev->magic != CrashLog_MAGIC || prev->size != sizeof(CrashLog_Snapshot)) {
+        return (false);
+    }
+    crashLogHavePrevious = true;
+    CrashLog_portClear();
+
+    System_printf("Previous boot crashed: %s in task %d at %d ticks, pc 0x%x cfsr 0x%x\n",
+                  (prev->reason == CrashLog_Exception) ? "exception" : "abort",
+                  (prev->task == CrashLog_NOT_TASK) ? -1 : prev->task,
+                  prev->uptimeTicks, prev->regs.pc, prev->regs.cfsr);
+    Trace_event(Trace_Crash, prev->reason | ((uint32_t)prev->task << 16), prev->regs.pc);
+
+    return (true);
+}
+
+/*
+ *  ======== CrashLog_previous ========
+ */
+const CrashLog_Snapshot *CrashLog_previous(void)
+{
+    return (crashLogHavePrevious ? &crashLogPrevious : NULL);
+}
+
+/*
+ *  ======== CrashLog_noteState ========
+ */
+void CrashLog_noteState(uint32_t state)
+{
+    UInt key = Hwi_disable();
+    CrashLog_StateNote *note = &crashLogStates[crashLogStateWrites % CrashLog_STATES];
+
+    note->tick = Clock_getTicks();
+    note->state = state;
+    crashLogStateWrites++;
+
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== CrashLog_save ========
+ */
+void CrashLog_save(CrashLog_Reason reason, uint16_t task, const CrashLog_Registers *regs)
+{
+    CrashLog_Snapshot *snap = &crashLogSnapshot;
+    uint32_t           count;
+    uint32_t           first;
+    uint32_t           i;
+    UInt               key;
+
+    key = Hwi_disable();
+
+    if (!crashLogOpen || crashLogSaved) {
+        Hwi_restore(key);
+        return;
+    }
+    crashLogSaved = true;
+
+    memset(snap, 0, sizeof(*snap));
+    snap->size = sizeof(CrashLog_Snapshot);
+    snap->reason = reason;
+    snap->uptimeTicks = Clock_getTicks();
+    snap->task = task;
+    if (regs != NULL) {
+        snap->regs = *regs;
+    }
+
+    count = (crashLogStateWrites < CrashLog_STATES) ? crashLogStateWrites : CrashLog_STATES;
+    first = crashLogStateWrites - count;
+    for (i = 0; i < count; i++) {
+        snap->states[i] = crashLogStates[(first + i) % CrashLog_STATES];
+    }
+    snap->stateCount = count;
+
+    count = (traceBuffer.writeCount < CrashLog_TRACE_RECORDS) ?
+        traceBuffer.writeCount : CrashLog_TRACE_RECORDS;
+    first = traceBuffer.writeCount - count;
+    for (i = 0; i < count; i++) {
+        snap->trace[i] = traceBuffer.ring[(first + i) & (Trace_RECORDS - 1)];
+    }
+
+    /* the port writes the magic word last */
+    snap->magic = CrashLog_MAGIC;
+    CrashLog_portWrite(snap);
+
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== CrashLog_abortHook ========
+ *  Also reached after an exception, once the kernel has reported it - the
+ *  exception's snapshot is the one kept.
+ */
+Void CrashLog_abortHook(void)
+{
+    uint16_t task = CrashLog_NOT_TASK;
+
+    if (BIOS_getThreadType() == BIOS_ThreadType_Task) {
+        task = TaskMon_idOf(Task_self());
+    }
+    CrashLog_save(CrashLog_Abort, task, NULL);
+
+    System_abortStd();
+}
@@ -0,0 +1,137 @@
+/*
+ *  ======== crashLog.h ========
+ *  Crash flight recorder.
+ *
+ *  The recorder keeps the last few state transitions in a small RAM ring
+ *  of its own (the trace ring turns over in under a second once the servos
+ *  are moving). When the prop dies - a CPU exception, or System_abort - the
+ *  hook assembles one CrashLog_Snapshot: fault registers, the running
+ *  task, the state ring and the newest trace records, and the port writes
+ *  it to non-volatile storage. Only the first fault of a boot is kept.
+ *
+ *  At the next boot CrashLog_init() reads the snapshot back, reports it
+ *  (System_printf and a Trace_Crash record) and clears it; the copy stays
+ *  available through CrashLog_previous().
+ *
+ *  The snapshot is 60 words and is written with interrupts masked and
+ *  nothing that blocks, so the handler's time is the storage's own
+ *  programming time. The magic word is written last, so a snapshot cut short by a reset is
+ *  ignored rather than misread.
+ */
+
+#ifndef __CRASHLOG_H
+#define __CRASHLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <xdc/std.h>
+
+#include "trace.h"
+
+/* "WWCR" */
+#define CrashLog_MAGIC          0x52435757
+
+#define CrashLog_STATES         8
+#define CrashLog_TRACE_RECORDS  8
+
+/* CrashLog_Snapshot.task when the fault was not in a Task */
+#define CrashLog_NOT_TASK       0xFFFF
+
+/*!
+ *  @def    CrashLog_Reason
+ */
+typedef enum CrashLog_Reason {
+    CrashLog_None = 0,
+    CrashLog_Exception,     /* CPU fault - the register fields are valid */
+    CrashLog_Abort          /* System_abort - only uptime, task and the rings */
+} CrashLog_Reason;
+
+/*!
+ *  @def    CrashLog_Registers
+ *  @brief  Fault state captured by the exception hook
+ */
+typedef struct CrashLog_Registers {
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t psr;
+    uint32_t sp;
+    uint32_t cfsr;          /* configurable fault status */
+    uint32_t hfsr;          /* hard fault status */
+    uint32_t mmfar;         /* memory manage fault address */
+    uint32_t bfar;          /* bus fault address */
+} CrashLog_Registers;
+
+/*!
+ *  @def    CrashLog_StateNote
+ */
+typedef struct CrashLog_StateNote {
+    uint32_t tick;          /* Clock ticks */
+    uint32_t state;         /* state_values */
+} CrashLog_StateNote;
+
+/*!
+ *  @def    CrashLog_Snapshot
+ *  @brief  What is written on a fault, little endian
+ */
+typedef struct CrashLog_Snapshot {
+    uint32_t           magic;       /* CrashLog_MAGIC when valid */
+    uint16_t           size;        /* sizeof(CrashLog_Snapshot) */
+    uint16_t           reason;      /* CrashLog_Reason */
+    uint32_t           uptimeTicks;
+    uint16_t           task;        /* TaskMon_Id, or CrashLog_NOT_TASK */
+    uint16_t           stateCount;  /* valid entries in states[] */
+    CrashLog_Registers regs;
+    CrashLog_StateNote states[CrashLog_STATES];         /* oldest first */
+    Trace_Record       trace[CrashLog_TRACE_RECORDS];   /* oldest first */
+} CrashLog_Snapshot;
+
+/*!
+ *  @brief  Open storage and pick up the previous boot's snapshot
+ *
+ *  Call after Trace_init() so the report reaches the trace.
+ *
+ *  @return true if the previous boot ended in a crash
+ */
+extern bool CrashLog_init(void);
+
+/*!
+ *  @brief  The previous boot's snapshot, or NULL
+ */
+extern const CrashLog_Snapshot *CrashLog_previous(void);
+
+/*!
+ *  @brief  Remember a state transition
+ */
+extern void CrashLog_noteState(uint32_t state);
+
+/*!
+ *  @brief  Snapshot and store; regs may be NULL
+ */
+extern void CrashLog_save(CrashLog_Reason reason, uint16_t task,
+                          const CrashLog_Registers *regs);
+
+/*!
+ *  @brief  System.abortFxn - referenced from pwmled.cfg
+ */
+extern Void CrashLog_abortHook(void);
+
+/*
+ * Port - implemented once per platform (crashLogTiva.c on the board, which
+ * also installs the exception hook)
+ */
+
+extern bool CrashLog_portOpen(void);
+extern void CrashLog_portRead(CrashLog_Snapshot *snapshot);
+extern void CrashLog_portWrite(const CrashLog_Snapshot *snapshot);
+extern void CrashLog_portClear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRASHLOG_H */
@@ -0,0 +1,97 @@
+/*
+ *  ======== crashLogTiva.c ========
+ *  CrashLog port for the EK_TM4C123GXL: the snapshot lives at the start of
+ *  the TM4C123's 2 KB on-chip EEPROM (four 64-byte blocks), and the
+ *  exception hook reads the fault registers straight from the SCB.
+ *
+ *  EEPROMProgram() polls for completion and needs no interrupts, so it is
+ *  usable from inside the exception.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/family/arm/m3/Hwi.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include <inc/hw_memmap.h>
+#include <inc/hw_nvic.h>
+#include <inc/hw_types.h>
+
+#include <driverlib/eeprom.h>
+#include <driverlib/sysctl.h>
+
+#include "crashLog.h"
+#include "taskMon.h"
+
+#define CRASHLOG_EEPROM_ADDRESS 0
+
+/*
+ *  ======== CrashLog_excHook ========
+ *  m3Hwi.excHookFunc - runs before the kernel decodes the exception
+ */
+Void CrashLog_excHook(Hwi_ExcContext *excp)
+{
+    CrashLog_Registers regs;
+    uint16_t           task = CrashLog_NOT_TASK;
+
+    regs.pc = (uint32_t)excp->pc;
+    regs.lr = (uint32_t)excp->lr;
+    regs.psr = (uint32_t)excp->psr;
+    regs.sp = (uint32_t)excp->sp;
+    regs.cfsr = HWREG(NVIC_FAULT_STAT);
+    regs.hfsr = HWREG(NVIC_HFAULT_STAT);
+    regs.mmfar = HWREG(NVIC_MM_ADDR);
+    regs.bfar = HWREG(NVIC_FAULT_ADDR);
+
+    if (excp->threadType == BIOS_ThreadType_Task) {
+        task = TaskMon_idOf((Task_Handle)excp->threadHandle);
+    }
+
+    CrashLog_save(CrashLog_Exception, task, &regs);
+}
+
+/*
+ *  ======== CrashLog_portOpen ========
+ */
+bool CrashLog_portOpen(void)
+{
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0)) {
+        ;
+    }
+
+    return (EEPROMInit() == EEPROM_INIT_OK &&
+            EEPROMSizeGet() >= CRASHLOG_EEPROM_ADDRESS + sizeof(CrashLog_Snapshot));
+}
+
+/*
+ *  ======== CrashLog_portRead ========
+ */
+void CrashLog_portRead(CrashLog_Snapshot *snapshot)
+{
+    EEPROMRead((uint32_t *)snapshot, CRASHLOG_EEPROM_ADDRESS, sizeof(CrashLog_Snapshot));
+}
+
+/*
+ *  ======== CrashLog_portWrite ========
+ *  Body first, magic word last
+ */
+void CrashLog_portWrite(const CrashLog_Snapshot *snapshot)
+{
+    EEPROMProgram((uint32_t *)snapshot + 1, CRASHLOG_EEPROM_ADDRESS + sizeof(uint32_t),
+                  sizeof(CrashLog_Snapshot) - sizeof(uint32_t));
+    EEPROMProgram((uint32_t *)snapshot, CRASHLOG_EEPROM_ADDRESS, sizeof(uint32_t));
+}
+
+/*
+ *  ======== CrashLog_portClear ========
+ */
+void CrashLog_portClear(void)
+{
+    uint32_t blank = 0;
+
+    EEPROMProgram(&blank, CRASHLOG_EEPROM_ADDRESS, sizeof(blank));
+}
@@ -0,0 +1,63 @@
+/*
+ *  ======== cycles.h ========
+ *  Cortex-M4 DWT cycle counter.
+ *
+ *  CYCCNT counts CPU clocks (80 MHz on the werewolf) and wraps every ~53 s,
+ *  so differences of two reads are valid for anything shorter than that.
+ *  Reading it is a single load.
+ */
+
+#ifndef __CYCLES_H
+#define __CYCLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Only on the board: the CCS project defines PART_TM4C123GH6PM. __arm__
+ * alone would also pick this on an ARM Linux host (a Raspberry Pi running
+ * host/), where these addresses are not the DWT.
+ */
+#if defined(__TI_COMPILER_VERSION__) || defined(PART_TM4C123GH6PM)
+
+#define CYCLES_DEMCR        (*(volatile uint32_t *)0xE000EDFC)
+#define CYCLES_DWT_CTRL     (*(volatile uint32_t *)0xE0001000)
+#define CYCLES_DWT_CYCCNT   (*(volatile uint32_t *)0xE0001004)
+
+#define CYCLES_DEMCR_TRCENA         (1u << 24)
+#define CYCLES_DWT_CTRL_CYCCNTENA   (1u << 0)
+
+/*
+ *  ======== Cycles_init ========
+ *  Safe to call more than once
+ */
+static inline void Cycles_init(void)
+{
+    CYCLES_DEMCR |= CYCLES_DEMCR_TRCENA;
+    CYCLES_DWT_CTRL |= CYCLES_DWT_CTRL_CYCCNTENA;
+}
+
+/*
+ *  ======== Cycles_get ========
+ */
+static inline uint32_t Cycles_get(void)
+{
+    return (CYCLES_DWT_CYCCNT);
+}
+
+#else
+
+/* no DWT off-target - the platform layer supplies a counter */
+extern void     Cycles_init(void);
+extern uint32_t Cycles_get(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CYCLES_H */
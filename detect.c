@@ -0,0 +1,35 @@
+/*
+ *  ======== detect.c ========
+ */
+
+#include <stdint.h>
+
+#include "detect.h"
+
+/*
+ *  ======== Detect_init ========
+ */
+void Detect_init(Detect_State *state, const Detect_Params *params)
+{
+    state->params = *params;
+    state->hits = 0;
+}
+
+/*
+ *  ======== Detect_sample ========
+ */
+Detect_Result Detect_sample(Detect_State *state, uint16_t distance)
+{
+    if (distance < state->params.minDistance || distance > state->params.maxDistance) {
+        state->hits = 0;
+        return (Detect_Miss);
+    }
+
+    state->hits++;
+    if (state->hits < state->params.requiredHits) {
+        return (Detect_Hit);
+    }
+
+    state->hits = 0;
+    return (Detect_Trigger);
+}
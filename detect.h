@@ -0,0 +1,74 @@
+/*
+ *  ======== detect.h ========
+ *  The trigger decision: turns each ping's echo duration into a distance
+ *  and decides whether a visitor is standing in the trigger window.
+ *
+ *  distSensorFxn feeds it live pings; host/replay.c feeds it pings
+ *  recorded in the flash log (FlashLog_Range), so the same samples give
+ *  the same decisions on the bench as they did in the yard.
+ *
+ *  A trigger takes Detect_Params.requiredHits in-window distances in a
+ *  row; anything outside the window, including an echo timeout, starts
+ *  the count again.
+ */
+
+#ifndef __DETECT_H
+#define __DETECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*!
+ *  @def    Detect_Result
+ */
+typedef enum Detect_Result {
+    Detect_Miss = 0,        /* outside the window */
+    Detect_Hit,             /* in the window, not enough in a row yet */
+    Detect_Trigger          /* in the window, enough in a row - start the show */
+} Detect_Result;
+
+/*!
+ *  @def    Detect_Params
+ */
+typedef struct Detect_Params {
+    int minDistance;        /* inches */
+    int maxDistance;        /* inches */
+    int requiredHits;
+} Detect_Params;
+
+/*!
+ *  @def    Detect_State
+ */
+typedef struct Detect_State {
+    Detect_Params params;
+    int           hits;     /* in-window distances in a row */
+} Detect_State;
+
+/*!
+ *  @brief  Start counting from zero
+ */
+extern void Detect_init(Detect_State *state, const Detect_Params *params);
+
+/*!
+ *  @brief  Distance in inches for an echo duration in microseconds
+ *
+ *  Sound covers an inch in about 74 us and the echo goes there and back.
+ */
+static inline uint16_t Detect_distance(uint16_t duration)
+{
+    return (duration / 74 / 2);
+}
+
+/*!
+ *  @brief  Take one ping's distance
+ */
+extern Detect_Result Detect_sample(Detect_State *state, uint16_t distance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DETECT_H */
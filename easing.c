@@ -0,0 +1,91 @@
+/*
+ *  ======== easing.c ========
+ *  Flash tables for the curves in easing.h.
+ *
+ *  Every entry is a floating point constant expression, so the compiler
+ *  evaluates the curves and only the rounded integers end up in the image.
+ *  cos() is not allowed in a constant expression, so it is replaced by a
+ *  Taylor series on a quarter wave, which is good to about 3e-7 - well below
+ *  one count at the largest Easing_VALUE_BITS.
+ */
+
+#include <stdint.h>
+
+#include "easing.h"
+
+#if Easing_TABLE_BITS < 4 || Easing_TABLE_BITS > 8
+#error "Easing_TABLE_BITS must be between 4 and 8"
+#endif
+
+#if Easing_VALUE_BITS < 8 || Easing_VALUE_BITS > 15
+#error "Easing_VALUE_BITS must be between 8 and 15"
+#endif
+
+/* Place into subsections to allow the TI linker to remove items properly */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_SECTION(Easing_tables, ".const:Easing_tables")
+#endif
+
+#define EASING_TWO_PI   6.283185307179586
+
+/* cos(x) for 0 <= x <= pi/2, Horner form in x*x */
+#define EASING_COSQ_Y(y) \
+    (1.0 + (y) * (-1.0/2 + (y) * (1.0/24 + (y) * (-1.0/720 + \
+     (y) * (1.0/40320 + (y) * (-1.0/3628800))))))
+#define EASING_COSQ(x)  EASING_COSQ_Y((x) * (x))
+
+/* cos(2 * pi * t) for 0 <= t <= 1, folded onto the first quarter wave */
+#define EASING_COS01(t)                                                  \
+    ((t) <= 0.25 ?  EASING_COSQ(EASING_TWO_PI * (t)) :                   \
+     (t) <= 0.50 ? -EASING_COSQ(EASING_TWO_PI * (0.5 - (t))) :           \
+     (t) <= 0.75 ? -EASING_COSQ(EASING_TWO_PI * ((t) - 0.5)) :           \
+                    EASING_COSQ(EASING_TWO_PI * (1.0 - (t))))
+
+/* The curves, 0.0 .. 1.0 over 0 <= t <= 1 */
+#define EASING_SINE(t)      (0.5 - 0.5 * EASING_COS01(t))
+#define EASING_EASEINOUT(t) (0.5 - 0.5 * EASING_COS01((t) * 0.5))
+#define EASING_SNIFF(t)                                                  \
+    ((t) < 0.25 ? 0.5 - 0.5 * EASING_COS01((t) * 2.0)                    \
+                : 0.5 + 0.5 * EASING_COS01(((t) - 0.25) * (2.0 / 3)))
+
+#define EASING_VALUE(f)     ((Easing_Value)((f) * Easing_ONE + 0.5))
+
+/*
+ * Periodic curves sample [0, 1) so the wrap from the last entry back to the
+ * first is one step; the one-shot ease ends exactly on 1.0.
+ */
+#define EASING_SINE_AT(i)       EASING_VALUE(EASING_SINE((double)(i) / Easing_TABLE_SIZE))
+#define EASING_EASEINOUT_AT(i)  EASING_VALUE(EASING_EASEINOUT((double)(i) / (Easing_TABLE_SIZE - 1)))
+#define EASING_SNIFF_AT(i)      EASING_VALUE(EASING_SNIFF((double)(i) / Easing_TABLE_SIZE))
+
+/* Expand f(0), f(1) ... f(n - 1) */
+#define EASING_R1(f, i)     f(i),
+#define EASING_R2(f, i)     EASING_R1(f, i)  EASING_R1(f, (i) + 1)
+#define EASING_R4(f, i)     EASING_R2(f, i)  EASING_R2(f, (i) + 2)
+#define EASING_R8(f, i)     EASING_R4(f, i)  EASING_R4(f, (i) + 4)
+#define EASING_R16(f, i)    EASING_R8(f, i)  EASING_R8(f, (i) + 8)
+#define EASING_R32(f, i)    EASING_R16(f, i) EASING_R16(f, (i) + 16)
+#define EASING_R64(f, i)    EASING_R32(f, i) EASING_R32(f, (i) + 32)
+#define EASING_R128(f, i)   EASING_R64(f, i) EASING_R64(f, (i) + 64)
+#define EASING_R256(f, i)   EASING_R128(f, i) EASING_R128(f, (i) + 128)
+
+#if Easing_TABLE_BITS == 4
+#define EASING_TABLE(f)     { EASING_R16(f, 0) }
+#elif Easing_TABLE_BITS == 5
+#define EASING_TABLE(f)     { EASING_R32(f, 0) }
+#elif Easing_TABLE_BITS == 6
+#define EASING_TABLE(f)     { EASING_R64(f, 0) }
+#elif Easing_TABLE_BITS == 7
+#define EASING_TABLE(f)     { EASING_R128(f, 0) }
+#else
+#define EASING_TABLE(f)     { EASING_R256(f, 0) }
+#endif
+
+/*
+ * NOTE: The order of the tables must coincide with Easing_Curve.
+ */
+const Easing_Value Easing_tables[Easing_COUNT][Easing_TABLE_SIZE] = {
+    EASING_TABLE(EASING_SINE_AT),
+    EASING_TABLE(EASING_EASEINOUT_AT),
+    EASING_TABLE(EASING_SNIFF_AT),
+};
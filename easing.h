@@ -0,0 +1,114 @@
+/*
+ *  ======== easing.h ========
+ *  Motion-shape lookup tables for the head servos.
+ *
+ *  The tables live in flash and are filled in by the compiler (see easing.c),
+ *  so a motion task turns a phase into a position with two table reads, a
+ *  linear interpolation between them and no trig at run time. Without the
+ *  interpolation a 64-entry table would move a 5 s pan in 8 degree steps.
+ *
+ *  A phase is a 16-bit fraction of a move: 0 is the start and the counter
+ *  wraps at 65536, so periodic curves can just keep adding to it.
+ */
+
+#ifndef __EASING_H
+#define __EASING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Build-time size and resolution. Override on the compiler command line,
+ * e.g. --define=Easing_TABLE_BITS=8 for smoother but larger tables.
+ * Easing_TABLE_BITS may be 4..8 (16..256 entries per curve).
+ * Easing_VALUE_BITS may be 8..15.
+ */
+#ifndef Easing_TABLE_BITS
+#define Easing_TABLE_BITS   6
+#endif
+
+#ifndef Easing_VALUE_BITS
+#define Easing_VALUE_BITS   12
+#endif
+
+#define Easing_TABLE_SIZE   (1 << Easing_TABLE_BITS)
+#define Easing_ONE          ((1 << Easing_VALUE_BITS) - 1)
+
+#if Easing_VALUE_BITS <= 8
+typedef uint8_t  Easing_Value;
+#else
+typedef uint16_t Easing_Value;
+#endif
+
+typedef uint16_t Easing_Phase;
+
+/*!
+ *  @def    Easing_Curve
+ *  @brief  Available motion shapes
+ *
+ *  Easing_Sine       one full cycle 0 -> 1 -> 0, smooth at both ends (panning)
+ *  Easing_EaseInOut  0 -> 1, slow start and slow stop (point-to-point moves)
+ *  Easing_Sniff      one full cycle 0 -> 1 -> 0 with a quick rise and a
+ *                    slow fall, like a dog lifting its nose to sniff
+ */
+typedef enum Easing_Curve {
+    Easing_Sine = 0,
+    Easing_EaseInOut,
+    Easing_Sniff,
+
+    Easing_COUNT
+} Easing_Curve;
+
+extern const Easing_Value Easing_tables[Easing_COUNT][Easing_TABLE_SIZE];
+
+/*
+ *  ======== Easing_sample ========
+ *  Curve value at a phase, 0..Easing_ONE, interpolated between the two
+ *  nearest entries. Periodic curves wrap from the last entry to the first;
+ *  the one-shot ease spreads its entries over the whole move, ending on 1.
+ */
+static inline Easing_Value Easing_sample(Easing_Curve curve, Easing_Phase phase)
+{
+    const Easing_Value *table = Easing_tables[curve];
+    uint32_t            index;
+    uint32_t            next;
+    uint32_t            fraction;
+
+    if (curve == Easing_EaseInOut) {
+        index = ((uint32_t)phase * (Easing_TABLE_SIZE - 1)) >> 16;
+        fraction = ((uint32_t)phase * (Easing_TABLE_SIZE - 1)) & 0xffff;
+        next = index + 1;
+    }
+    else {
+        index = phase >> (16 - Easing_TABLE_BITS);
+        fraction = ((uint32_t)phase << Easing_TABLE_BITS) & 0xffff;
+        next = (index + 1) & (Easing_TABLE_SIZE - 1);
+    }
+
+    return ((Easing_Value)((table[index] * (0x10000 - fraction) + table[next] * fraction) >> 16));
+}
+
+/*
+ *  ======== Easing_lerp ========
+ *  Position between from and to at a phase along a curve
+ */
+static inline int Easing_lerp(Easing_Curve curve, Easing_Phase phase, int from, int to)
+{
+    return (from + ((to - from) * (int32_t)Easing_sample(curve, phase)) / Easing_ONE);
+}
+
+/*
+ *  ======== Easing_phaseStep ========
+ *  Phase increment per tick for a move lasting millis, sampled every tickMillis
+ */
+#define Easing_phaseStep(millis, tickMillis) \
+    ((Easing_Phase)((65536UL * (uint32_t)(tickMillis)) / (uint32_t)(millis)))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EASING_H */
@@ -0,0 +1,298 @@
+/*
+ *  ======== flashLog.c ========
+ *  Append-only flash event log - see flashLog.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "flashLog.h"
+
+#define FLASHLOG_PAGE_WORDS     (FlashLog_PAGE_SIZE / sizeof(uint32_t))
+#define FLASHLOG_HEADER_WORDS   (sizeof(FlashLog_PageHeader) / sizeof(uint32_t))
+#define FLASHLOG_RECORD_MAX     11      /* event + two 5-byte varints */
+
+/*
+ * One page image in RAM and how far it has got into flash. Words below
+ * committed are final - FlashLog_flush padded the last of them with
+ * FlashLog_COMMIT - so the Idle loop can program them while tasks append
+ * after them.
+ */
+typedef struct FlashLog_Image {
+    uint32_t words[FLASHLOG_PAGE_WORDS];
+    uint32_t page;                  /* where it goes */
+    uint32_t fill;                  /* bytes used */
+    uint32_t records;               /* appended since the header */
+    volatile uint32_t committed;    /* words handed to the Idle loop */
+    uint32_t written;               /* words programmed */
+    bool     erased;
+    bool     headed;                /* header programmed - the page is in the log */
+    bool     failed;
+} FlashLog_Image;
+
+/* two page images: one filling, one the Idle loop may still be writing */
+static FlashLog_Image flashLogImages[2];
+
+static bool           flashLogOpen = false;
+static uint32_t       flashLogActive;       /* image being filled */
+static uint32_t       flashLogPrevTick;
+static uint32_t       flashLogPrevValue;
+static uint32_t       flashLogSequence;     /* for the next page */
+
+static FlashLog_Stats flashLogStats;
+
+/*
+ *  ======== flashLogHeader ========
+ */
+static inline FlashLog_PageHeader *flashLogHeader(FlashLog_Image *image)
+{
+    return ((FlashLog_PageHeader *)image->words);
+}
+
+/*
+ *  ======== flashLogBusy ========
+ *  The Idle loop still has work on the image
+ */
+static inline bool flashLogBusy(const FlashLog_Image *image)
+{
+    return (image->committed != 0 && (image->written < image->committed || !image->headed));
+}
+
+/*
+ *  ======== flashLogVarint ========
+ */
+static uint32_t flashLogVarint(uint8_t *out, uint32_t value)
+{
+    uint32_t len = 0;
+
+    while (value >= 0x80) {
+        out[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+
+    return (len);
+}
+
+/*
+ *  ======== flashLogStartPage ========
+ */
+static void flashLogStartPage(FlashLog_Image *image, uint32_t page)
+{
+    FlashLog_PageHeader *header = flashLogHeader(image);
+
+    memset(image->words, 0xFF, FlashLog_PAGE_SIZE);
+    header->magic = FlashLog_MAGIC;
+    header->sequence = flashLogSequence++;
+    header->boot = flashLogStats.boot;
+
+    image->page = page;
+    image->fill = sizeof(FlashLog_PageHeader);
+    image->records = 0;
+    image->committed = 0;
+    image->written = 0;
+    image->erased = false;
+    image->headed = false;
+    image->failed = false;
+}
+
+/*
+ *  ======== flashLogCommit ========
+ *  Close the records so far with FlashLog_COMMIT up to a word boundary and
+ *  hand them to the Idle loop; scheduler locked
+ */
+static void flashLogCommit(FlashLog_Image *image)
+{
+    uint8_t *bytes = (uint8_t *)image->words;
+
+    if (image->fill == image->committed * sizeof(uint32_t) ||
+        image->fill == sizeof(FlashLog_PageHeader)) {
+        return;
+    }
+
+    do {
+        bytes[image->fill++] = FlashLog_COMMIT;
+    } while (image->fill % sizeof(uint32_t) != 0);
+    image->committed = image->fill / sizeof(uint32_t);
+}
+
+/*
+ *  ======== FlashLog_init ========
+ */
+bool FlashLog_init(void)
+{
+    const FlashLog_PageHeader *newest = NULL;
+    uint32_t                   newestPage = 0;
+    uint32_t                   page;
+
+    for (page = 0; page < FlashLog_PAGES; page++) {
+        const FlashLog_PageHeader *header =
+            (const FlashLog_PageHeader *)FlashLog_portPage(page);
+
+        if (header == NULL) {
+            return (false);
+        }
+        if (header->magic == FlashLog_MAGIC &&
+            (newest == NULL || (int32_t)(header->sequence - newest->sequence) > 0)) {
+            newest = header;
+            newestPage = page;
+        }
+    }
+
+    /* a new page each boot - its ticks and the last boot's do not chain */
+    page = 0;
+    if (newest != NULL) {
+        page = (newestPage + 1) % FlashLog_PAGES;
+        flashLogSequence = newest->sequence + 1;
+        flashLogStats.boot = newest->boot + 1;
+    }
+
+    flashLogActive = 0;
+    flashLogStartPage(&flashLogImages[flashLogActive], page);
+    flashLogOpen = true;
+
+    return (true);
+}
+
+/*
+ *  ======== FlashLog_append ========
+ */
+void FlashLog_append(FlashLog_Event event, uint32_t value)
+{
+    FlashLog_Image *image;
+    FlashLog_Image *next;
+    uint8_t         record[FLASHLOG_RECORD_MAX];
+    uint32_t        len;
+    int32_t         change;
+    uint32_t        now;
+    UInt            key;
+
+    key = Task_disable();
+
+    if (!flashLogOpen) {
+        Task_restore(key);
+        return;
+    }
+
+    now = Clock_getTicks();
+    image = &flashLogImages[flashLogActive];
+
+    /* room for the record and the commit mark after it */
+    if (image->fill + FLASHLOG_RECORD_MAX + sizeof(uint32_t) > FlashLog_PAGE_SIZE) {
+        next = &flashLogImages[flashLogActive ^ 1];
+        if (flashLogBusy(next)) {
+            flashLogStats.dropped++;
+            Task_restore(key);
+            return;
+        }
+        flashLogCommit(image);
+        flashLogActive ^= 1;
+        flashLogStartPage(next, (image->page + 1) % FlashLog_PAGES);
+        image = next;
+    }
+    if (image->records == 0) {
+        flashLogHeader(image)->firstTick = now;
+        flashLogPrevTick = now;
+        flashLogPrevValue = 0;
+    }
+
+    /* zigzag keeps small decreases small */
+    change = (int32_t)(value - flashLogPrevValue);
+    record[0] = (uint8_t)event;
+    len = 1;
+    len += flashLogVarint(&record[len], now - flashLogPrevTick);
+    len += flashLogVarint(&record[len], ((uint32_t)change << 1) ^ (uint32_t)(change >> 31));
+
+    memcpy((uint8_t *)image->words + image->fill, record, len);
+    image->fill += len;
+    image->records++;
+    flashLogPrevTick = now;
+    flashLogPrevValue = value;
+    flashLogStats.appended++;
+
+    Task_restore(key);
+}
+
+/*
+ *  ======== FlashLog_flush ========
+ */
+void FlashLog_flush(void)
+{
+    UInt key = Task_disable();
+
+    if (flashLogOpen) {
+        flashLogCommit(&flashLogImages[flashLogActive]);
+    }
+
+    Task_restore(key);
+}
+
+/*
+ *  ======== FlashLog_getStats ========
+ */
+void FlashLog_getStats(FlashLog_Stats *stats)
+{
+    UInt key = Task_disable();
+
+    *stats = flashLogStats;
+
+    Task_restore(key);
+}
+
+/*
+ *  ======== FlashLog_idle ========
+ *  One slice of work per pass, older image first: the erase, a few
+ *  committed words, or the header. The header goes in after the page's
+ *  first words, magic last, so FlashLog_init only finds pages that hold
+ *  records; later commits program more words under it in place.
+ */
+Void FlashLog_idle(void)
+{
+    FlashLog_Image *image = &flashLogImages[flashLogActive ^ 1];
+    uint32_t        count;
+    UInt            key;
+
+    if (!flashLogBusy(image)) {
+        image = &flashLogImages[flashLogActive];
+        if (!flashLogBusy(image)) {
+            return;
+        }
+    }
+
+    if (!image->erased) {
+        image->failed = !FlashLog_portErase(image->page);
+        image->erased = true;
+        image->written = FLASHLOG_HEADER_WORDS;
+        return;
+    }
+
+    if (image->written < image->committed) {
+        count = image->committed - image->written;
+        if (count > FlashLog_PROGRAM_WORDS) {
+            count = FlashLog_PROGRAM_WORDS;
+        }
+        if (!image->failed &&
+            !FlashLog_portProgram(image->page, image->written * sizeof(uint32_t),
+                                  &image->words[image->written], count)) {
+            image->failed = true;
+        }
+        image->written += count;
+        return;
+    }
+
+    if (!image->failed) {
+        FlashLog_portProgram(image->page, sizeof(uint32_t), &image->words[1],
+                             FLASHLOG_HEADER_WORDS - 1);
+        FlashLog_portProgram(image->page, 0, &image->words[0], 1);
+    }
+
+    key = Task_disable();
+    image->headed = true;
+    flashLogStats.pagesWritten++;
+    Task_restore(key);
+}
@@ -0,0 +1,147 @@
+/*
+ *  ======== flashLog.h ========
+ *  Append-only event log in spare internal flash, for weeks of trigger and
+ *  sensor history per prop.
+ *
+ *  The log region (FLASHLOG in EK_TM4C123GXL.cmd) is a ring of 1 KB erase
+ *  pages. Records are appended to an image of the open page in RAM. Each
+ *  FlashLog_flush() closes the records so far with a commit mark and hands
+ *  the new words to the Idle loop, which programs them into the open page
+ *  in place - erased flash reads 0xFF, so words can be programmed one
+ *  batch at a time. A page is erased once, when it is opened, and the next
+ *  page is opened when this one is full; going round the ring erases every
+ *  page once per lap, which is the wear levelling. Flash is only touched
+ *  when every task is blocked, so no task waits on it, but interrupts do:
+ *  the code runs from the same flash, so while a page erases (FlashErase,
+ *  several ms) or a word programs every fetch stalls, ISRs and the Clock
+ *  tick included. That is one erase per full page and a few words per
+ *  flush, not a steady cost. If the Idle loop falls a whole page behind,
+ *  new records are dropped and counted.
+ *
+ *  Page layout:
+ *      FlashLog_PageHeader, then records and commit marks until the first
+ *      0xFF byte. The header is programmed after the page's first records,
+ *      so a page with the magic always holds some.
+ *  Record:
+ *      event (1 byte), ticks since the previous record (varint),
+ *      value change since the previous record (zigzag varint)
+ *  Commit mark:
+ *      FlashLog_COMMIT bytes up to the next word boundary, in place of an
+ *      event byte
+ *  Each page starts from its header's tick and a value of 0, so any page
+ *  decodes on its own (tools/flashlog2csv.py); records after the last
+ *  commit mark were cut short by a reset and are skipped. Records still in
+ *  RAM are lost on reset unless FlashLog_flush() was called.
+ */
+
+#ifndef __FLASHLOG_H
+#define __FLASHLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <xdc/std.h>
+
+/* "WWF2" - pages are programmed in place, with commit marks */
+#define FlashLog_MAGIC          0x32465757
+
+/* commit mark byte - not a FlashLog_Event */
+#define FlashLog_COMMIT         0xFE
+
+/* must match FLASHLOG in EK_TM4C123GXL.cmd */
+#define FlashLog_BASE           0x00020000
+#define FlashLog_PAGE_SIZE      1024
+#define FlashLog_PAGES          128
+
+/* words programmed per Idle pass */
+#ifndef FlashLog_PROGRAM_WORDS
+#define FlashLog_PROGRAM_WORDS  16
+#endif
+
+/*!
+ *  @def    FlashLog_Event
+ *
+ *  NOTE: IDs are stored in flash - append new events at the end.
+ */
+typedef enum FlashLog_Event {
+    FlashLog_Boot = 0,      /* value: CrashLog_Reason of the previous boot */
+    FlashLog_Trigger,       /* value: distance (inches) */
+    FlashLog_Closest,       /* value: closest distance since the last summary */
+    FlashLog_EchoTimeouts,  /* value: echo timeouts since the last summary */
+    FlashLog_ShowDone,      /* value: show length (ms) */
+    FlashLog_Range,         /* value: echo duration (us) of one ping - recordRanges in werewolf.c */
+    FlashLog_RangeRepeat,   /* value: pings since the last Range at its distance, before the next Range */
+
+    FlashLog_EVENTCOUNT
+} FlashLog_Event;
+
+/*!
+ *  @def    FlashLog_PageHeader
+ */
+typedef struct FlashLog_PageHeader {
+    uint32_t magic;         /* FlashLog_MAGIC once the page holds records */
+    uint32_t sequence;      /* pages ever written - the newest page has the highest */
+    uint16_t boot;          /* boots since the log was first used */
+    uint16_t reserved;      /* 0xFFFF */
+    uint32_t firstTick;     /* Clock ticks of the first record */
+} FlashLog_PageHeader;
+
+/*!
+ *  @def    FlashLog_Stats
+ */
+typedef struct FlashLog_Stats {
+    uint32_t appended;
+    uint32_t dropped;       /* the Idle loop was still writing the previous page */
+    uint32_t pagesWritten;  /* pages opened in flash */
+    uint16_t boot;
+} FlashLog_Stats;
+
+/*!
+ *  @brief  Find the newest page and continue after it
+ *
+ *  @return false if the flash could not be used
+ */
+extern bool FlashLog_init(void);
+
+/*!
+ *  @brief  Queue a record; Task context
+ */
+extern void FlashLog_append(FlashLog_Event event, uint32_t value);
+
+/*!
+ *  @brief  Commit the records so far; the Idle loop programs them soon
+ */
+extern void FlashLog_flush(void);
+
+/*!
+ *  @brief  Copy the counters
+ */
+extern void FlashLog_getStats(FlashLog_Stats *stats);
+
+/*!
+ *  @brief  Idle function - referenced from pwmled.cfg
+ */
+extern Void FlashLog_idle(void);
+
+/*
+ * Port - implemented once per platform (flashLogTiva.c on the board)
+ */
+
+/*!
+ *  @brief  Read-only view of a log page
+ */
+extern const uint8_t *FlashLog_portPage(uint32_t page);
+
+extern bool FlashLog_portErase(uint32_t page);
+extern bool FlashLog_portProgram(uint32_t page, uint32_t offset,
+                                 const uint32_t *words, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLASHLOG_H */
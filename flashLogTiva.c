@@ -0,0 +1,54 @@
+/*
+ *  ======== flashLogTiva.c ========
+ *  FlashLog port for the EK_TM4C123GXL: the log pages are the TM4C123's
+ *  1 KB flash erase blocks from FlashLog_BASE up, read in place and
+ *  written with driverlib.
+ *
+ *  The flash cannot be read while it is being erased or programmed, so
+ *  the CPU stalls for the length of each call; FlashLog_idle keeps the
+ *  calls small and only makes them when every task is blocked.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <driverlib/flash.h>
+
+#include "flashLog.h"
+
+#if (FlashLog_BASE % FlashLog_PAGE_SIZE) != 0
+#error "FlashLog_BASE must be on an erase block boundary"
+#endif
+
+/*
+ *  ======== flashLogTivaAddress ========
+ */
+static inline uint32_t flashLogTivaAddress(uint32_t page)
+{
+    return (FlashLog_BASE + page * FlashLog_PAGE_SIZE);
+}
+
+/*
+ *  ======== FlashLog_portPage ========
+ */
+const uint8_t *FlashLog_portPage(uint32_t page)
+{
+    return ((const uint8_t *)flashLogTivaAddress(page));
+}
+
+/*
+ *  ======== FlashLog_portErase ========
+ */
+bool FlashLog_portErase(uint32_t page)
+{
+    return (FlashErase(flashLogTivaAddress(page)) == 0);
+}
+
+/*
+ *  ======== FlashLog_portProgram ========
+ */
+bool FlashLog_portProgram(uint32_t page, uint32_t offset, const uint32_t *words, uint32_t count)
+{
+    return (FlashProgram((uint32_t *)words, flashLogTivaAddress(page) + offset,
+                         count * sizeof(uint32_t)) == 0);
+}
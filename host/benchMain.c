@@ -0,0 +1,133 @@
+/*
+ *  ======== benchMain.c ========
+ *  Host runner for the kernel microbenchmarks (bench.h): times each kernel
+ *  with CLOCK_MONOTONIC and checks it against its host budget.
+ *
+ *      werewolf_bench [--scale F] [--repeat N] [KERNEL]...
+ *
+ *  Each sample is a batch of at least 200 us. --repeat runs the whole
+ *  measurement N times and keeps each kernel's best median, which rides
+ *  out a busy machine. --scale multiplies every budget, for hosts much
+ *  slower than the one the budgets were set on. Any kernel over budget
+ *  is reported and the run fails.
+ *
+ *  The kernels run on the simulated board (sim.h) so the servo and trace
+ *  paths have their drivers, but no virtual time passes.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench.h"
+#include "sim.h"
+
+#define BENCHMAIN_MIN_BATCH_NS  200000
+
+/*
+ *  ======== benchMainClock ========
+ */
+static uint32_t benchMainClock(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec));
+}
+
+/*
+ *  ======== benchMainSelected ========
+ */
+static bool benchMainSelected(const char *name, int argc, char *argv[], int first)
+{
+    int arg;
+
+    if (first >= argc) {
+        return (true);
+    }
+    for (arg = first; arg < argc; arg++) {
+        if (strcmp(argv[arg], name) == 0) {
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(int argc, char *argv[])
+{
+    Sim_Options  options;
+    Bench_Result result;
+    Bench_Result best = { 0 };
+    double       scale = 1.0;
+    unsigned     repeat = 1;
+    unsigned     pass;
+    uint32_t     kernel;
+    uint32_t     measured = 0;
+    uint32_t     over = 0;
+    float        budget;
+    int          first = 1;
+
+    while (first < argc && argv[first][0] == '-') {
+        if (strcmp(argv[first], "--scale") == 0 && first + 1 < argc) {
+            scale = strtod(argv[first + 1], NULL);
+            first += 2;
+        }
+        else if (strcmp(argv[first], "--repeat") == 0 && first + 1 < argc) {
+            repeat = (unsigned)strtoul(argv[first + 1], NULL, 0);
+            first += 2;
+        }
+        else {
+            fprintf(stderr, "usage: werewolf_bench [--scale F] [--repeat N] [KERNEL]...\n");
+            return (EXIT_FAILURE);
+        }
+    }
+
+    Sim_Options_init(&options);
+    options.record = false;
+    Sim_init(&options);
+
+    printf("%-14s %10s %10s %10s %10s %10s  %s\n",
+           "kernel", "ns/call", "min", "p90", "max", "budget", "calls/sample");
+    for (kernel = 0; kernel < Bench_kernelCount; kernel++) {
+        if (!benchMainSelected(Bench_kernels[kernel].name, argc, argv, first)) {
+            continue;
+        }
+
+        for (pass = 0; pass < repeat || pass == 0; pass++) {
+            Bench_measure(&Bench_kernels[kernel], benchMainClock, BENCHMAIN_MIN_BATCH_NS, &result);
+            if (pass == 0 || result.median < best.median) {
+                best = result;
+            }
+        }
+        measured++;
+
+        budget = (float)(Bench_kernels[kernel].budgetNs * scale);
+        printf("%-14s %10.2f %10.2f %10.2f %10.2f %10.2f  %u%s\n", Bench_kernels[kernel].name,
+               best.median, best.min, best.p90, best.max, budget, best.calls,
+               (best.median > budget) ? "  OVER BUDGET" : "");
+        if (best.median > budget) {
+            over++;
+        }
+    }
+
+    if (measured == 0) {
+        fprintf(stderr, "bench: no kernel by that name\n");
+        return (EXIT_FAILURE);
+    }
+    if (over != 0) {
+        fprintf(stderr, "bench: %u of %u kernels OVER BUDGET - make them faster, or raise "
+                        "the budget in bench.c with the reason\n", over, measured);
+        return (EXIT_FAILURE);
+    }
+    printf("bench: %u kernels within budget\n", measured);
+
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,77 @@
+/*
+ *  ======== crashLogFile.c ========
+ *  CrashLog port for a Linux host: the "EEPROM" is a file named by
+ *  Sim_Options.eepromPath, so a crash in one run is reported by the next,
+ *  or a static buffer when no file is given. There is no exception hook -
+ *  a host fault kills the process, and only System_abort is captured.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "crashLog.h"
+#include "sim.h"
+
+static CrashLog_Snapshot crashLogFileEeprom;
+
+/*
+ *  ======== crashLogFileSync ========
+ */
+static void crashLogFileSync(void)
+{
+    const char *path = Sim_options()->eepromPath;
+    FILE       *file;
+
+    if (path != NULL && (file = fopen(path, "wb")) != NULL) {
+        fwrite(&crashLogFileEeprom, sizeof(crashLogFileEeprom), 1, file);
+        fclose(file);
+    }
+}
+
+/*
+ *  ======== CrashLog_portOpen ========
+ *  A missing or short file reads as blank
+ */
+bool CrashLog_portOpen(void)
+{
+    const char *path = Sim_options()->eepromPath;
+    FILE       *file;
+
+    memset(&crashLogFileEeprom, 0xFF, sizeof(crashLogFileEeprom));
+    if (path != NULL && (file = fopen(path, "rb")) != NULL) {
+        if (fread(&crashLogFileEeprom, sizeof(crashLogFileEeprom), 1, file) != 1) {
+            memset(&crashLogFileEeprom, 0xFF, sizeof(crashLogFileEeprom));
+        }
+        fclose(file);
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== CrashLog_portRead ========
+ */
+void CrashLog_portRead(CrashLog_Snapshot *snapshot)
+{
+    *snapshot = crashLogFileEeprom;
+}
+
+/*
+ *  ======== CrashLog_portWrite ========
+ */
+void CrashLog_portWrite(const CrashLog_Snapshot *snapshot)
+{
+    crashLogFileEeprom = *snapshot;
+    crashLogFileSync();
+}
+
+/*
+ *  ======== CrashLog_portClear ========
+ */
+void CrashLog_portClear(void)
+{
+    crashLogFileEeprom.magic = 0;
+    crashLogFileSync();
+}
@@ -0,0 +1,441 @@
+/*
+ *  ======== crowd.c ========
+ *  Visitors walking the walkway - see crowd.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "crowd.h"
+#include "sim.h"
+
+/*
+ *  ======== Crowd_Params_init ========
+ */
+void Crowd_Params_init(Crowd_Params *params)
+{
+    static const double sizes[Crowd_GROUP_MAX] = { 25, 35, 18, 12, 6, 3, 1, 0 };
+
+    params->groupsPerHour = 30.0;
+    memcpy(params->groupSizes, sizes, sizeof(sizes));
+    params->minSpeed = 20.0;
+    params->maxSpeed = 50.0;
+    params->spacingMillis = 1500.0;
+    params->spread = 18.0;
+    params->pauseChance = 0.4;
+    params->minPauseMillis = 2000.0;
+    params->maxPauseMillis = 10000.0;
+    params->radius = 9.0;
+    params->seed = 1;
+}
+
+/*
+ *  ======== crowdUniform ========
+ */
+static double crowdUniform(uint64_t *state, double low, double high)
+{
+    return (low + (high - low) * Sim_randomFrom(state));
+}
+
+/*
+ *  ======== crowdGroupSize ========
+ */
+static uint32_t crowdGroupSize(const Crowd_Params *params, uint64_t *state)
+{
+    double   total = 0.0;
+    double   pick;
+    uint32_t size;
+
+    for (size = 0; size < Crowd_GROUP_MAX; size++) {
+        total += params->groupSizes[size];
+    }
+    pick = Sim_randomFrom(state) * total;
+    for (size = 0; size < Crowd_GROUP_MAX - 1; size++) {
+        if (pick < params->groupSizes[size]) {
+            break;
+        }
+        pick -= params->groupSizes[size];
+    }
+
+    return (size + 1);
+}
+
+/*
+ *  ======== crowdCompare ========
+ */
+static int crowdCompare(const void *a, const void *b)
+{
+    const Crowd_Visitor *va = a;
+    const Crowd_Visitor *vb = b;
+
+    if (va->arriveNs != vb->arriveNs) {
+        return ((va->arriveNs < vb->arriveNs) ? -1 : 1);
+    }
+
+    return ((va->group < vb->group) ? -1 : (va->group > vb->group));
+}
+
+/*
+ *  ======== Crowd_generate ========
+ */
+bool Crowd_generate(Crowd *crowd, const Crowd_Path *path, const Crowd_Params *params,
+                    uint64_t runNs)
+{
+    uint64_t       state = (params->seed + 1) * 0x9E3779B97F4A7C15ull;
+    uint64_t       groupNs;
+    uint64_t       memberNs;
+    uint64_t       stayNs;
+    size_t         capacity = 0;
+    size_t         point;
+    Crowd_Visitor *visitor;
+    Crowd_Visitor  group;
+    uint32_t       size;
+    uint32_t       member;
+    uint32_t       pause;
+    double         walkway;
+    double         swapAt;
+    uint64_t       swapNs;
+
+    memset(crowd, 0, sizeof(*crowd));
+    if (path->count < 2 || path->count > Crowd_PATH_POINTS || params->groupsPerHour <= 0.0) {
+        return (false);
+    }
+    crowd->path = *path;
+    crowd->params = *params;
+    for (point = 1; point < path->count; point++) {
+        crowd->length[point] = crowd->length[point - 1] +
+                               hypot(path->x[point] - path->x[point - 1], path->y[point] - path->y[point - 1]);
+    }
+    walkway = crowd->length[path->count - 1];
+
+    for (groupNs = 0;;) {
+        groupNs += (uint64_t)(-3600.0e9 / params->groupsPerHour * log(1.0 - Sim_randomFrom(&state)));
+        if (groupNs >= runNs) {
+            break;
+        }
+
+        memset(&group, 0, sizeof(group));
+        group.group = crowd->groups++;
+        group.speed = crowdUniform(&state, params->minSpeed, params->maxSpeed);
+        stayNs = (uint64_t)(walkway / group.speed * 1e9);
+        for (pause = 0; pause < Crowd_PAUSES; pause++) {
+            group.pauseAt[pause] = crowdUniform(&state, 0.0, walkway);
+            if (Sim_randomFrom(&state) < params->pauseChance) {
+                group.pauseNs[pause] = (uint64_t)(crowdUniform(&state, params->minPauseMillis,
+                                                               params->maxPauseMillis) * 1e6);
+                stayNs += group.pauseNs[pause];
+            }
+        }
+        if (group.pauseAt[0] > group.pauseAt[1]) {
+            swapAt = group.pauseAt[0];
+            group.pauseAt[0] = group.pauseAt[1];
+            group.pauseAt[1] = swapAt;
+            swapNs = group.pauseNs[0];
+            group.pauseNs[0] = group.pauseNs[1];
+            group.pauseNs[1] = swapNs;
+        }
+
+        size = crowdGroupSize(params, &state);
+        memberNs = groupNs;
+        for (member = 0; member < size; member++) {
+            if (crowd->count == capacity) {
+                capacity = (capacity != 0) ? capacity * 2 : 256;
+                visitor = realloc(crowd->visitors, capacity * sizeof(Crowd_Visitor));
+                if (visitor == NULL) {
+                    Crowd_free(crowd);
+                    return (false);
+                }
+                crowd->visitors = visitor;
+            }
+            if (member != 0) {
+                memberNs += (uint64_t)(crowdUniform(&state, 300.0, params->spacingMillis) * 1e6);
+            }
+
+            visitor = &crowd->visitors[crowd->count++];
+            *visitor = group;
+            visitor->arriveNs = memberNs;
+            visitor->leaveNs = memberNs + stayNs;
+            visitor->offset = crowdUniform(&state, -params->spread, params->spread);
+            if (stayNs > crowd->longestNs) {
+                crowd->longestNs = stayNs;
+            }
+        }
+    }
+
+    /* the last of one group can come in after the first of the next */
+    qsort(crowd->visitors, crowd->count, sizeof(Crowd_Visitor), crowdCompare);
+
+    return (true);
+}
+
+/*
+ *  ======== Crowd_free ========
+ */
+void Crowd_free(Crowd *crowd)
+{
+    free(crowd->visitors);
+    crowd->visitors = NULL;
+    crowd->count = 0;
+}
+
+/*
+ *  ======== Crowd_present ========
+ */
+size_t Crowd_present(const Crowd *crowd, uint64_t ns, size_t *first)
+{
+    uint64_t earliest = (ns > crowd->longestNs) ? ns - crowd->longestNs : 0;
+    size_t   low = 0;
+    size_t   high = crowd->count;
+    size_t   mid;
+
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (crowd->visitors[mid].arriveNs < earliest) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    *first = low;
+
+    high = crowd->count;
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (crowd->visitors[mid].arriveNs <= ns) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    return (low);
+}
+
+/*
+ *  ======== Crowd_position ========
+ */
+bool Crowd_position(const Crowd *crowd, size_t visitor, uint64_t ns, double *x, double *y)
+{
+    const Crowd_Visitor *v = &crowd->visitors[visitor];
+    const Crowd_Path    *path = &crowd->path;
+    double               seconds;
+    double               paused = 0.0;
+    double               along;
+    double               dx;
+    double               dy;
+    double               segment;
+    size_t               point;
+    uint32_t             pause;
+
+    if (ns < v->arriveNs || ns >= v->leaveNs) {
+        return (false);
+    }
+    seconds = (ns - v->arriveNs) / 1e9;
+
+    along = -1.0;
+    for (pause = 0; pause < Crowd_PAUSES; pause++) {
+        if (v->pauseNs[pause] == 0) {
+            continue;
+        }
+        if (seconds < v->pauseAt[pause] / v->speed + paused) {
+            break;
+        }
+        if (seconds < v->pauseAt[pause] / v->speed + paused + v->pauseNs[pause] / 1e9) {
+            along = v->pauseAt[pause];
+            break;
+        }
+        paused += v->pauseNs[pause] / 1e9;
+    }
+    if (along < 0.0) {
+        along = v->speed * (seconds - paused);
+    }
+
+    point = 1;
+    while (point < path->count - 1 && along > crowd->length[point]) {
+        point++;
+    }
+    dx = path->x[point] - path->x[point - 1];
+    dy = path->y[point] - path->y[point - 1];
+    segment = crowd->length[point] - crowd->length[point - 1];
+    if (segment <= 0.0) {
+        *x = path->x[point];
+        *y = path->y[point];
+        return (true);
+    }
+    dx /= segment;
+    dy /= segment;
+    along -= crowd->length[point - 1];
+
+    /* the offset is to the left of the direction of travel */
+    *x = path->x[point - 1] + dx * along - dy * v->offset;
+    *y = path->y[point - 1] + dy * along + dx * v->offset;
+
+    return (true);
+}
+
+/*
+ *  ======== Crowd_readLayout ========
+ */
+bool Crowd_readLayout(Crowd_Layout *layout, const char *path)
+{
+    FILE              *file;
+    Crowd_LayoutProp  *prop;
+    Crowd_Path        *walkway = &layout->path;
+    char               line[1024];
+    char               name[Crowd_NAME_MAX];
+    char              *hash;
+    char              *word;
+    char              *save;
+    unsigned long long millis;
+    unsigned long long phase;
+    unsigned long long ping;
+    double             x;
+    double             y;
+    double             facing;
+    int                fields;
+    int                number = 0;
+    bool               ok = true;
+
+    memset(layout, 0, sizeof(*layout));
+    layout->groupsPerHour = -1.0;
+    if ((file = fopen(path, "r")) == NULL) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return (false);
+    }
+
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        number++;
+        if ((hash = strchr(line, '#')) != NULL) {
+            *hash = '\0';
+        }
+        if (sscanf(line, " millis %llu", &millis) == 1) {
+            layout->runNs = millis * 1000000ull;
+        }
+        else if ((fields = sscanf(line, " prop %31s %lf %lf %lf %llu %llu",
+                                  name, &x, &y, &facing, &phase, &ping)) >= 4) {
+            if (layout->propCount == Crowd_LAYOUT_PROPS) {
+                fprintf(stderr, "%s:%d: more than %d props\n", path, number, Crowd_LAYOUT_PROPS);
+                ok = false;
+                break;
+            }
+            prop = &layout->props[layout->propCount++];
+            strcpy(prop->name, name);
+            prop->x = x;
+            prop->y = y;
+            prop->facing = facing;
+            prop->phased = (fields >= 5);
+            prop->phaseNs = prop->phased ? phase * 1000000ull : 0;
+            prop->pingMillis = (fields >= 6) ? ping : 0;
+        }
+        else if (strncmp(line + strspn(line, " \t"), "path", 4) == 0) {
+            walkway->count = 0;
+            strtok_r(line, " \t\r\n", &save);
+            while ((word = strtok_r(NULL, " \t\r\n", &save)) != NULL) {
+                if (walkway->count == Crowd_PATH_POINTS ||
+                    sscanf(word, "%lf,%lf", &walkway->x[walkway->count], &walkway->y[walkway->count]) != 2) {
+                    fprintf(stderr, "%s:%d: bad path point %s\n", path, number, word);
+                    ok = false;
+                    break;
+                }
+                walkway->count++;
+            }
+        }
+        else if (sscanf(line, " visitors %lf", &x) == 1) {
+            layout->groupsPerHour = x;
+        }
+        else if (strspn(line, " \t\r\n") != strlen(line)) {
+            fprintf(stderr, "%s:%d: cannot parse\n", path, number);
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    if (ok && (layout->propCount == 0 || walkway->count < 2)) {
+        fprintf(stderr, "%s: a layout needs props and a path of two or more points\n", path);
+        ok = false;
+    }
+
+    return (ok);
+}
+
+/*
+ *  ======== Crowd_findProp ========
+ */
+const Crowd_LayoutProp *Crowd_findProp(const Crowd_Layout *layout, const char *name)
+{
+    size_t p;
+
+    for (p = 0; p < layout->propCount; p++) {
+        if (strcmp(layout->props[p].name, name) == 0) {
+            return (&layout->props[p]);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== Crowd_Sensor_init ========
+ */
+void Crowd_Sensor_init(Crowd_Sensor *sensor, double x, double y, double facing,
+                       double beam, double range)
+{
+    sensor->x = x;
+    sensor->y = y;
+    sensor->dirX = cos(facing * M_PI / 180.0);
+    sensor->dirY = sin(facing * M_PI / 180.0);
+    sensor->cosBeam = cos(beam * M_PI / 180.0);
+    sensor->range = range;
+}
+
+/*
+ *  ======== Crowd_beamDistance ========
+ */
+double Crowd_beamDistance(const Crowd_Sensor *sensor, double x, double y, double radius)
+{
+    double dx = x - sensor->x;
+    double dy = y - sensor->y;
+    double distance = sqrt(dx * dx + dy * dy);
+
+    if (distance - radius > sensor->range) {
+        return (-1.0);
+    }
+    if (distance > radius && dx * sensor->dirX + dy * sensor->dirY < sensor->cosBeam * distance) {
+        return (-1.0);
+    }
+
+    return ((distance > radius) ? distance - radius : 0.0);
+}
+
+/*
+ *  ======== Crowd_nearest ========
+ */
+double Crowd_nearest(const Crowd *crowd, const Crowd_Sensor *sensor, uint64_t ns, size_t *visitor)
+{
+    size_t first;
+    size_t end = Crowd_present(crowd, ns, &first);
+    size_t i;
+    double nearest = -1.0;
+    double distance;
+    double x;
+    double y;
+
+    for (i = first; i < end; i++) {
+        if (Crowd_position(crowd, i, ns, &x, &y) &&
+            (distance = Crowd_beamDistance(sensor, x, y, crowd->params.radius)) >= 0.0 &&
+            (nearest < 0.0 || distance < nearest)) {
+            nearest = distance;
+            if (visitor != NULL) {
+                *visitor = i;
+            }
+        }
+    }
+
+    return (nearest);
+}
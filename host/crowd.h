@@ -0,0 +1,204 @@
+/*
+ *  ======== crowd.h ========
+ *  Visitors walking through the yard, for the host tools that need more
+ *  than a scripted distance: groups arrive at random along a walkway,
+ *  walk it at their own pace, stop now and then to look, and leave at the
+ *  far end.
+ *
+ *  Everything is in inches and nanoseconds of virtual time, on a flat
+ *  yard seen from above. A visitor is a disk (Crowd_Params.radius) whose
+ *  centre follows the walkway at a fixed sideways offset; the members of
+ *  a group share its pace and stops and follow each other in.
+ *
+ *  Generation is seeded (xorshift64*, Sim_randomFrom), so a crowd is the
+ *  same on every machine. Nothing here drives the simulated board; fleet.c
+ *  asks where everyone is at each ping, slo.c turns one sensor's view
+ *  into a Sim_RangeFxn.
+ *
+ *  A yard layout places the props and the walkway, in inches:
+ *
+ *      millis 3600000                  # length of the run
+ *      prop NAME X Y FACING [PHASE_MS [PING_MS]]
+ *      path X,Y X,Y ...                # walked from the first point to the last
+ *      visitors GROUPS_PER_HOUR
+ *
+ *  FACING is in degrees, anticlockwise from +x. PHASE_MS is when the prop
+ *  was powered on, PING_MS its ping interval. Crowd_readLayout reads one
+ *  for fleet.c and slo.c.
+ */
+
+#ifndef __CROWD_H
+#define __CROWD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define Crowd_PATH_POINTS   32
+#define Crowd_GROUP_MAX     8
+#define Crowd_PAUSES        2
+#define Crowd_LAYOUT_PROPS  256
+#define Crowd_NAME_MAX      32
+
+/*!
+ *  @def    Crowd_Path
+ *  @brief  The walkway, walked from the first point to the last
+ */
+typedef struct Crowd_Path {
+    double x[Crowd_PATH_POINTS];
+    double y[Crowd_PATH_POINTS];
+    size_t count;
+} Crowd_Path;
+
+/*!
+ *  @def    Crowd_Params
+ */
+typedef struct Crowd_Params {
+    double   groupsPerHour;         /* arrivals are a Poisson process */
+    double   groupSizes[Crowd_GROUP_MAX]; /* relative weight of 1, 2, ... people */
+    double   minSpeed;              /* inches per second, per group, uniform */
+    double   maxSpeed;
+    double   spacingMillis;         /* most one member trails the one ahead */
+    double   spread;                /* most a member walks off the centre line, inches */
+    double   pauseChance;           /* per possible stop, Crowd_PAUSES of them */
+    double   minPauseMillis;
+    double   maxPauseMillis;
+    double   radius;                /* inches */
+    uint64_t seed;
+} Crowd_Params;
+
+/*!
+ *  @def    Crowd_Visitor
+ */
+typedef struct Crowd_Visitor {
+    uint32_t group;
+    uint64_t arriveNs;              /* at the start of the walkway */
+    uint64_t leaveNs;               /* past the end of it */
+    double   speed;
+    double   offset;                /* to the left of the centre line, inches */
+    double   pauseAt[Crowd_PAUSES]; /* inches along the walkway */
+    uint64_t pauseNs[Crowd_PAUSES];
+} Crowd_Visitor;
+
+/*!
+ *  @def    Crowd
+ */
+typedef struct Crowd {
+    Crowd_Path     path;
+    double         length[Crowd_PATH_POINTS]; /* walkway inches up to each point */
+    Crowd_Params   params;
+    Crowd_Visitor *visitors;        /* by arrival */
+    size_t         count;
+    uint32_t       groups;
+    uint64_t       longestNs;       /* longest stay, bounds Crowd_present */
+} Crowd;
+
+/*!
+ *  @def    Crowd_LayoutProp
+ */
+typedef struct Crowd_LayoutProp {
+    char     name[Crowd_NAME_MAX];
+    double   x;
+    double   y;
+    double   facing;                /* degrees */
+    bool     phased;                /* the layout gave PHASE_MS */
+    uint64_t phaseNs;               /* 0 if not */
+    uint64_t pingMillis;            /* 0 if the layout gave no PING_MS */
+} Crowd_LayoutProp;
+
+/*!
+ *  @def    Crowd_Layout
+ */
+typedef struct Crowd_Layout {
+    Crowd_Path       path;
+    Crowd_LayoutProp props[Crowd_LAYOUT_PROPS];
+    size_t           propCount;
+    uint64_t         runNs;         /* 0 if the layout gave no millis */
+    double           groupsPerHour; /* negative if it gave no visitors */
+} Crowd_Layout;
+
+/*!
+ *  @def    Crowd_Sensor
+ *  @brief  Where a sensor is and what it can see
+ */
+typedef struct Crowd_Sensor {
+    double x;
+    double y;
+    double dirX;                    /* unit vector it faces */
+    double dirY;
+    double cosBeam;                 /* of the beam's half angle */
+    double range;                   /* farthest echo it hears, inches */
+} Crowd_Sensor;
+
+/*!
+ *  @brief  A haunt's crowd: 30 groups an hour, mostly couples and small
+ *          families, walking 20 to 50 inches a second
+ */
+extern void Crowd_Params_init(Crowd_Params *params);
+
+/*!
+ *  @brief  Everyone who arrives in the first runNs
+ *
+ *  @return false if the walkway has fewer than two points or memory ran out
+ */
+extern bool Crowd_generate(Crowd *crowd, const Crowd_Path *path, const Crowd_Params *params,
+                           uint64_t runNs);
+
+extern void Crowd_free(Crowd *crowd);
+
+/*!
+ *  @brief  Visitors who could be in the yard at ns: [*first, return)
+ */
+extern size_t Crowd_present(const Crowd *crowd, uint64_t ns, size_t *first);
+
+/*!
+ *  @brief  Where a visitor is at ns
+ *
+ *  @return false if they have not arrived or have left
+ */
+extern bool Crowd_position(const Crowd *crowd, size_t visitor, uint64_t ns, double *x, double *y);
+
+/*!
+ *  @brief  Read a yard layout; what is wrong with one goes to stderr
+ *
+ *  @return false if the file cannot be read or parsed, or it has no
+ *          props or a path of fewer than two points
+ */
+extern bool Crowd_readLayout(Crowd_Layout *layout, const char *path);
+
+/*!
+ *  @brief  A prop of a layout by name, or NULL
+ */
+extern const Crowd_LayoutProp *Crowd_findProp(const Crowd_Layout *layout, const char *name);
+
+/*!
+ *  @brief  facing and beam in degrees, facing anticlockwise from +x
+ */
+extern void Crowd_Sensor_init(Crowd_Sensor *sensor, double x, double y, double facing,
+                              double beam, double range);
+
+/*!
+ *  @brief  Distance from a sensor to a disk of radius at x, y, if the
+ *          sensor's beam takes in its centre and the disk is in range
+ *
+ *  @return inches to the near edge, or a negative value
+ */
+extern double Crowd_beamDistance(const Crowd_Sensor *sensor, double x, double y, double radius);
+
+/*!
+ *  @brief  The nearest visitor in a sensor's beam at ns
+ *
+ *  @return inches, or a negative value if nobody; *visitor is theirs
+ */
+extern double Crowd_nearest(const Crowd *crowd, const Crowd_Sensor *sensor, uint64_t ns,
+                            size_t *visitor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CROWD_H */
@@ -0,0 +1,116 @@
+/*
+ *  ======== flashLogFile.c ========
+ *  FlashLog port for a Linux host: the log region is a RAM image, loaded
+ *  from and written through to Sim_Options.flashPath when one is given, so
+ *  the log carries over between runs like the board's flash does across
+ *  resets. tools/flashlog2csv.py reads the file as it reads a dump of the
+ *  board's FLASHLOG region.
+ *
+ *  Programming only clears bits, as on the part. Erase and program take
+ *  no virtual time.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "flashLog.h"
+#include "sim.h"
+
+static uint8_t flashLogFileImage[FlashLog_PAGES * FlashLog_PAGE_SIZE];
+static bool    flashLogFileLoaded = false;
+static FILE   *flashLogFile;
+
+/*
+ *  ======== flashLogFileLoad ========
+ *  Erased flash is all ones; a short file leaves the rest erased
+ */
+static void flashLogFileLoad(void)
+{
+    const char *path = Sim_options()->flashPath;
+
+    flashLogFileLoaded = true;
+    memset(flashLogFileImage, 0xFF, sizeof(flashLogFileImage));
+
+    if (path == NULL) {
+        return;
+    }
+    if ((flashLogFile = fopen(path, "r+b")) != NULL) {
+        if (fread(flashLogFileImage, 1, sizeof(flashLogFileImage), flashLogFile) != sizeof(flashLogFileImage)) {
+            clearerr(flashLogFile);
+        }
+    }
+    else if ((flashLogFile = fopen(path, "w+b")) == NULL) {
+        fprintf(stderr, "flashLog: cannot open %s - log kept in RAM\n", path);
+        return;
+    }
+
+    fseek(flashLogFile, 0, SEEK_SET);
+    fwrite(flashLogFileImage, 1, sizeof(flashLogFileImage), flashLogFile);
+    fflush(flashLogFile);
+}
+
+/*
+ *  ======== flashLogFileSync ========
+ */
+static void flashLogFileSync(uint32_t page)
+{
+    if (flashLogFile != NULL) {
+        fseek(flashLogFile, (long)page * FlashLog_PAGE_SIZE, SEEK_SET);
+        fwrite(&flashLogFileImage[page * FlashLog_PAGE_SIZE], 1, FlashLog_PAGE_SIZE, flashLogFile);
+        fflush(flashLogFile);
+    }
+}
+
+/*
+ *  ======== FlashLog_portPage ========
+ */
+const uint8_t *FlashLog_portPage(uint32_t page)
+{
+    if (!flashLogFileLoaded) {
+        flashLogFileLoad();
+    }
+
+    return (&flashLogFileImage[page * FlashLog_PAGE_SIZE]);
+}
+
+/*
+ *  ======== FlashLog_portErase ========
+ */
+bool FlashLog_portErase(uint32_t page)
+{
+    if (page >= FlashLog_PAGES) {
+        return (false);
+    }
+
+    memset((void *)FlashLog_portPage(page), 0xFF, FlashLog_PAGE_SIZE);
+    flashLogFileSync(page);
+
+    return (true);
+}
+
+/*
+ *  ======== FlashLog_portProgram ========
+ */
+bool FlashLog_portProgram(uint32_t page, uint32_t offset, const uint32_t *words, uint32_t count)
+{
+    uint8_t  *dest;
+    uint32_t  word;
+    uint32_t  i;
+
+    if (page >= FlashLog_PAGES || (offset % sizeof(uint32_t)) != 0 ||
+        offset + count * sizeof(uint32_t) > FlashLog_PAGE_SIZE) {
+        return (false);
+    }
+
+    dest = (uint8_t *)FlashLog_portPage(page) + offset;
+    for (i = 0; i < count; i++) {
+        memcpy(&word, dest + i * sizeof(uint32_t), sizeof(word));
+        word &= words[i];
+        memcpy(dest + i * sizeof(uint32_t), &word, sizeof(word));
+    }
+    flashLogFileSync(page);
+
+    return (true);
+}
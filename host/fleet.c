@@ -0,0 +1,666 @@
+/*
+ *  ======== fleet.c ========
+ *  A yard full of props: runs the trigger path of many werewolves side by
+ *  side in one process, in one shared scene, so a layout and its ping
+ *  schedule can be tried before anything is built.
+ *
+ *      werewolf_fleet [--hours H] [--seed S] [--groups-per-hour N]
+ *                     [--beam DEG] [--range INCHES] [--stagger] [-j THREADS]
+ *                     [-o FILE] yard.layout
+ *
+ *  A layout places the props and the walkway (crowd.h). A prop with no
+ *  PING_MS pings every pingIntervalMillis. --stagger spreads the power-on
+ *  times of props with no PHASE_MS evenly over one ping interval, the
+ *  schedule to beat. --hours and --groups-per-hour override the layout.
+ *
+ *  Each prop is the firmware's trigger path, not the whole app: the app
+ *  keeps its state in globals, so one process holds one werewolf.c, and a
+ *  yard of full copies would need a process each and a shared clock
+ *  between them. Here every prop has its own Detect_State (detect.h) and
+ *  follows distSensorFxn's timing with werewolf.c's own constants: a 1 ms
+ *  trigger pulse, the echo, pingIntervalMillis on the tick, and after a
+ *  trigger the whole show (lengthOfRisingMode ... resetMillis) blind.
+ *
+ *  The acoustic channel is shared. Every ping is heard by every sensor
+ *  whose beam takes in where it comes from: the prop's own echo off a
+ *  visitor, a neighbour's ping off a visitor both beams take in, or a
+ *  neighbour's ping straight across when the two face each other. The
+ *  sensor reports whichever arrives first in its listening window, the
+ *  way an HC-SR04 does, so a neighbour's ping reads as a near visitor.
+ *  Paths longer than twice the range are too faint to hear.
+ *
+ *  Time runs in lockstep epochs, split over threads by prop. Within an
+ *  epoch a prop resolves its ping reading only the other props' last and
+ *  next ping times from the previous epoch; then all of them publish. A
+ *  ping can only hear pings within FLEET_LISTEN_NS of it, and an epoch is
+ *  that much (and FLEET_EPOCH_SPARE_NS) shorter than the shortest ping
+ *  interval, so a prop pings at most once an epoch, the last and next
+ *  pings are all another can hear, and the result does not depend on the
+ *  thread count.
+ *
+ *  Output is a CSV line per prop: its pings and how many read a
+ *  neighbour, its shows, how many a neighbour set off (false) and how
+ *  many started within FLEET_TOGETHER_NS of a neighbour's, and the groups
+ *  of visitors it saw in its trigger window and never showed to. The
+ *  summary, and the prop pairs that hear each other and go off together
+ *  most, go to stderr.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "crowd.h"
+#include "detect.h"
+#include "sim.h"
+#include "werewolfParams.h"
+
+#define FLEET_PROPS         Crowd_LAYOUT_PROPS
+#define FLEET_PAIRS         8               /* listed, of each kind */
+#define FLEET_EPOCH_SPARE_NS 10000000ull   /* between an epoch and the listening window */
+#define FLEET_LISTEN_NS     38000000ull     /* Sim_ECHO_NONE_NS: the listening window */
+#define FLEET_BLIND_NS      300000ull       /* the sensor cannot hear its own burst ring down */
+#define FLEET_MIN_PING_MS   100             /* an epoch of at least 52 ms */
+#define FLEET_NS_PER_INCH   74000ull        /* one way */
+#define FLEET_TOGETHER_NS   2000000000ull   /* shows starting this close went off together */
+#define FLEET_TICK_NS       1000000ull
+#define FLEET_NEVER         UINT64_MAX
+
+typedef struct Fleet_Prop {
+    char          name[Crowd_NAME_MAX];
+    Crowd_Sensor  sensor;
+    double        facing;
+    uint64_t      phaseNs;
+    uint64_t      pingMillis;
+    bool          phased;       /* the layout gave a phase */
+    Detect_State  detect;
+
+    uint64_t      resolvedNs;   /* this epoch's ping, to publish */
+    uint64_t      followingNs;  /* and the one after it */
+
+    uint32_t      pings;
+    uint32_t      crosstalk;    /* pings that read a neighbour's ping first */
+    uint32_t      falseShows;   /* shows set off by a reading that was not the prop's own echo */
+    uint32_t      together;     /* shows that went off with a neighbour's */
+    uint64_t     *shows;        /* when transistorGatePin went on */
+    size_t        showCount;
+    size_t        showCapacity;
+    uint32_t     *heard;        /* per other prop, pings whose reading was theirs */
+    uint8_t      *seen;         /* per group: FLEET_SEEN, FLEET_REVEALED */
+} Fleet_Prop;
+
+#define FLEET_SEEN          1   /* one of them in the trigger window at one of the prop's pings */
+#define FLEET_REVEALED      2   /* one of them in it at the ping that started a show */
+
+typedef struct Fleet_Pair {
+    size_t   a;
+    size_t   b;
+    uint32_t count;
+} Fleet_Pair;
+
+static Fleet_Prop        fleetProps[FLEET_PROPS];
+static size_t            fleetPropCount;
+static Crowd             fleetCrowd;
+static Crowd_Layout      fleetLayout;
+static double            fleetGroupsPerHour = -1.0;
+static uint64_t          fleetRunNs = 3600000ull * 1000000ull;
+static uint64_t          fleetBlindMillis;  /* after a trigger, until the next ping interval */
+
+/* published once per epoch */
+static uint64_t          fleetLastNs[FLEET_PROPS];
+static uint64_t          fleetNextNs[FLEET_PROPS];
+
+static uint64_t          fleetEpochNs;
+static size_t            fleetThreads;
+static pthread_barrier_t fleetBarrier;
+
+/*
+ *  ======== fleetReadLayout ========
+ */
+static void fleetReadLayout(const char *path, double beam, double range)
+{
+    const Crowd_LayoutProp *from;
+    Fleet_Prop             *prop;
+    size_t                  p;
+
+    if (!Crowd_readLayout(&fleetLayout, path)) {
+        Sim_fail("fleet", "cannot use the layout", path);
+    }
+    if (fleetLayout.runNs != 0) {
+        fleetRunNs = fleetLayout.runNs;
+    }
+    if (fleetGroupsPerHour < 0.0) {
+        fleetGroupsPerHour = fleetLayout.groupsPerHour;
+    }
+
+    for (p = 0; p < fleetLayout.propCount; p++) {
+        from = &fleetLayout.props[p];
+        prop = &fleetProps[fleetPropCount++];
+        strcpy(prop->name, from->name);
+        Crowd_Sensor_init(&prop->sensor, from->x, from->y, from->facing, beam, range);
+        prop->facing = from->facing;
+        prop->phased = from->phased;
+        prop->phaseNs = from->phaseNs;
+        prop->pingMillis = (from->pingMillis != 0) ? from->pingMillis : (uint64_t)pingIntervalMillis;
+    }
+}
+
+/*
+ *  ======== fleetArrival ========
+ *  Keep the earlier of two arrival times
+ */
+static inline void fleetArrival(uint64_t *first, uint64_t ns)
+{
+    if (ns < *first) {
+        *first = ns;
+    }
+}
+
+/*
+ *  ======== fleetHear ========
+ *  Earliest sound from prop from's ping at emitNs that prop to hears
+ */
+static uint64_t fleetHear(size_t to, size_t from, uint64_t emitNs,
+                          const double *xs, const double *ys, size_t present)
+{
+    const Crowd_Sensor *listener = &fleetProps[to].sensor;
+    const Crowd_Sensor *speaker = &fleetProps[from].sensor;
+    double              radius = fleetCrowd.params.radius;
+    double              limit = 2.0 * listener->range;
+    double              out;
+    double              back;
+    uint64_t            first = FLEET_NEVER;
+    size_t              v;
+
+    /* straight across, when each is in the other's beam */
+    if (from != to && (out = Crowd_beamDistance(speaker, listener->x, listener->y, 0.0)) >= 0.0 &&
+        Crowd_beamDistance(listener, speaker->x, speaker->y, 0.0) >= 0.0) {
+        fleetArrival(&first, emitNs + (uint64_t)(out * FLEET_NS_PER_INCH));
+    }
+
+    /* off a visitor both beams take in */
+    for (v = 0; v < present; v++) {
+        if ((out = Crowd_beamDistance(speaker, xs[v], ys[v], radius)) < 0.0 || out > limit) {
+            continue;
+        }
+        back = (from == to) ? out : Crowd_beamDistance(listener, xs[v], ys[v], radius);
+        if (back >= 0.0 && out + back <= limit) {
+            fleetArrival(&first, emitNs + (uint64_t)((out + back) * FLEET_NS_PER_INCH));
+        }
+    }
+
+    return (first);
+}
+
+/*
+ *  ======== fleetPing ========
+ *  One pass of distSensorFxn for prop p, pinging at ns; sets
+ *  resolvedNs and followingNs
+ */
+static void fleetPing(size_t p, uint64_t ns, double *xs, double *ys, size_t *ids)
+{
+    Fleet_Prop    *prop = &fleetProps[p];
+    Detect_Result  result;
+    uint64_t       window = ns + FLEET_LISTEN_NS;
+    uint64_t       own;
+    uint64_t       first;
+    uint64_t       heard;
+    uint64_t       endNs;
+    uint64_t       sleepMillis;
+    uint16_t       duration;
+    size_t         present = 0;
+    size_t         begin;
+    size_t         end;
+    size_t         from = p;
+    size_t         other;
+    size_t         v;
+    double         distance;
+    bool           trigger;
+
+    end = Crowd_present(&fleetCrowd, ns, &begin);
+    for (v = begin; v < end; v++) {
+        if (Crowd_position(&fleetCrowd, v, ns, &xs[present], &ys[present])) {
+            ids[present++] = v;
+        }
+    }
+
+    own = fleetHear(p, p, ns, xs, ys, present);
+    first = own;
+    for (other = 0; other < fleetPropCount; other++) {
+        if (other == p) {
+            continue;
+        }
+        /* at most one of them can be near enough to this ping to be heard */
+        if (fleetLastNs[other] != FLEET_NEVER && fleetLastNs[other] + FLEET_LISTEN_NS > ns) {
+            heard = fleetHear(p, other, fleetLastNs[other], xs, ys, present);
+        }
+        else if (fleetNextNs[other] < window) {
+            heard = fleetHear(p, other, fleetNextNs[other], xs, ys, present);
+        }
+        else {
+            continue;
+        }
+        if (heard > ns + FLEET_BLIND_NS && heard < first) {
+            first = heard;
+            from = other;
+        }
+    }
+
+    if (first < window && first > ns + FLEET_BLIND_NS) {
+        duration = (uint16_t)((first - ns) / 1000u);
+    }
+    else {
+        duration = (uint16_t)(Sim_ECHO_NONE_NS / 1000u);
+        from = p;
+    }
+    prop->pings++;
+    if (from != p) {
+        prop->crosstalk++;
+        prop->heard[from]++;
+    }
+
+    /* what the prop would have seen on its own */
+    for (v = 0; v < present; v++) {
+        distance = Crowd_beamDistance(&prop->sensor, xs[v], ys[v], fleetCrowd.params.radius);
+        if (distance >= minTriggerDistance && distance <= maxTriggerDistance) {
+            prop->seen[fleetCrowd.visitors[ids[v]].group] |= FLEET_SEEN;
+        }
+    }
+
+    result = Detect_sample(&prop->detect, Detect_distance(duration));
+    trigger = (result == Detect_Trigger);
+    endNs = ns + Sim_ECHO_DELAY_NS + (uint64_t)duration * 1000u;
+    sleepMillis = prop->pingMillis;
+
+    if (trigger) {
+        if (prop->showCount == prop->showCapacity) {
+            prop->showCapacity = (prop->showCapacity != 0) ? prop->showCapacity * 2 : 64;
+            prop->shows = Sim_alloc("fleet", prop->shows, prop->showCapacity * sizeof(uint64_t));
+        }
+        prop->shows[prop->showCount++] = endNs;
+        if (own >= window || own <= ns + FLEET_BLIND_NS ||
+            Detect_distance((uint16_t)((own - ns) / 1000u)) < minTriggerDistance ||
+            Detect_distance((uint16_t)((own - ns) / 1000u)) > maxTriggerDistance) {
+            prop->falseShows++;
+        }
+        for (v = 0; v < present; v++) {
+            distance = Crowd_beamDistance(&prop->sensor, xs[v], ys[v], fleetCrowd.params.radius);
+            if (distance >= minTriggerDistance && distance <= maxTriggerDistance) {
+                prop->seen[fleetCrowd.visitors[ids[v]].group] |= FLEET_REVEALED;
+            }
+        }
+        sleepMillis += fleetBlindMillis;
+    }
+
+    /* Task_sleep counts from the tick, then the 1 ms trigger pulse */
+    prop->resolvedNs = ns;
+    prop->followingNs = (endNs / FLEET_TICK_NS + sleepMillis + 1) * FLEET_TICK_NS;
+}
+
+/*
+ *  ======== fleetWorker ========
+ */
+static void *fleetWorker(void *arg)
+{
+    size_t   self = (size_t)(uintptr_t)arg;
+    size_t   capacity = 64;
+    double  *xs = Sim_alloc("fleet", NULL, capacity * sizeof(double));
+    double  *ys = Sim_alloc("fleet", NULL, capacity * sizeof(double));
+    size_t  *ids = Sim_alloc("fleet", NULL, capacity * sizeof(size_t));
+    size_t   begin;
+    size_t   p;
+    uint64_t epoch;
+    uint64_t epochEnd;
+
+    for (epoch = 0; epoch < fleetRunNs; epoch = epochEnd) {
+        epochEnd = epoch + fleetEpochNs;
+
+        for (p = self; p < fleetPropCount; p += fleetThreads) {
+            fleetProps[p].resolvedNs = FLEET_NEVER;
+            if (fleetNextNs[p] < epochEnd && fleetNextNs[p] < fleetRunNs) {
+                if (Crowd_present(&fleetCrowd, fleetNextNs[p], &begin) - begin > capacity) {
+                    capacity = (Crowd_present(&fleetCrowd, fleetNextNs[p], &begin) - begin) * 2;
+                    xs = Sim_alloc("fleet", xs, capacity * sizeof(double));
+                    ys = Sim_alloc("fleet", ys, capacity * sizeof(double));
+                    ids = Sim_alloc("fleet", ids, capacity * sizeof(size_t));
+                }
+                fleetPing(p, fleetNextNs[p], xs, ys, ids);
+            }
+        }
+        pthread_barrier_wait(&fleetBarrier);
+
+        for (p = self; p < fleetPropCount; p += fleetThreads) {
+            if (fleetProps[p].resolvedNs != FLEET_NEVER) {
+                fleetLastNs[p] = fleetProps[p].resolvedNs;
+                fleetNextNs[p] = fleetProps[p].followingNs;
+            }
+        }
+        pthread_barrier_wait(&fleetBarrier);
+    }
+
+    free(xs);
+    free(ys);
+    free(ids);
+
+    return (NULL);
+}
+
+/*
+ *  ======== fleetTogether ========
+ *  Shows of a that started within FLEET_TOGETHER_NS of one of b's; flags
+ *  them in flags
+ */
+static uint32_t fleetTogether(size_t a, size_t b, bool *flags)
+{
+    const Fleet_Prop *pa = &fleetProps[a];
+    const Fleet_Prop *pb = &fleetProps[b];
+    uint32_t          count = 0;
+    size_t            i = 0;
+    size_t            j = 0;
+
+    while (i < pa->showCount && j < pb->showCount) {
+        if (pa->shows[i] + FLEET_TOGETHER_NS <= pb->shows[j]) {
+            i++;
+        }
+        else if (pb->shows[j] + FLEET_TOGETHER_NS <= pa->shows[i]) {
+            j++;
+        }
+        else {
+            count++;
+            flags[i] = true;
+            i++;
+        }
+    }
+
+    return (count);
+}
+
+/*
+ *  ======== fleetComparePairs ========
+ */
+static int fleetComparePairs(const void *a, const void *b)
+{
+    const Fleet_Pair *pa = a;
+    const Fleet_Pair *pb = b;
+
+    if (pa->count != pb->count) {
+        return ((pa->count > pb->count) ? -1 : 1);
+    }
+    if (pa->a != pb->a) {
+        return ((pa->a < pb->a) ? -1 : 1);
+    }
+
+    return ((pa->b < pb->b) ? -1 : (pa->b > pb->b));
+}
+
+/*
+ *  ======== fleetListPairs ========
+ */
+static void fleetListPairs(Fleet_Pair *pairs, size_t count, const char *verb)
+{
+    size_t i;
+
+    qsort(pairs, count, sizeof(Fleet_Pair), fleetComparePairs);
+    for (i = 0; i < count && i < FLEET_PAIRS && pairs[i].count != 0; i++) {
+        fprintf(stderr, "fleet:   %-12s %s %-12s %u times\n", fleetProps[pairs[i].a].name, verb,
+                fleetProps[pairs[i].b].name, pairs[i].count);
+    }
+}
+
+/*
+ *  ======== fleetReport ========
+ */
+static void fleetReport(FILE *out, double wallSeconds)
+{
+    Fleet_Pair   *heardPairs = Sim_alloc("fleet", NULL, fleetPropCount * fleetPropCount * sizeof(Fleet_Pair));
+    Fleet_Pair   *showPairs = Sim_alloc("fleet", NULL, fleetPropCount * fleetPropCount * sizeof(Fleet_Pair));
+    bool         *flags;
+    size_t        heardCount = 0;
+    size_t        showCount = 0;
+    size_t        a;
+    size_t        b;
+    size_t        v;
+    size_t        i;
+    uint32_t      seen;
+    uint32_t      missed;
+    uint32_t      together;
+    double        hours = fleetRunNs / 3600.0e9;
+    unsigned long pings = 0;
+    unsigned long crosstalk = 0;
+    unsigned long shows = 0;
+    unsigned long falseShows = 0;
+    unsigned long withNeighbour = 0;
+
+    fprintf(out, "prop,x,y,facing,phaseMs,pingMs,pings,crosstalkPings,crosstalkRate,shows,"
+                 "falseShows,falsePerHour,showsWithNeighbour,groupsSeen,groupsMissed\n");
+
+    for (a = 0; a < fleetPropCount; a++) {
+        Fleet_Prop *prop = &fleetProps[a];
+
+        flags = Sim_alloc("fleet", NULL, (prop->showCount + 1) * sizeof(bool));
+        memset(flags, 0, (prop->showCount + 1) * sizeof(bool));
+        for (b = 0; b < fleetPropCount; b++) {
+            if (b == a) {
+                continue;
+            }
+            together = fleetTogether(a, b, flags);
+            if (b > a) {
+                showPairs[showCount].a = a;
+                showPairs[showCount].b = b;
+                showPairs[showCount].count = together;
+                showCount++;
+            }
+            heardPairs[heardCount].a = a;
+            heardPairs[heardCount].b = b;
+            heardPairs[heardCount].count = prop->heard[b];
+            heardCount++;
+        }
+        for (i = 0; i < prop->showCount; i++) {
+            prop->together += flags[i];
+        }
+        free(flags);
+
+        seen = missed = 0;
+        for (v = 0; v < fleetCrowd.groups; v++) {
+            if (prop->seen[v] & FLEET_SEEN) {
+                seen++;
+                if (!(prop->seen[v] & FLEET_REVEALED)) {
+                    missed++;
+                }
+            }
+        }
+
+        fprintf(out, "%s,%.0f,%.0f,%.0f,%llu,%llu,%u,%u,%.4f,%zu,%u,%.2f,%u,%u,%u\n",
+                prop->name, prop->sensor.x, prop->sensor.y, prop->facing,
+                (unsigned long long)(prop->phaseNs / 1000000ull), (unsigned long long)prop->pingMillis,
+                prop->pings, prop->crosstalk, (prop->pings != 0) ? (double)prop->crosstalk / prop->pings : 0.0,
+                prop->showCount, prop->falseShows, prop->falseShows / hours, prop->together, seen, missed);
+
+        pings += prop->pings;
+        crosstalk += prop->crosstalk;
+        shows += prop->showCount;
+        falseShows += prop->falseShows;
+        withNeighbour += prop->together;
+    }
+
+    fprintf(stderr, "fleet: %zu props, %.1f h, %zu visitors in %u groups, simulated in %.2f s "
+                    "on %zu threads\n",
+            fleetPropCount, hours, fleetCrowd.count, fleetCrowd.groups, wallSeconds, fleetThreads);
+    fprintf(stderr, "fleet: %lu pings, %.2f%% read a neighbour's ping; %lu shows, %lu false "
+                    "(%.1f/h), %lu went off with a neighbour's\n",
+            pings, (pings != 0) ? 100.0 * crosstalk / pings : 0.0, shows, falseShows,
+            falseShows / hours, withNeighbour);
+    if (crosstalk != 0) {
+        fprintf(stderr, "fleet: crosstalk, most first:\n");
+        fleetListPairs(heardPairs, heardCount, "heard");
+    }
+    if (withNeighbour != 0) {
+        fprintf(stderr, "fleet: shows that went off together, most first:\n");
+        fleetListPairs(showPairs, showCount, "and  ");
+    }
+
+    free(heardPairs);
+    free(showPairs);
+}
+
+/*
+ *  ======== fleetUsage ========
+ */
+static void fleetUsage(void)
+{
+    fprintf(stderr,
+            "usage: werewolf_fleet [--hours H] [--seed S] [--groups-per-hour N]\n"
+            "                      [--beam DEG] [--range INCHES] [--stagger] [-j THREADS]\n"
+            "                      [-o FILE] yard.layout\n");
+    exit(EXIT_FAILURE);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(int argc, char *argv[])
+{
+    Crowd_Params    params;
+    Detect_Params   detect = { minTriggerDistance, maxTriggerDistance, requiredHitCount };
+    pthread_t      *threads;
+    FILE           *out = stdout;
+    const char     *outPath = NULL;
+    const char     *layout = NULL;
+    double          hours = -1.0;
+    double          beam = 15.0;
+    double          range = 160.0;
+    bool            stagger = false;
+    long            cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    struct timespec start;
+    struct timespec end;
+    size_t          unphased = 0;
+    size_t          slot = 0;
+    size_t          p;
+    size_t          t;
+    int             arg;
+
+    Crowd_Params_init(&params);
+    fleetThreads = (cpus > 0) ? (size_t)cpus : 1;
+
+    for (arg = 1; arg < argc; arg++) {
+        const char *value = (arg + 1 < argc) ? argv[arg + 1] : NULL;
+
+        if (strcmp(argv[arg], "--hours") == 0 && value != NULL) {
+            hours = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--seed") == 0 && value != NULL) {
+            params.seed = strtoull(value, NULL, 0);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--groups-per-hour") == 0 && value != NULL) {
+            fleetGroupsPerHour = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--beam") == 0 && value != NULL) {
+            beam = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--range") == 0 && value != NULL) {
+            range = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-j") == 0 && value != NULL) {
+            fleetThreads = (size_t)strtoul(value, NULL, 0);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-o") == 0 && value != NULL) {
+            outPath = value;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--stagger") == 0) {
+            stagger = true;
+        }
+        else if (argv[arg][0] != '-' && layout == NULL) {
+            layout = argv[arg];
+        }
+        else {
+            fleetUsage();
+        }
+    }
+    if (layout == NULL) {
+        fleetUsage();
+    }
+
+    fleetReadLayout(layout, beam, range);
+    if (hours > 0.0) {
+        fleetRunNs = (uint64_t)(hours * 3600.0e9);
+    }
+    if (fleetGroupsPerHour >= 0.0) {
+        params.groupsPerHour = fleetGroupsPerHour;
+    }
+    if (!Crowd_generate(&fleetCrowd, &fleetLayout.path, &params, fleetRunNs)) {
+        Sim_fail("fleet", "cannot generate visitors for", layout);
+    }
+
+    fleetBlindMillis = WerewolfParams_showMillis();
+
+    fleetEpochNs = UINT64_MAX;
+    for (p = 0; p < fleetPropCount; p++) {
+        Fleet_Prop *prop = &fleetProps[p];
+
+        if (prop->pingMillis < FLEET_MIN_PING_MS) {
+            Sim_fail("fleet", "ping intervals under 100 ms are not modelled:", prop->name);
+        }
+        if (prop->pingMillis * 1000000ull - FLEET_LISTEN_NS - FLEET_EPOCH_SPARE_NS < fleetEpochNs) {
+            fleetEpochNs = prop->pingMillis * 1000000ull - FLEET_LISTEN_NS - FLEET_EPOCH_SPARE_NS;
+        }
+        unphased += !prop->phased;
+    }
+    for (p = 0; p < fleetPropCount; p++) {
+        Fleet_Prop *prop = &fleetProps[p];
+
+        if (stagger && !prop->phased) {
+            prop->phaseNs = prop->pingMillis * 1000000ull * slot++ / unphased;
+        }
+        Detect_init(&prop->detect, &detect);
+        prop->heard = Sim_alloc("fleet", NULL, fleetPropCount * sizeof(uint32_t));
+        memset(prop->heard, 0, fleetPropCount * sizeof(uint32_t));
+        prop->seen = Sim_alloc("fleet", NULL, fleetCrowd.groups + 1);
+        memset(prop->seen, 0, fleetCrowd.groups + 1);
+
+        /* the first ping: power on, then the trigger pulse */
+        fleetLastNs[p] = FLEET_NEVER;
+        fleetNextNs[p] = (prop->phaseNs / FLEET_TICK_NS + 1) * FLEET_TICK_NS;
+    }
+
+    if (fleetThreads == 0) {
+        fleetThreads = 1;
+    }
+    if (fleetThreads > fleetPropCount) {
+        fleetThreads = fleetPropCount;
+    }
+    pthread_barrier_init(&fleetBarrier, NULL, (unsigned)fleetThreads);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    threads = Sim_alloc("fleet", NULL, fleetThreads * sizeof(pthread_t));
+    for (t = 0; t < fleetThreads; t++) {
+        if (pthread_create(&threads[t], NULL, fleetWorker, (void *)(uintptr_t)t) != 0) {
+            Sim_fail("fleet", "cannot start threads", NULL);
+        }
+    }
+    for (t = 0; t < fleetThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (outPath != NULL && (out = fopen(outPath, "w")) == NULL) {
+        Sim_fail("fleet", "cannot create", outPath);
+    }
+    fleetReport(out, (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,21 @@
+/*
+ *  ======== ti/drivers/GPIO.h ========
+ *  Host stand-in - pins live in host/simBoard.c, every level change is
+ *  recorded, and the echo pin is driven by the sensor model.
+ */
+
+#ifndef __TI_DRIVERS_GPIO_H
+#define __TI_DRIVERS_GPIO_H
+
+#include <stdint.h>
+
+typedef uint32_t GPIO_PinConfig;
+
+typedef void (*GPIO_CallbackFxn)(unsigned int index);
+
+extern void     GPIO_init(void);
+extern uint_fast8_t GPIO_read(unsigned int index);
+extern void     GPIO_write(unsigned int index, unsigned int value);
+extern void     GPIO_toggle(unsigned int index);
+
+#endif /* __TI_DRIVERS_GPIO_H */
@@ -0,0 +1,37 @@
+/*
+ *  ======== ti/drivers/PWM.h ========
+ *  Host stand-in - duty changes are recorded by host/simBoard.c.
+ */
+
+#ifndef __TI_DRIVERS_PWM_H
+#define __TI_DRIVERS_PWM_H
+
+#include <stdint.h>
+
+typedef struct PWM_Config *PWM_Handle;
+
+typedef enum PWM_DutyMode {
+    PWM_DUTY_COUNTS = 0,
+    PWM_DUTY_SCALAR,
+    PWM_DUTY_TIME
+} PWM_DutyMode;
+
+typedef enum PWM_Polarity {
+    PWM_POL_ACTIVE_HIGH = 0,
+    PWM_POL_ACTIVE_LOW
+} PWM_Polarity;
+
+typedef struct PWM_Params {
+    uint32_t     period;        /* microseconds */
+    PWM_DutyMode dutyMode;
+    PWM_Polarity polarity;
+    uintptr_t    custom;
+} PWM_Params;
+
+extern void       PWM_init(void);
+extern void       PWM_Params_init(PWM_Params *params);
+extern PWM_Handle PWM_open(unsigned int index, PWM_Params *params);
+extern void       PWM_close(PWM_Handle handle);
+extern void       PWM_setDuty(PWM_Handle handle, uint32_t duty);
+
+#endif /* __TI_DRIVERS_PWM_H */
@@ -0,0 +1,22 @@
+/*
+ *  ======== ti/sysbios/BIOS.h ========
+ *  Host stand-in - BIOS_start runs the simulated scheduler and returns when
+ *  the configured run ends, see host/sim.h.
+ */
+
+#ifndef __TI_SYSBIOS_BIOS_H
+#define __TI_SYSBIOS_BIOS_H
+
+#include <xdc/std.h>
+
+typedef enum BIOS_ThreadType {
+    BIOS_ThreadType_Hwi = 0,
+    BIOS_ThreadType_Swi,
+    BIOS_ThreadType_Task,
+    BIOS_ThreadType_Main
+} BIOS_ThreadType;
+
+extern Void            BIOS_start(void);
+extern BIOS_ThreadType BIOS_getThreadType(void);
+
+#endif /* __TI_SYSBIOS_BIOS_H */
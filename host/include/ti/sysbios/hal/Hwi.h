@@ -0,0 +1,15 @@
+/*
+ *  ======== ti/sysbios/hal/Hwi.h ========
+ *  Host stand-in. While interrupts are "disabled" virtual time still moves,
+ *  but Clock ticks are held back until Hwi_restore re-enables them.
+ */
+
+#ifndef __TI_SYSBIOS_HAL_HWI_H
+#define __TI_SYSBIOS_HAL_HWI_H
+
+#include <xdc/std.h>
+
+extern UInt Hwi_disable(void);
+extern Void Hwi_restore(UInt key);
+
+#endif /* __TI_SYSBIOS_HAL_HWI_H */
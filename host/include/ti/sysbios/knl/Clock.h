@@ -0,0 +1,39 @@
+/*
+ *  ======== ti/sysbios/knl/Clock.h ========
+ *  Host stand-in - one tick per millisecond of virtual time, Clock
+ *  functions run at the tick they are due, see host/sim.h.
+ */
+
+#ifndef __TI_SYSBIOS_KNL_CLOCK_H
+#define __TI_SYSBIOS_KNL_CLOCK_H
+
+#include <xdc/std.h>
+
+typedef Void (*Clock_FuncPtr)(UArg arg);
+
+typedef struct Clock_Object *Clock_Handle;
+
+typedef struct Clock_Struct {
+    struct Clock_Object *object;
+} Clock_Struct;
+
+typedef struct Clock_Params {
+    Bool   startFlag;
+    UInt32 period;
+    UArg   arg;
+} Clock_Params;
+
+/* microseconds per tick, as set in pwmled.cfg */
+extern const UInt32 Clock_tickPeriod;
+
+extern UInt32       Clock_getTicks(void);
+extern Void         Clock_Params_init(Clock_Params *params);
+extern Clock_Handle Clock_create(Clock_FuncPtr fxn, UInt timeout, const Clock_Params *params, Ptr eb);
+extern Void         Clock_construct(Clock_Struct *obj, Clock_FuncPtr fxn, UInt timeout, const Clock_Params *params);
+extern Clock_Handle Clock_handle(Clock_Struct *obj);
+extern Void         Clock_start(Clock_Handle handle);
+extern Void         Clock_stop(Clock_Handle handle);
+extern Void         Clock_setPeriod(Clock_Handle handle, UInt32 period);
+extern Void         Clock_setTimeout(Clock_Handle handle, UInt32 timeout);
+
+#endif /* __TI_SYSBIOS_KNL_CLOCK_H */
@@ -0,0 +1,62 @@
+/*
+ *  ======== ti/sysbios/knl/Task.h ========
+ *  Host stand-in - each Task is a coroutine on its own host stack, switched
+ *  by the simulated scheduler in host/sim.c. The stack passed in
+ *  Task_Params is not used, but its size is what Task_stat reports.
+ */
+
+#ifndef __TI_SYSBIOS_KNL_TASK_H
+#define __TI_SYSBIOS_KNL_TASK_H
+
+#include <xdc/std.h>
+
+typedef Void (*Task_FuncPtr)(UArg arg0, UArg arg1);
+
+typedef struct Task_Object *Task_Handle;
+
+typedef struct Task_Struct {
+    struct Task_Object *object;
+} Task_Struct;
+
+typedef enum Task_Mode {
+    Task_Mode_RUNNING = 0,
+    Task_Mode_READY,
+    Task_Mode_BLOCKED,
+    Task_Mode_TERMINATED,
+    Task_Mode_INACTIVE
+} Task_Mode;
+
+typedef struct Task_Params {
+    UArg   arg0;
+    UArg   arg1;
+    Int    priority;
+    Ptr    stack;
+    size_t stackSize;
+    Ptr    env;
+    CString name;
+} Task_Params;
+
+typedef struct Task_Stat {
+    Int       priority;
+    Ptr       stack;
+    size_t    stackSize;
+    Task_Mode mode;
+    Ptr       env;
+    size_t    used;
+} Task_Stat;
+
+extern Void        Task_Params_init(Task_Params *params);
+extern Task_Handle Task_create(Task_FuncPtr fxn, const Task_Params *params, Ptr eb);
+extern Void        Task_construct(Task_Struct *obj, Task_FuncPtr fxn, const Task_Params *params, Ptr eb);
+extern Task_Handle Task_handle(Task_Struct *obj);
+extern Void        Task_sleep(UInt32 nticks);
+extern Void        Task_yield(void);
+extern Task_Handle Task_self(void);
+extern Task_Handle Task_getIdleTask(void);
+extern Void        Task_stat(Task_Handle handle, Task_Stat *stat);
+extern UInt        Task_disable(void);
+extern Void        Task_restore(UInt key);
+extern Ptr         Task_getHookContext(Task_Handle handle, Int id);
+extern Void        Task_setHookContext(Task_Handle handle, Int id, Ptr context);
+
+#endif /* __TI_SYSBIOS_KNL_TASK_H */
@@ -0,0 +1,18 @@
+/*
+ *  ======== xdc/runtime/System.h ========
+ *  Host stand-in. System_printf goes to stdout only when the simulator's
+ *  console option is on; System_abort runs the configured abort hook and
+ *  stops the simulation instead of halting.
+ */
+
+#ifndef __XDC_RUNTIME_SYSTEM_H
+#define __XDC_RUNTIME_SYSTEM_H
+
+#include <xdc/std.h>
+
+extern Int  System_printf(CString fmt, ...) __attribute__((format(printf, 1, 2)));
+extern Void System_flush(void);
+extern Void System_abort(CString str);
+extern Void System_abortStd(void);
+
+#endif /* __XDC_RUNTIME_SYSTEM_H */
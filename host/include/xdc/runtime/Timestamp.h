@@ -0,0 +1,15 @@
+/*
+ *  ======== xdc/runtime/Timestamp.h ========
+ *  Host stand-in - counts CPU clocks of virtual time, see host/sim.h.
+ */
+
+#ifndef __XDC_RUNTIME_TIMESTAMP_H
+#define __XDC_RUNTIME_TIMESTAMP_H
+
+#include <xdc/std.h>
+#include <xdc/runtime/Types.h>
+
+extern Bits32 Timestamp_get32(void);
+extern Void   Timestamp_getFreq(Types_FreqHz *freq);
+
+#endif /* __XDC_RUNTIME_TIMESTAMP_H */
@@ -0,0 +1,16 @@
+/*
+ *  ======== xdc/runtime/Types.h ========
+ *  Host stand-in - see host/sim.h.
+ */
+
+#ifndef __XDC_RUNTIME_TYPES_H
+#define __XDC_RUNTIME_TYPES_H
+
+#include <xdc/std.h>
+
+typedef struct Types_FreqHz {
+    Bits32 hi;
+    Bits32 lo;
+} Types_FreqHz;
+
+#endif /* __XDC_RUNTIME_TYPES_H */
@@ -0,0 +1,38 @@
+/*
+ *  ======== xdc/std.h ========
+ *  Host stand-in for the XDCtools base types - only what the app uses.
+ */
+
+#ifndef __XDC_STD_H
+#define __XDC_STD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef void            Void;
+typedef char            Char;
+typedef int             Int;
+typedef unsigned int    UInt;
+typedef long            Long;
+typedef unsigned long   ULong;
+typedef int8_t          Int8;
+typedef int16_t         Int16;
+typedef int32_t         Int32;
+typedef uint8_t         UInt8;
+typedef uint16_t        UInt16;
+typedef uint32_t        UInt32;
+typedef uint32_t        Bits32;
+typedef unsigned short  Bool;
+typedef char           *String;
+typedef const char     *CString;
+typedef void           *Ptr;
+typedef uintptr_t       UArg;
+typedef intptr_t        IArg;
+
+#ifndef TRUE
+#define TRUE            1
+#define FALSE           0
+#endif
+
+#endif /* __XDC_STD_H */
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""
+Golden-waveform regression suite for the show sequence.
+
+Usage:
+    regress.py                      # run every scenario, compare with golden/
+    regress.py walkup lingering     # just these scenarios
+    regress.py --update             # accept the current waveforms as golden
+    regress.py --verbose            # list every cue, not just the ones that moved
+
+Each scenarios/NAME.scn scripts a visitor for werewolf_sim:
+
+    # comment
+    millis 40000                    # length of the run
+    target 2000 4000 40             # START END ms, INCHES away (repeatable)
+    tolerance 5                     # optional: allowed cue shift, ms
+    duty-tolerance 5                # optional: allowed servo duty error, us
+
+The actuator waveform is every change on the output pins that move the
+prop (transistorGatePin, breathingPin, howlingPin, servoPowerPin) and
+every servo duty change; the sensor pins and the blue LED change on every
+ping and are left out. golden/NAME.golden holds the waveform as
+"signal ms value" lines. A run passes when every signal has the same
+number of cues as its golden timeline and each cue is within tolerance in
+time and value. Cues on the show pins are always listed with their timing
+delta, so a change that moves the show shows up as a column of deltas.
+
+Scenarios run in parallel, one werewolf_sim process each.
+"""
+
+import argparse
+import concurrent.futures
+import os
+import subprocess
+import sys
+
+HOST = os.path.dirname(os.path.abspath(__file__))
+SIM = os.path.join(HOST, "werewolf_sim")
+SCENARIOS = os.path.join(HOST, "scenarios")
+GOLDEN = os.path.join(HOST, "golden")
+
+ACTUATOR_PINS = ("transistorGatePin", "breathingPin", "howlingPin", "servoPowerPin")
+DEFAULT_TOLERANCE_MS = 5.0
+DEFAULT_DUTY_TOLERANCE = 5
+
+
+class Scenario:
+    def __init__(self, name):
+        self.name = name
+        self.millis = 60000
+        self.targets = []
+        self.tolerance = DEFAULT_TOLERANCE_MS
+        self.duty_tolerance = DEFAULT_DUTY_TOLERANCE
+        with open(os.path.join(SCENARIOS, name + ".scn")) as f:
+            for number, line in enumerate(f, 1):
+                words = line.split("#", 1)[0].split()
+                if not words:
+                    continue
+                try:
+                    if words[0] == "millis" and len(words) == 2:
+                        self.millis = int(words[1])
+                    elif words[0] == "target" and len(words) == 4:
+                        self.targets.append("%d:%d:%s" % (int(words[1]), int(words[2]), float(words[3])))
+                    elif words[0] == "tolerance" and len(words) == 2:
+                        self.tolerance = float(words[1])
+                    elif words[0] == "duty-tolerance" and len(words) == 2:
+                        self.duty_tolerance = int(words[1])
+                    else:
+                        raise ValueError(line.strip())
+                except ValueError:
+                    raise SystemExit("%s.scn:%d: cannot parse '%s'" % (name, number, line.strip()))
+
+    def command(self):
+        command = [SIM, "--millis", str(self.millis), "--events"]
+        for target in self.targets:
+            command += ["--target", target]
+        return command
+
+
+def actuator_waveform(events_text):
+    """[(signal, ms, value)] from werewolf_sim --events output"""
+    waveform = []
+    for line in events_text.splitlines():
+        ns, kind, name, value = line.split()
+        if (kind == "gpio" and name in ACTUATOR_PINS) or kind == "pwm":
+            waveform.append((name, int(ns) / 1e6, int(value)))
+    return waveform
+
+
+def run(scenario):
+    result = subprocess.run(scenario.command(), stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                            universal_newlines=True)
+    if result.returncode != 0:
+        return None, result.stderr.strip()
+    return actuator_waveform(result.stdout), None
+
+
+def read_golden(name):
+    waveform = []
+    with open(os.path.join(GOLDEN, name + ".golden")) as f:
+        for line in f:
+            words = line.split("#", 1)[0].split()
+            if words:
+                waveform.append((words[0], float(words[1]), int(words[2])))
+    return waveform
+
+
+def write_golden(scenario, waveform):
+    with open(os.path.join(GOLDEN, scenario.name + ".golden"), "w") as f:
+        f.write("# %s - written by regress.py --update\n" % scenario.name)
+        f.write("# signal ms value\n")
+        for name, ms, value in waveform:
+            f.write("%s %.3f %d\n" % (name, ms, value))
+
+
+def by_signal(waveform):
+    signals = {}
+    for name, ms, value in waveform:
+        signals.setdefault(name, []).append((ms, value))
+    return signals
+
+
+def compare(scenario, golden, actual, verbose):
+    """(passed, report lines)"""
+    lines = []
+    passed = True
+    golden_signals = by_signal(golden)
+    actual_signals = by_signal(actual)
+
+    for name in sorted(set(golden_signals) | set(actual_signals)):
+        want = golden_signals.get(name, [])
+        got = actual_signals.get(name, [])
+        is_pin = name in ACTUATOR_PINS
+        worst_shift = 0.0
+        worst_value = 0
+        moved = []
+
+        for index, ((want_ms, want_value), (got_ms, got_value)) in enumerate(zip(want, got)):
+            shift = got_ms - want_ms
+            value_error = abs(got_value - want_value)
+            value_limit = 0 if is_pin else scenario.duty_tolerance
+            ok = abs(shift) <= scenario.tolerance and value_error <= value_limit
+            worst_shift = max(worst_shift, abs(shift))
+            worst_value = max(worst_value, value_error)
+            if not ok:
+                passed = False
+            if is_pin or not ok or verbose:
+                moved.append("    %s cue %d -> %d at %.3f ms (golden %d at %.3f, %+.3f ms)%s" %
+                             (name, index, got_value, got_ms, want_value, want_ms, shift,
+                              "" if ok else "  FAIL"))
+
+        if len(want) != len(got):
+            passed = False
+            longer, label = (want, "missing") if len(want) > len(got) else (got, "extra")
+            for ms, value in longer[min(len(want), len(got)):][:5]:
+                moved.append("    %s %s cue -> %d at %.3f ms  FAIL" % (name, label, value, ms))
+
+        summary = "  %-28s %4d cues, max shift %.3f ms" % (name, len(got), worst_shift)
+        if not is_pin:
+            summary += ", max duty error %d us" % worst_value
+        if len(want) != len(got):
+            summary += ", golden has %d" % len(want)
+        lines.append(summary)
+        lines.extend(moved)
+
+    return passed, lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("scenarios", nargs="*", help="scenario names (default: all)")
+    parser.add_argument("--update", action="store_true", help="rewrite the golden timelines")
+    parser.add_argument("--verbose", action="store_true", help="list every cue")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="parallel runs")
+    args = parser.parse_args()
+
+    if not os.access(SIM, os.X_OK):
+        raise SystemExit("%s not built - run make in %s" % (SIM, HOST))
+
+    names = args.scenarios or sorted(f[:-4] for f in os.listdir(SCENARIOS) if f.endswith(".scn"))
+    scenarios = [Scenario(name) for name in names]
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        results = list(pool.map(run, scenarios))
+
+    failed = []
+    for scenario, (waveform, error) in zip(scenarios, results):
+        if waveform is None:
+            print("%s: werewolf_sim failed\n    %s" % (scenario.name, error))
+            failed.append(scenario.name)
+            continue
+        if args.update:
+            write_golden(scenario, waveform)
+            print("%s: %d cues written" % (scenario.name, len(waveform)))
+            continue
+        if not os.path.exists(os.path.join(GOLDEN, scenario.name + ".golden")):
+            print("%s: no golden timeline - run regress.py --update %s" % (scenario.name, scenario.name))
+            failed.append(scenario.name)
+            continue
+
+        passed, lines = compare(scenario, read_golden(scenario.name), waveform, args.verbose)
+        print("%s: %s" % (scenario.name, "ok" if passed else "FAIL"))
+        for line in lines:
+            print(line)
+        if not passed:
+            failed.append(scenario.name)
+
+    if failed:
+        print("\n%d of %d scenarios failed: %s" % (len(failed), len(scenarios), " ".join(failed)))
+        sys.exit(1)
+    print("\n%d scenarios %s" % (len(scenarios), "updated" if args.update else "passed"))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,283 @@
+/*
+ *  ======== replay.c ========
+ *  Replays pings recorded in the field through the trigger decision
+ *  (detect.h) and reports where the prop would have started its show.
+ *
+ *      werewolf_replay [--min N] [--max N] [--hits N] [--check] [--list]
+ *                      history.csv
+ *
+ *  history.csv is tools/flashlog2csv.py output from a prop built with
+ *  recordRanges on in werewolf.c, so every ping is in the log ("-" reads
+ *  stdin): its echo duration as a Range record, or, when its distance had
+ *  not changed, counted in the RangeRepeat before the next Range. Repeated
+ *  pings are spread evenly between those two Ranges. The thresholds default to
+ *  werewolf.c's; --min, --max and --hits try others on the same pings.
+ *
+ *  No simulated time passes: each ping is one Detect_sample call, and
+ *  after a trigger the pings that a real show would have slept through
+ *  (lengthOfRisingMode ... resetMillis) are skipped. A night of pings
+ *  replays in milliseconds.
+ *
+ *  The recording only has pings the prop actually took, so where the
+ *  original run was in a show and the replay is not, the replay is blind;
+ *  that time is reported, and the hit count starts again after it.
+ *
+ *  Replayed triggers are matched to the log's Trigger records by the ping
+ *  that set them off. --check fails unless they all match, which is what
+ *  an unchanged build replaying its own recording must do. The page still
+ *  in RAM at a reset or read-out is never in the log, so a trigger on the
+ *  last ping of a boot may have lost its Trigger record; it is counted as
+ *  unconfirmed rather than new. --list prints every trigger as
+ *  "boot tick distance status".
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "detect.h"
+#include "werewolfParams.h"
+
+typedef struct Replay_Ping {
+    uint32_t boot;
+    uint32_t tick;
+    uint16_t duration;
+    bool     recorded;      /* the log has a Trigger right after this ping */
+} Replay_Ping;
+
+static Replay_Ping *replayPings;
+static size_t       replayPingCount;
+static size_t       replayPingCapacity;
+static uint32_t     replayBoots;
+
+/*
+ *  ======== replayAdd ========
+ */
+static bool replayAdd(uint32_t boot, uint32_t tick, uint16_t duration)
+{
+    if (replayPingCount == replayPingCapacity) {
+        replayPingCapacity = (replayPingCapacity != 0) ? replayPingCapacity * 2 : 4096;
+        replayPings = realloc(replayPings, replayPingCapacity * sizeof(Replay_Ping));
+        if (replayPings == NULL) {
+            return (false);
+        }
+    }
+    replayPings[replayPingCount].boot = boot;
+    replayPings[replayPingCount].tick = tick;
+    replayPings[replayPingCount].duration = duration;
+    replayPings[replayPingCount].recorded = false;
+    replayPingCount++;
+
+    return (true);
+}
+
+/*
+ *  ======== replayRead ========
+ *  sequence,boot,tick,event,value
+ */
+static bool replayRead(FILE *in)
+{
+    char          line[128];
+    char          event[32];
+    unsigned long sequence;
+    unsigned long boot;
+    unsigned long tick;
+    unsigned long value;
+    unsigned long lastBoot = ~0ul;
+    unsigned long repeats = 0;
+
+    while (fgets(line, sizeof(line), in) != NULL) {
+        if (sscanf(line, "%lu,%lu,%lu,%31[^,],%lu", &sequence, &boot, &tick, event, &value) != 5) {
+            continue;       /* the header line */
+        }
+        if (boot != lastBoot) {
+            lastBoot = boot;
+            replayBoots++;
+            repeats = 0;
+        }
+
+        if (strcmp(event, "RangeRepeat") == 0) {
+            repeats = value;
+        }
+        else if (strcmp(event, "Range") == 0) {
+            if (repeats != 0 && replayPingCount != 0 &&
+                replayPings[replayPingCount - 1].boot == boot) {
+                Replay_Ping   prev = replayPings[replayPingCount - 1];
+                uint32_t      span = (uint32_t)tick - prev.tick;
+                unsigned long i;
+
+                for (i = 1; i <= repeats; i++) {
+                    if (!replayAdd(prev.boot, prev.tick + (uint32_t)((uint64_t)span * i / (repeats + 1)),
+                                   prev.duration)) {
+                        return (false);
+                    }
+                }
+            }
+            repeats = 0;
+            if (!replayAdd((uint32_t)boot, (uint32_t)tick, (uint16_t)value)) {
+                return (false);
+            }
+        }
+        else if (strcmp(event, "Trigger") == 0 && replayPingCount != 0 &&
+                 replayPings[replayPingCount - 1].boot == boot) {
+            replayPings[replayPingCount - 1].recorded = true;
+        }
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== replayUsage ========
+ */
+static void replayUsage(void)
+{
+    fprintf(stderr, "usage: werewolf_replay [--min N] [--max N] [--hits N] [--check] [--list]\n"
+                    "                       history.csv\n");
+    exit(EXIT_FAILURE);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(int argc, char *argv[])
+{
+    Detect_Params params = { minTriggerDistance, maxTriggerDistance, requiredHitCount };
+    Detect_State  detect;
+    Replay_Ping  *ping;
+    const char   *path = NULL;
+    FILE         *in;
+    bool          check = false;
+    bool          list = false;
+    bool          triggered;
+    bool          last;
+    uint32_t      showMillis;
+    uint32_t      gapMillis;
+    uint32_t      lockoutEnd = 0;
+    uint32_t      lastBoot = 0;
+    uint32_t      lastTick = 0;
+    uint64_t      spanMillis = 0;
+    uint64_t      blindMillis = 0;
+    unsigned long matched = 0;
+    unsigned long added = 0;
+    unsigned long lost = 0;
+    unsigned long unconfirmed = 0;
+    clock_t       wallStart;
+    size_t        i;
+    int           arg;
+
+    for (arg = 1; arg < argc; arg++) {
+        const char *value = (arg + 1 < argc) ? argv[arg + 1] : NULL;
+
+        if (strcmp(argv[arg], "--min") == 0 && value != NULL) {
+            params.minDistance = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--max") == 0 && value != NULL) {
+            params.maxDistance = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--hits") == 0 && value != NULL) {
+            params.requiredHits = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--check") == 0) {
+            check = true;
+        }
+        else if (strcmp(argv[arg], "--list") == 0) {
+            list = true;
+        }
+        else if (argv[arg][0] != '-' || strcmp(argv[arg], "-") == 0) {
+            path = argv[arg];
+        }
+        else {
+            replayUsage();
+        }
+    }
+    if (path == NULL) {
+        replayUsage();
+    }
+
+    in = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    if (in == NULL) {
+        fprintf(stderr, "replay: cannot open %s\n", path);
+        return (EXIT_FAILURE);
+    }
+    if (!replayRead(in)) {
+        fprintf(stderr, "replay: out of memory\n");
+        return (EXIT_FAILURE);
+    }
+    if (in != stdin) {
+        fclose(in);
+    }
+    if (replayPingCount == 0) {
+        fprintf(stderr, "replay: no Range records in %s - was recordRanges on?\n", path);
+        return (EXIT_FAILURE);
+    }
+
+    showMillis = WerewolfParams_showMillis();
+    /* longer than this between pings, and pings are missing */
+    gapMillis = 2 * pingIntervalMillis + 100;
+
+    wallStart = clock();
+    Detect_init(&detect, &params);
+    for (i = 0; i < replayPingCount; i++) {
+        ping = &replayPings[i];
+
+        if (i == 0 || ping->boot != lastBoot) {
+            Detect_init(&detect, &params);
+            lockoutEnd = 0;
+        }
+        else {
+            spanMillis += ping->tick - lastTick;
+            if (ping->tick - lastTick > gapMillis && ping->tick > lockoutEnd) {
+                uint32_t from = (lockoutEnd > lastTick) ? lockoutEnd : lastTick;
+
+                if (ping->tick - from > gapMillis) {
+                    blindMillis += ping->tick - from - pingIntervalMillis;
+                    Detect_init(&detect, &params);
+                }
+            }
+        }
+        lastBoot = ping->boot;
+        lastTick = ping->tick;
+
+        triggered = false;
+        if (ping->tick >= lockoutEnd &&
+            Detect_sample(&detect, Detect_distance(ping->duration)) == Detect_Trigger) {
+            triggered = true;
+            lockoutEnd = ping->tick + showMillis;
+        }
+
+        last = (i + 1 == replayPingCount || replayPings[i + 1].boot != ping->boot);
+        if (triggered && ping->recorded) {
+            matched++;
+        }
+        else if (triggered && last) {
+            unconfirmed++;
+        }
+        else if (triggered) {
+            added++;
+        }
+        else if (ping->recorded) {
+            lost++;
+        }
+        if (list && (triggered || ping->recorded)) {
+            printf("%u %u %u %s\n", ping->boot, ping->tick, Detect_distance(ping->duration),
+                   !ping->recorded ? (last ? "unconfirmed" : "new") : triggered ? "same" : "lost");
+        }
+    }
+
+    fprintf(stderr, "replay: %zu pings, %.1f h in %u boots, replayed in %.3f s\n",
+            replayPingCount, spanMillis / 3600000.0, replayBoots,
+            (double)(clock() - wallStart) / CLOCKS_PER_SEC);
+    fprintf(stderr, "replay: min %d max %d hits %d: %lu triggers, %lu as recorded, %lu new, "
+                    "%lu recorded ones lost, %lu unconfirmed, %.1f s blind\n",
+            params.minDistance, params.maxDistance, params.requiredHits,
+            matched + added + unconfirmed, matched, added, lost, unconfirmed, blindMillis / 1000.0);
+
+    return ((check && (added != 0 || lost != 0)) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
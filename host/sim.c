@@ -0,0 +1,935 @@
+/*
+ *  ======== sim.c ========
+ *  Virtual clock, scheduler and the SYS/BIOS and XDC runtime stand-ins -
+ *  see sim.h.
+ *
+ *  Each Task runs on its own host stack as a ucontext coroutine. BIOS_start
+ *  is the scheduler loop: it resumes the chosen task until that task
+ *  blocks, and runs the Idle functions itself when none is ready. Only one
+ *  host thread ever runs, so the Hwi and Task locks just gate the Clock
+ *  tick and preemption.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/System.h>
+#include <xdc/runtime/Timestamp.h>
+#include <xdc/runtime/Types.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "cycles.h"
+#include "sim.h"
+
+#define SIM_HOST_STACK      (256 * 1024)
+#define SIM_STACK_FILL      0xBE
+#define SIM_HOOKSETS        4
+#define SIM_OBSERVERS       8
+
+struct Task_Object {
+    ucontext_t          context;
+    uint8_t            *hostStack;
+    Task_FuncPtr        fxn;
+    UArg                arg0;
+    UArg                arg1;
+    Int                 priority;
+    Task_Mode           mode;
+    uint32_t            wakeTick;       /* while BLOCKED */
+    int64_t             readyOrder;     /* FIFO within a priority */
+    Ptr                 stack;          /* as given in Task_Params */
+    size_t              stackSize;
+    Ptr                 env;
+    Ptr                 hookContext[SIM_HOOKSETS];
+    struct Task_Object *next;
+};
+
+struct Clock_Object {
+    Clock_FuncPtr        fxn;
+    UArg                 arg;
+    UInt32               period;
+    UInt32               timeout;
+    uint32_t             dueTick;
+    bool                 active;
+    struct Clock_Object *next;
+};
+
+typedef struct Sim_Observer {
+    Sim_EventFxn fxn;
+    void        *arg;
+} Sim_Observer;
+
+const UInt32 Clock_tickPeriod = Sim_NS_PER_TICK / 1000;
+
+static Sim_Options          simOptions;
+static uint64_t             simNs;
+static uint32_t             simTick;
+static bool                 simHwiDisabled = true;  /* no ticks until BIOS_start */
+static bool                 simTaskDisabled;
+static bool                 simStopped;
+static bool                 simStarted;
+static bool                 simAborted;
+static BIOS_ThreadType      simThread = BIOS_ThreadType_Main;
+static ucontext_t           simSchedulerContext;
+static struct Task_Object   simIdleTask = { .priority = 0, .mode = Task_Mode_READY };
+static struct Task_Object  *simTasks;
+static struct Task_Object **simTasksTail = &simTasks;
+static struct Task_Object  *simCurrent;
+static int64_t              simReadyOrder;
+static int64_t              simPreemptOrder;
+static struct Clock_Object *simClocks;
+static struct Clock_Object **simClocksTail = &simClocks;
+static Sim_Observer         simObservers[SIM_OBSERVERS];
+static size_t               simObserverCount;
+static Sim_Event           *simEvents;
+static size_t               simEventCount;
+static size_t               simEventCapacity;
+static uint64_t             simRandomState;
+
+/*
+ *  ======== simReady ========
+ */
+static void simReady(struct Task_Object *task)
+{
+    task->mode = Task_Mode_READY;
+    task->readyOrder = ++simReadyOrder;
+}
+
+/*
+ *  ======== simPickReady ========
+ *  Highest priority, then longest waiting
+ */
+static struct Task_Object *simPickReady(void)
+{
+    struct Task_Object *task;
+    struct Task_Object *best = NULL;
+
+    for (task = simTasks; task != NULL; task = task->next) {
+        if (task->mode == Task_Mode_READY &&
+            (best == NULL || task->priority > best->priority ||
+             (task->priority == best->priority && task->readyOrder < best->readyOrder))) {
+            best = task;
+        }
+    }
+
+    return (best);
+}
+
+/*
+ *  ======== simSwitchHooks ========
+ */
+static void simSwitchHooks(struct Task_Object *prev, struct Task_Object *next)
+{
+    size_t id;
+
+    for (id = 0; id < simHookSetCount; id++) {
+        if (simHookSets[id].switchFxn != NULL) {
+            simHookSets[id].switchFxn(prev, next);
+        }
+    }
+}
+
+/*
+ *  ======== simTickOnce ========
+ *  One Clock tick: due Clock functions in Swi context, then due sleepers
+ */
+static void simTickOnce(void)
+{
+    BIOS_ThreadType     thread = simThread;
+    struct Clock_Object *clock;
+    struct Task_Object  *task;
+
+    simTick++;
+
+    simThread = BIOS_ThreadType_Swi;
+    for (clock = simClocks; clock != NULL; clock = clock->next) {
+        if (clock->active && clock->dueTick == simTick) {
+            if (clock->period != 0) {
+                clock->dueTick += clock->period;
+            }
+            else {
+                clock->active = false;
+            }
+            clock->fxn(clock->arg);
+        }
+    }
+    simThread = thread;
+
+    for (task = simTasks; task != NULL; task = task->next) {
+        if (task->mode == Task_Mode_BLOCKED && task->wakeTick == simTick) {
+            simReady(task);
+        }
+    }
+}
+
+/*
+ *  ======== simNextTickNs ========
+ */
+static inline uint64_t simNextTickNs(void)
+{
+    return ((uint64_t)(simTick + 1) * Sim_NS_PER_TICK);
+}
+
+/*
+ *  ======== simCatchUp ========
+ *  Run the ticks that fell due while interrupts were masked
+ */
+static void simCatchUp(void)
+{
+    while (!simHwiDisabled && simNs >= simNextTickNs()) {
+        simTickOnce();
+    }
+}
+
+/*
+ *  ======== simSwitchOut ========
+ *  Back to the scheduler; returns when this task is resumed
+ */
+static void simSwitchOut(void)
+{
+    swapcontext(&simCurrent->context, &simSchedulerContext);
+}
+
+/*
+ *  ======== simPreempt ========
+ *  A higher-priority task made ready by a tick runs as soon as the
+ *  running task can be switched out
+ */
+static void simPreempt(void)
+{
+    struct Task_Object *ready;
+
+    if (simThread != BIOS_ThreadType_Task || simCurrent == NULL || simCurrent == &simIdleTask ||
+        simTaskDisabled || simHwiDisabled) {
+        return;
+    }
+
+    ready = simPickReady();
+    if (ready != NULL && ready->priority > simCurrent->priority) {
+        simCurrent->mode = Task_Mode_READY;
+        simCurrent->readyOrder = --simPreemptOrder;     /* resumes ahead of its peers */
+        simSwitchOut();
+    }
+}
+
+/*
+ *  ======== simTaskEntry ========
+ */
+static void simTaskEntry(void)
+{
+    struct Task_Object *task = simCurrent;
+
+    task->fxn(task->arg0, task->arg1);
+
+    task->mode = Task_Mode_TERMINATED;
+    setcontext(&simSchedulerContext);
+}
+
+/*
+ *  ======== simTaskContext ========
+ *  Kept out of Task_create - getcontext returns twice
+ */
+static void simTaskContext(struct Task_Object *task)
+{
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp = task->hostStack;
+    task->context.uc_stack.ss_size = SIM_HOST_STACK;
+    task->context.uc_link = &simSchedulerContext;
+    makecontext(&task->context, simTaskEntry, 0);
+}
+
+/*
+ *  ======== simNextDueNs ========
+ *  Virtual time of the next tick with work, or UINT64_MAX
+ */
+static uint64_t simNextDueNs(void)
+{
+    struct Clock_Object *clock;
+    struct Task_Object  *task;
+    uint32_t             ahead = UINT32_MAX;
+
+    for (clock = simClocks; clock != NULL; clock = clock->next) {
+        if (clock->active && clock->dueTick - simTick - 1 < ahead) {
+            ahead = clock->dueTick - simTick - 1;
+        }
+    }
+    for (task = simTasks; task != NULL; task = task->next) {
+        if (task->mode == Task_Mode_BLOCKED && task->wakeTick - simTick - 1 < ahead) {
+            ahead = task->wakeTick - simTick - 1;
+        }
+    }
+
+    return ((ahead == UINT32_MAX) ? UINT64_MAX : simNextTickNs() + (uint64_t)ahead * Sim_NS_PER_TICK);
+}
+
+/*
+ *  ======== Sim_Options_init ========
+ */
+void Sim_Options_init(Sim_Options *options)
+{
+    memset(options, 0, sizeof(*options));
+    options->runNs = 60ull * 1000000000ull;
+    options->gpioReadNs = 1000;
+    options->record = true;
+    options->faults.stuckEchoNs = 1000000000ull;
+    options->faults.seed = 1;
+}
+
+/*
+ *  ======== Sim_init ========
+ */
+void Sim_init(const Sim_Options *options)
+{
+    size_t id;
+
+    simOptions = *options;
+    simNs = 0;
+    simTick = 0;
+    simRandomState = (options->faults.seed + 1) * 0x9E3779B97F4A7C15ull;
+
+    for (id = 0; id < simHookSetCount; id++) {
+        if (simHookSets[id].registerFxn != NULL) {
+            simHookSets[id].registerFxn((Int)id);
+        }
+    }
+
+    SimBoard_reset();
+}
+
+/*
+ *  ======== Sim_options ========
+ */
+const Sim_Options *Sim_options(void)
+{
+    return (&simOptions);
+}
+
+/*
+ *  ======== Sim_now ========
+ */
+uint64_t Sim_now(void)
+{
+    return (simNs);
+}
+
+/*
+ *  ======== Sim_advance ========
+ *  Sensor edges and Clock ticks inside the span happen at their own times
+ */
+void Sim_advance(uint64_t ns)
+{
+    uint64_t end = simNs + ns;
+    uint64_t tickNs;
+    uint64_t edgeNs;
+    bool     ticked = false;
+
+    for (;;) {
+        tickNs = simHwiDisabled ? UINT64_MAX : simNextTickNs();
+        edgeNs = SimBoard_nextEdge();
+        if (end < tickNs && end < edgeNs) {
+            break;
+        }
+        if (edgeNs <= tickNs) {
+            simNs = edgeNs;
+            SimBoard_edge();
+        }
+        else {
+            simNs = tickNs;
+            simTickOnce();
+            ticked = true;
+        }
+    }
+    simNs = end;
+
+    /* only a tick can make a task ready */
+    if (ticked) {
+        simPreempt();
+    }
+}
+
+/*
+ *  ======== Sim_stop ========
+ */
+void Sim_stop(void)
+{
+    simStopped = true;
+}
+
+/*
+ *  ======== Sim_aborted ========
+ */
+bool Sim_aborted(void)
+{
+    return (simAborted);
+}
+
+/*
+ *  ======== Sim_started ========
+ */
+bool Sim_started(void)
+{
+    return (simStarted);
+}
+
+/*
+ *  ======== Sim_addObserver ========
+ */
+void Sim_addObserver(Sim_EventFxn fxn, void *arg)
+{
+    if (simObserverCount < SIM_OBSERVERS) {
+        simObservers[simObserverCount].fxn = fxn;
+        simObservers[simObserverCount].arg = arg;
+        simObserverCount++;
+    }
+}
+
+/*
+ *  ======== Sim_events ========
+ */
+const Sim_Event *Sim_events(size_t *count)
+{
+    *count = simEventCount;
+
+    return (simEvents);
+}
+
+/*
+ *  ======== Sim_random ========
+ */
+double Sim_random(void)
+{
+    return (Sim_randomFrom(&simRandomState));
+}
+
+/*
+ *  ======== Sim_randomFrom ========
+ *  xorshift64* - the same seed gives the same draws everywhere
+ */
+double Sim_randomFrom(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+
+    return ((double)((*state * 0x2545F4914F6CDD1Dull) >> 11) / (double)(1ull << 53));
+}
+
+/*
+ *  ======== Sim_record ========
+ */
+void Sim_record(Sim_EventKind kind, unsigned int index, uint32_t value)
+{
+    Sim_Event event = {
+        .ns    = simNs,
+        .kind  = (uint8_t)kind,
+        .index = (uint8_t)index,
+        .value = value,
+    };
+    size_t observer;
+
+    if (simOptions.record) {
+        if (simEventCount == simEventCapacity) {
+            simEventCapacity = (simEventCapacity != 0) ? simEventCapacity * 2 : 4096;
+            simEvents = Sim_alloc("sim", simEvents, simEventCapacity * sizeof(Sim_Event));
+        }
+        simEvents[simEventCount++] = event;
+    }
+
+    for (observer = 0; observer < simObserverCount; observer++) {
+        simObservers[observer].fxn(&event, simObservers[observer].arg);
+    }
+}
+
+/*
+ *  ======== Sim_fail ========
+ */
+void Sim_fail(const char *tool, const char *message, const char *detail)
+{
+    fprintf(stderr, "%s: %s%s%s\n", tool, message, (detail != NULL) ? " " : "", (detail != NULL) ? detail : "");
+    exit(EXIT_FAILURE);
+}
+
+/*
+ *  ======== Sim_alloc ========
+ */
+void *Sim_alloc(const char *tool, void *old, size_t size)
+{
+    void *p = realloc(old, (size != 0) ? size : 1);
+
+    if (p == NULL) {
+        Sim_fail(tool, "out of memory", NULL);
+    }
+
+    return (p);
+}
+
+/*
+ *  ======== Cycles_init ========
+ */
+void Cycles_init(void)
+{
+}
+
+/*
+ *  ======== Cycles_get ========
+ */
+uint32_t Cycles_get(void)
+{
+    return ((uint32_t)(simNs * (Sim_CPU_HZ / 1000000u) / 1000u));
+}
+
+/*
+ *  ======== Timestamp_get32 ========
+ */
+Bits32 Timestamp_get32(void)
+{
+    return (Cycles_get());
+}
+
+/*
+ *  ======== Timestamp_getFreq ========
+ */
+Void Timestamp_getFreq(Types_FreqHz *freq)
+{
+    freq->hi = 0;
+    freq->lo = Sim_CPU_HZ;
+}
+
+/*
+ *  ======== System_printf ========
+ */
+Int System_printf(CString fmt, ...)
+{
+    va_list args;
+    Int     written = 0;
+
+    if (simOptions.console) {
+        va_start(args, fmt);
+        written = vprintf(fmt, args);
+        va_end(args);
+    }
+
+    return (written);
+}
+
+/*
+ *  ======== System_flush ========
+ */
+Void System_flush(void)
+{
+    if (simOptions.console) {
+        fflush(stdout);
+    }
+}
+
+/*
+ *  ======== System_abort ========
+ *  Same path as SysMin: print, then System.abortFxn
+ */
+Void System_abort(CString str)
+{
+    fprintf(stderr, "sim: System_abort at %llu ns: %s\n", (unsigned long long)simNs, str);
+
+    if (simAbortFxn != NULL) {
+        simAbortFxn();
+    }
+    System_abortStd();
+}
+
+/*
+ *  ======== System_abortStd ========
+ *  Ends the run. A task is terminated and the scheduler winds down; from
+ *  main, a Clock function or Idle there is nothing to unwind to.
+ */
+Void System_abortStd(void)
+{
+    simAborted = true;
+    simStopped = true;
+
+    if (simThread == BIOS_ThreadType_Task && simCurrent != NULL && simCurrent != &simIdleTask) {
+        simCurrent->mode = Task_Mode_TERMINATED;
+        setcontext(&simSchedulerContext);
+    }
+
+    fflush(stdout);
+    exit(EXIT_FAILURE);
+}
+
+/*
+ *  ======== BIOS_getThreadType ========
+ */
+BIOS_ThreadType BIOS_getThreadType(void)
+{
+    return (simThread);
+}
+
+/*
+ *  ======== BIOS_start ========
+ *  The scheduler; returns when the run is over
+ */
+Void BIOS_start(void)
+{
+    struct Task_Object *task;
+    uint64_t            dueNs;
+    size_t              idle;
+
+    simHwiDisabled = false;
+    simThread = BIOS_ThreadType_Task;
+    simStarted = true;
+
+    while (!simStopped && simNs < simOptions.runNs) {
+        task = simPickReady();
+        if (task != NULL) {
+            if (task != simCurrent) {
+                simSwitchHooks(simCurrent, task);
+                simCurrent = task;
+            }
+            task->mode = Task_Mode_RUNNING;
+            swapcontext(&simSchedulerContext, &task->context);
+            continue;
+        }
+
+        /* every task is blocked */
+        if (simCurrent != &simIdleTask) {
+            simSwitchHooks(simCurrent, &simIdleTask);
+            simCurrent = &simIdleTask;
+        }
+        for (idle = 0; idle < simIdleFxnCount; idle++) {
+            simIdleFxns[idle]();
+        }
+        if (simPickReady() != NULL) {
+            continue;
+        }
+
+        dueNs = simNextDueNs();
+        if (dueNs >= simOptions.runNs) {
+            break;
+        }
+        Sim_advance(dueNs - simNs);
+    }
+
+    if (simNs < simOptions.runNs && !simStopped) {
+        Sim_advance(simOptions.runNs - simNs);   /* nothing left to happen */
+    }
+    simThread = BIOS_ThreadType_Main;
+}
+
+/*
+ *  ======== Hwi_disable ========
+ */
+UInt Hwi_disable(void)
+{
+    UInt key = simHwiDisabled;
+
+    simHwiDisabled = true;
+
+    return (key);
+}
+
+/*
+ *  ======== Hwi_restore ========
+ */
+Void Hwi_restore(UInt key)
+{
+    simHwiDisabled = (key != 0);
+    if (!simHwiDisabled && simThread != BIOS_ThreadType_Main) {
+        simCatchUp();
+        simPreempt();
+    }
+}
+
+/*
+ *  ======== Clock_getTicks ========
+ */
+UInt32 Clock_getTicks(void)
+{
+    return (simTick);
+}
+
+/*
+ *  ======== Clock_Params_init ========
+ */
+Void Clock_Params_init(Clock_Params *params)
+{
+    params->startFlag = FALSE;
+    params->period = 0;
+    params->arg = 0;
+}
+
+/*
+ *  ======== Clock_create ========
+ */
+Clock_Handle Clock_create(Clock_FuncPtr fxn, UInt timeout, const Clock_Params *params, Ptr eb)
+{
+    struct Clock_Object *clock = calloc(1, sizeof(*clock));
+    Clock_Params         defaults;
+
+    if (clock == NULL) {
+        return (NULL);
+    }
+    if (params == NULL) {
+        Clock_Params_init(&defaults);
+        params = &defaults;
+    }
+
+    clock->fxn = fxn;
+    clock->arg = params->arg;
+    clock->period = params->period;
+    clock->timeout = timeout;
+    *simClocksTail = clock;
+    simClocksTail = &clock->next;
+
+    if (params->startFlag) {
+        Clock_start(clock);
+    }
+
+    return (clock);
+}
+
+/*
+ *  ======== Clock_construct ========
+ */
+Void Clock_construct(Clock_Struct *obj, Clock_FuncPtr fxn, UInt timeout, const Clock_Params *params)
+{
+    obj->object = Clock_create(fxn, timeout, params, NULL);
+    if (obj->object == NULL) {
+        System_abort("Clock_construct: out of memory");
+    }
+}
+
+/*
+ *  ======== Clock_handle ========
+ */
+Clock_Handle Clock_handle(Clock_Struct *obj)
+{
+    return (obj->object);
+}
+
+/*
+ *  ======== Clock_start ========
+ */
+Void Clock_start(Clock_Handle handle)
+{
+    handle->dueTick = simTick + ((handle->timeout != 0) ? handle->timeout : 1);
+    handle->active = true;
+}
+
+/*
+ *  ======== Clock_stop ========
+ */
+Void Clock_stop(Clock_Handle handle)
+{
+    handle->active = false;
+}
+
+/*
+ *  ======== Clock_setPeriod ========
+ */
+Void Clock_setPeriod(Clock_Handle handle, UInt32 period)
+{
+    handle->period = period;
+}
+
+/*
+ *  ======== Clock_setTimeout ========
+ */
+Void Clock_setTimeout(Clock_Handle handle, UInt32 timeout)
+{
+    handle->timeout = timeout;
+}
+
+/*
+ *  ======== Task_Params_init ========
+ */
+Void Task_Params_init(Task_Params *params)
+{
+    memset(params, 0, sizeof(*params));
+    params->priority = 1;
+    params->stackSize = 1024;
+}
+
+/*
+ *  ======== Task_create ========
+ */
+Task_Handle Task_create(Task_FuncPtr fxn, const Task_Params *params, Ptr eb)
+{
+    struct Task_Object *task = calloc(1, sizeof(*task));
+    Task_Params         defaults;
+
+    if (params == NULL) {
+        Task_Params_init(&defaults);
+        params = &defaults;
+    }
+    if (task == NULL || (task->hostStack = malloc(SIM_HOST_STACK)) == NULL) {
+        free(task);
+        return (NULL);
+    }
+    memset(task->hostStack, SIM_STACK_FILL, SIM_HOST_STACK);
+
+    task->fxn = fxn;
+    task->arg0 = params->arg0;
+    task->arg1 = params->arg1;
+    task->priority = params->priority;
+    task->stack = params->stack;
+    task->stackSize = params->stackSize;
+    task->env = params->env;
+
+    simTaskContext(task);
+
+    *simTasksTail = task;
+    simTasksTail = &task->next;
+
+    if (task->priority < 0) {
+        task->mode = Task_Mode_INACTIVE;
+    }
+    else {
+        simReady(task);
+        simPreempt();
+    }
+
+    return (task);
+}
+
+/*
+ *  ======== Task_construct ========
+ */
+Void Task_construct(Task_Struct *obj, Task_FuncPtr fxn, const Task_Params *params, Ptr eb)
+{
+    obj->object = Task_create(fxn, params, eb);
+    if (obj->object == NULL) {
+        System_abort("Task_construct: out of memory");
+    }
+}
+
+/*
+ *  ======== Task_handle ========
+ */
+Task_Handle Task_handle(Task_Struct *obj)
+{
+    return (obj->object);
+}
+
+/*
+ *  ======== Task_sleep ========
+ */
+Void Task_sleep(UInt32 nticks)
+{
+    if (nticks == 0 || simThread != BIOS_ThreadType_Task || simCurrent == &simIdleTask) {
+        return;
+    }
+
+    simCurrent->mode = Task_Mode_BLOCKED;
+    simCurrent->wakeTick = simTick + nticks;
+    simSwitchOut();
+
+    /* woken, but something else held the CPU for a while */
+    if (simOptions.faults.wakeupJitterNs != 0) {
+        Sim_advance((uint64_t)(Sim_random() * simOptions.faults.wakeupJitterNs));
+    }
+}
+
+/*
+ *  ======== Task_yield ========
+ */
+Void Task_yield(void)
+{
+    if (simThread != BIOS_ThreadType_Task || simCurrent == &simIdleTask) {
+        return;
+    }
+
+    simReady(simCurrent);
+    simSwitchOut();
+}
+
+/*
+ *  ======== Task_self ========
+ */
+Task_Handle Task_self(void)
+{
+    return (simCurrent);
+}
+
+/*
+ *  ======== Task_getIdleTask ========
+ */
+Task_Handle Task_getIdleTask(void)
+{
+    return (&simIdleTask);
+}
+
+/*
+ *  ======== Task_stat ========
+ *  Stack use is measured on the host stack, so it says how deep the code
+ *  went rather than what it would take on the M4; capped at the size the
+ *  app asked for.
+ */
+Void Task_stat(Task_Handle handle, Task_Stat *stat)
+{
+    size_t untouched = 0;
+
+    if (handle->hostStack != NULL) {
+        while (untouched < SIM_HOST_STACK && handle->hostStack[untouched] == SIM_STACK_FILL) {
+            untouched++;
+        }
+    }
+    else {
+        untouched = SIM_HOST_STACK;
+    }
+
+    stat->priority = handle->priority;
+    stat->stack = handle->stack;
+    stat->stackSize = handle->stackSize;
+    stat->mode = (handle == simCurrent) ? Task_Mode_RUNNING : handle->mode;
+    stat->env = handle->env;
+    stat->used = SIM_HOST_STACK - untouched;
+    if (stat->used > stat->stackSize) {
+        stat->used = stat->stackSize;
+    }
+}
+
+/*
+ *  ======== Task_disable ========
+ */
+UInt Task_disable(void)
+{
+    UInt key = simTaskDisabled;
+
+    simTaskDisabled = true;
+
+    return (key);
+}
+
+/*
+ *  ======== Task_restore ========
+ */
+Void Task_restore(UInt key)
+{
+    simTaskDisabled = (key != 0);
+    simPreempt();
+}
+
+/*
+ *  ======== Task_getHookContext ========
+ */
+Ptr Task_getHookContext(Task_Handle handle, Int id)
+{
+    return ((id >= 0 && id < SIM_HOOKSETS) ? handle->hookContext[id] : NULL);
+}
+
+/*
+ *  ======== Task_setHookContext ========
+ */
+Void Task_setHookContext(Task_Handle handle, Int id, Ptr context)
+{
+    if (id >= 0 && id < SIM_HOOKSETS) {
+        handle->hookContext[id] = context;
+    }
+}
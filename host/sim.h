@@ -0,0 +1,244 @@
+/*
+ *  ======== sim.h ========
+ *  Host simulation of the werewolf board: the unmodified app (werewolf.c
+ *  and its modules) runs on Linux against stand-ins for SYS/BIOS and the
+ *  TI-RTOS GPIO and PWM drivers (host/include), on a deterministic virtual
+ *  clock.
+ *
+ *  Virtual time only moves when the app spends it: Task_sleep, or the
+ *  fixed cost of each GPIO_read (the echo polling loop in pulseDuration is
+ *  what measures distance, so its poll rate is the simulated clock rate).
+ *  When every task is blocked the Idle functions run once and time jumps
+ *  straight to the next Clock tick that has something due, so the prop
+ *  runs about a thousand times faster than real time. Runs with the same
+ *  options and sensor model produce the same events, bit for bit.
+ *
+ *  Every GPIO level change and PWM duty change is recorded as a Sim_Event
+ *  with its virtual time. Events are kept in memory when
+ *  Sim_Options.record is set, and are handed to any observers as they
+ *  happen.
+ *
+ *  Sim_Options.faults makes the board misbehave the way the real one
+ *  does - lost, stuck and phantom echoes, late wakeups, a PWM that will
+ *  not open. Fault draws come from a generator seeded by the options, so
+ *  a faulty run repeats exactly too.
+ *
+ *  Scheduling follows SYS/BIOS: the highest-priority ready task runs, equal
+ *  priorities round-robin only when the running task blocks, Clock
+ *  functions run at their tick ahead of any task, and task switch hooks
+ *  and Idle functions are called as configured in simConfig.c (the host
+ *  copy of pwmled.cfg).
+ */
+
+#ifndef __SIM_H
+#define __SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Task.h>
+
+/* the werewolf's CPU clock - Cycles_get and Timestamp_get32 count this */
+#define Sim_CPU_HZ          80000000u
+
+#define Sim_NS_PER_TICK     1000000u    /* Clock.tickPeriod = 1000 us */
+
+/* ultrasonic sensor timings (HC-SR04) */
+#define Sim_ECHO_DELAY_NS   450000u     /* trigger falling edge to echo rising */
+#define Sim_ECHO_NS_PER_INCH 148000u    /* round trip, 74 us each way */
+#define Sim_ECHO_NONE_NS    38000000u   /* echo width when nothing is in range */
+
+/*!
+ *  @def    Sim_EventKind
+ */
+typedef enum Sim_EventKind {
+    Sim_GpioEvent = 0,      /* index: GPIO index, value: new level */
+    Sim_PwmOpenEvent,       /* index: PWM index, value: period (us) */
+    Sim_PwmDutyEvent,       /* index: PWM index, value: duty (us) */
+
+    Sim_EVENTKINDS
+} Sim_EventKind;
+
+/*!
+ *  @def    Sim_Event
+ */
+typedef struct Sim_Event {
+    uint64_t ns;            /* virtual time since reset */
+    uint8_t  kind;          /* Sim_EventKind */
+    uint8_t  index;
+    uint32_t value;
+} Sim_Event;
+
+typedef void (*Sim_EventFxn)(const Sim_Event *event, void *arg);
+
+/*!
+ *  @brief  Sensor model - distance to the nearest target at a time
+ *
+ *  @return inches, or a negative value when nothing is in range
+ */
+typedef double (*Sim_RangeFxn)(uint64_t ns, void *arg);
+
+/*!
+ *  @def    Sim_Faults
+ *  @brief  Hardware faults to inject; all zero is a perfect board
+ *
+ *  Echo probabilities apply per ping (trigger falling edge), in this
+ *  order: a missing echo, else a spurious one when nothing is in range,
+ *  else a stuck one.
+ */
+typedef struct Sim_Faults {
+    double   missingEcho;   /* the echo pin never rises, pulseDuration times out */
+    double   spuriousEcho;  /* nothing in range, but an echo from 2..150 inches */
+    double   stuckEcho;     /* the echo rises and stays high for stuckEchoNs */
+    uint64_t stuckEchoNs;
+    uint64_t wakeupJitterNs; /* every Task_sleep wakes up late by 0..this, uniform */
+    uint32_t pwmOpenFail;   /* bit per PWM index - PWM_open returns NULL */
+    uint64_t seed;
+} Sim_Faults;
+
+/*!
+ *  @def    Sim_Options
+ */
+typedef struct Sim_Options {
+    uint64_t     runNs;         /* BIOS_start returns after this much virtual time */
+    uint32_t     gpioReadNs;    /* virtual time per GPIO_read */
+    bool         console;       /* System_printf to stdout */
+    bool         uartPty;       /* open the trace link on a pseudo-terminal */
+    bool         record;        /* keep every event for Sim_events() */
+    Sim_RangeFxn range;         /* NULL: nothing ever in range */
+    void        *rangeArg;
+    const char  *eepromPath;    /* crash snapshot file, NULL to keep it in RAM */
+    const char  *flashPath;     /* FlashLog region image, NULL to keep it in RAM */
+    Sim_Faults   faults;
+} Sim_Options;
+
+/*!
+ *  @def    Sim_HookSet
+ *  @brief  One Task.addHookSet() entry
+ */
+typedef struct Sim_HookSet {
+    Void (*registerFxn)(Int id);
+    Void (*switchFxn)(Task_Handle prev, Task_Handle next);
+} Sim_HookSet;
+
+typedef Void (*Sim_IdleFxn)(void);
+
+/*
+ * Configuration - simConfig.c, the host copy of pwmled.cfg
+ */
+extern const Sim_HookSet simHookSets[];
+extern const size_t      simHookSetCount;
+extern const Sim_IdleFxn simIdleFxns[];
+extern const size_t      simIdleFxnCount;
+extern Void (*const simAbortFxn)(void);
+
+/*!
+ *  @brief  Defaults: 60 s run, 1 us per GPIO_read, quiet, recording, no
+ *          faults (a stuck echo lasts 1 s when enabled)
+ */
+extern void Sim_Options_init(Sim_Options *options);
+
+/*!
+ *  @brief  Reset virtual time and the board; call before the app's main
+ */
+extern void Sim_init(const Sim_Options *options);
+
+/*!
+ *  @brief  The options Sim_init was given
+ */
+extern const Sim_Options *Sim_options(void);
+
+/*!
+ *  @brief  Virtual time since Sim_init
+ */
+extern uint64_t Sim_now(void);
+
+/*!
+ *  @brief  Spend virtual time in the current thread, running any Clock
+ *          ticks that fall due
+ */
+extern void Sim_advance(uint64_t ns);
+
+/*!
+ *  @brief  End the run; BIOS_start returns once the current thread yields
+ */
+extern void Sim_stop(void);
+
+/*!
+ *  @brief  True if the app called System_abort
+ */
+extern bool Sim_aborted(void);
+
+/*!
+ *  @brief  True once BIOS_start runs; events before it are the initial
+ *          levels (GPIO_init), not anything the app did
+ */
+extern bool Sim_started(void);
+
+/*!
+ *  @brief  Call fxn for every event from now on
+ */
+extern void Sim_addObserver(Sim_EventFxn fxn, void *arg);
+
+/*!
+ *  @brief  Events recorded so far (Sim_Options.record)
+ */
+extern const Sim_Event *Sim_events(size_t *count);
+
+/*!
+ *  @brief  Next fault draw, uniform in [0, 1)
+ */
+extern double Sim_random(void);
+
+/*!
+ *  @brief  The same generator (xorshift64*) on a stream of the caller's,
+ *          for the host tools that seed their own
+ */
+extern double Sim_randomFrom(uint64_t *state);
+
+/*!
+ *  @brief  Stamp and publish an event; used by the board layer
+ */
+extern void Sim_record(Sim_EventKind kind, unsigned int index, uint32_t value);
+
+/*
+ * Board - simBoard.c
+ */
+
+extern void        SimBoard_reset(void);
+extern int         SimBoard_gpioLevel(unsigned int index);
+extern uint32_t    SimBoard_pwmDuty(unsigned int index);
+extern const char *SimBoard_gpioName(unsigned int index);
+extern const char *SimBoard_pwmName(unsigned int index);
+extern int         SimBoard_gpioIndex(const char *name);
+extern int         SimBoard_pwmIndex(const char *name);
+
+/* virtual time of the next sensor-driven pin change, or UINT64_MAX */
+extern uint64_t    SimBoard_nextEdge(void);
+extern void        SimBoard_edge(void);
+
+/*
+ * Host tools - shared by the programs around the simulation
+ */
+
+/*!
+ *  @brief  Print "tool: message detail" to stderr and exit
+ */
+extern void Sim_fail(const char *tool, const char *message, const char *detail);
+
+/*!
+ *  @brief  realloc that fails the tool when memory runs out
+ */
+extern void *Sim_alloc(const char *tool, void *old, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIM_H */
@@ -0,0 +1,400 @@
+/*
+ *  ======== simBoard.c ========
+ *  The EK_TM4C123GXL as the app sees it through Board.h: the board init
+ *  functions, the GPIO and PWM drivers, and an HC-SR04 on the distance
+ *  sensor pins.
+ *
+ *  Pin levels start as gpioPinConfigs[] in EK_TM4C123GXL.c leaves them.
+ *  A falling edge on Dist_Sensor_Trigger starts a measurement: the echo
+ *  pin goes high Sim_ECHO_DELAY_NS later for Sim_ECHO_NS_PER_INCH per inch
+ *  of the range model's distance, or Sim_ECHO_NONE_NS with nothing in
+ *  range. Triggers during a measurement are ignored, as on the part.
+ *  Sim_Options.faults can lose the echo, invent one, or hold it high, and
+ *  can make PWM_open fail for a channel.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <ti/drivers/GPIO.h>
+#include <ti/drivers/PWM.h>
+
+#include "Board.h"
+#include "sim.h"
+
+#define SIMBOARD_NAME(name)     [name] = #name
+
+typedef enum SimBoard_EchoPhase {
+    SimBoard_EchoIdle = 0,
+    SimBoard_EchoWaitRise,
+    SimBoard_EchoHigh
+} SimBoard_EchoPhase;
+
+struct PWM_Config {
+    unsigned int index;
+    bool         open;
+    uint32_t     period;
+    uint32_t     duty;
+};
+
+static const char *const simBoardGpioNames[EK_TM4C123GXL_GPIOCOUNT] = {
+    SIMBOARD_NAME(Dist_Sensor_Echo),
+    SIMBOARD_NAME(Board_LED0),
+    SIMBOARD_NAME(Dist_Sensor_Trigger),
+    SIMBOARD_NAME(transistorGatePin),
+    SIMBOARD_NAME(breathingPin),
+    SIMBOARD_NAME(howlingPin),
+    SIMBOARD_NAME(servoPowerPin),
+};
+
+static const char *const simBoardPwmNames[EK_TM4C123GXL_PWMCOUNT] = {
+    SIMBOARD_NAME(Board_HeadSideToSide_servo),
+    SIMBOARD_NAME(Board_HeadUpDown_servo),
+    SIMBOARD_NAME(Board_MouthOpenClose_servo),
+};
+
+/*
+ * GPIO_CFG_OUT_HIGH in gpioPinConfigs[] (EK_TM4C123GXL.c); the
+ * GPIO_CFG_OUT_LOW next to it on some pins is 0
+ */
+static const uint8_t simBoardGpioInitial[EK_TM4C123GXL_GPIOCOUNT] = {
+    [Dist_Sensor_Trigger] = 1,
+    [breathingPin] = 1,
+    [howlingPin] = 1,
+    [servoPowerPin] = 1,
+};
+
+static uint8_t            simBoardGpio[EK_TM4C123GXL_GPIOCOUNT];
+static struct PWM_Config  simBoardPwm[EK_TM4C123GXL_PWMCOUNT];
+static SimBoard_EchoPhase simBoardEchoPhase;
+static uint64_t           simBoardEchoRise;
+static uint64_t           simBoardEchoFall;
+
+/*
+ *  ======== simBoardSetPin ========
+ */
+static void simBoardSetPin(unsigned int index, unsigned int value)
+{
+    uint8_t level = (value != 0);
+
+    if (simBoardGpio[index] != level) {
+        simBoardGpio[index] = level;
+        Sim_record(Sim_GpioEvent, index, level);
+    }
+}
+
+/*
+ *  ======== simBoardTrigger ========
+ */
+static void simBoardTrigger(void)
+{
+    const Sim_Options *options = Sim_options();
+    const Sim_Faults  *faults = &options->faults;
+    double             inches = -1.0;
+    uint64_t           width;
+
+    if (simBoardEchoPhase != SimBoard_EchoIdle) {
+        return;
+    }
+    if (faults->missingEcho > 0.0 && Sim_random() < faults->missingEcho) {
+        return;
+    }
+    if (options->range != NULL) {
+        inches = options->range(Sim_now(), options->rangeArg);
+    }
+    if (inches < 0.0 && faults->spuriousEcho > 0.0 && Sim_random() < faults->spuriousEcho) {
+        inches = 2.0 + Sim_random() * 148.0;
+    }
+
+    width = (inches < 0.0) ? Sim_ECHO_NONE_NS : (uint64_t)(inches * Sim_ECHO_NS_PER_INCH + 0.5);
+    if (faults->stuckEcho > 0.0 && Sim_random() < faults->stuckEcho) {
+        width = faults->stuckEchoNs;
+    }
+    simBoardEchoRise = Sim_now() + Sim_ECHO_DELAY_NS;
+    simBoardEchoFall = simBoardEchoRise + width;
+    simBoardEchoPhase = SimBoard_EchoWaitRise;
+}
+
+/*
+ *  ======== SimBoard_reset ========
+ */
+void SimBoard_reset(void)
+{
+    unsigned int index;
+
+    memset(simBoardGpio, 0, sizeof(simBoardGpio));
+    for (index = 0; index < EK_TM4C123GXL_PWMCOUNT; index++) {
+        simBoardPwm[index] = (struct PWM_Config){ .index = index };
+    }
+    simBoardEchoPhase = SimBoard_EchoIdle;
+}
+
+/*
+ *  ======== SimBoard_nextEdge ========
+ */
+uint64_t SimBoard_nextEdge(void)
+{
+    switch (simBoardEchoPhase) {
+        case SimBoard_EchoWaitRise:
+            return (simBoardEchoRise);
+        case SimBoard_EchoHigh:
+            return (simBoardEchoFall);
+        default:
+            return (UINT64_MAX);
+    }
+}
+
+/*
+ *  ======== SimBoard_edge ========
+ */
+void SimBoard_edge(void)
+{
+    if (simBoardEchoPhase == SimBoard_EchoWaitRise) {
+        simBoardEchoPhase = SimBoard_EchoHigh;
+        simBoardSetPin(Dist_Sensor_Echo, 1);
+    }
+    else if (simBoardEchoPhase == SimBoard_EchoHigh) {
+        simBoardEchoPhase = SimBoard_EchoIdle;
+        simBoardSetPin(Dist_Sensor_Echo, 0);
+    }
+}
+
+/*
+ *  ======== SimBoard_gpioLevel ========
+ */
+int SimBoard_gpioLevel(unsigned int index)
+{
+    return ((index < EK_TM4C123GXL_GPIOCOUNT) ? simBoardGpio[index] : -1);
+}
+
+/*
+ *  ======== SimBoard_pwmDuty ========
+ */
+uint32_t SimBoard_pwmDuty(unsigned int index)
+{
+    return ((index < EK_TM4C123GXL_PWMCOUNT) ? simBoardPwm[index].duty : 0);
+}
+
+/*
+ *  ======== SimBoard_gpioName ========
+ */
+const char *SimBoard_gpioName(unsigned int index)
+{
+    return ((index < EK_TM4C123GXL_GPIOCOUNT) ? simBoardGpioNames[index] : NULL);
+}
+
+/*
+ *  ======== SimBoard_pwmName ========
+ */
+const char *SimBoard_pwmName(unsigned int index)
+{
+    return ((index < EK_TM4C123GXL_PWMCOUNT) ? simBoardPwmNames[index] : NULL);
+}
+
+/*
+ *  ======== SimBoard_gpioIndex ========
+ */
+int SimBoard_gpioIndex(const char *name)
+{
+    int index;
+
+    for (index = 0; index < EK_TM4C123GXL_GPIOCOUNT; index++) {
+        if (strcmp(simBoardGpioNames[index], name) == 0) {
+            return (index);
+        }
+    }
+
+    return (-1);
+}
+
+/*
+ *  ======== SimBoard_pwmIndex ========
+ */
+int SimBoard_pwmIndex(const char *name)
+{
+    int index;
+
+    for (index = 0; index < EK_TM4C123GXL_PWMCOUNT; index++) {
+        if (strcmp(simBoardPwmNames[index], name) == 0) {
+            return (index);
+        }
+    }
+
+    return (-1);
+}
+
+/*
+ *  ======== GPIO_init ========
+ */
+void GPIO_init(void)
+{
+    unsigned int index;
+
+    for (index = 0; index < EK_TM4C123GXL_GPIOCOUNT; index++) {
+        simBoardSetPin(index, simBoardGpioInitial[index]);
+    }
+}
+
+/*
+ *  ======== GPIO_read ========
+ *  Samples, then spends one poll's worth of virtual time
+ */
+uint_fast8_t GPIO_read(unsigned int index)
+{
+    uint_fast8_t level = (index < EK_TM4C123GXL_GPIOCOUNT) ? simBoardGpio[index] : 0;
+
+    Sim_advance(Sim_options()->gpioReadNs);
+
+    return (level);
+}
+
+/*
+ *  ======== GPIO_write ========
+ */
+void GPIO_write(unsigned int index, unsigned int value)
+{
+    bool falling;
+
+    if (index >= EK_TM4C123GXL_GPIOCOUNT || index == Dist_Sensor_Echo) {
+        return;
+    }
+
+    falling = (simBoardGpio[index] != 0 && value == 0);
+    simBoardSetPin(index, value);
+
+    if (index == Dist_Sensor_Trigger && falling) {
+        simBoardTrigger();
+    }
+}
+
+/*
+ *  ======== GPIO_toggle ========
+ */
+void GPIO_toggle(unsigned int index)
+{
+    if (index < EK_TM4C123GXL_GPIOCOUNT) {
+        GPIO_write(index, !simBoardGpio[index]);
+    }
+}
+
+/*
+ *  ======== PWM_init ========
+ */
+void PWM_init(void)
+{
+}
+
+/*
+ *  ======== PWM_Params_init ========
+ */
+void PWM_Params_init(PWM_Params *params)
+{
+    params->period = 3000;
+    params->dutyMode = PWM_DUTY_TIME;
+    params->polarity = PWM_POL_ACTIVE_HIGH;
+    params->custom = 0;
+}
+
+/*
+ *  ======== PWM_open ========
+ *  NULL if the index is unknown or already open, as on the board, or if
+ *  the faults say this one fails
+ */
+PWM_Handle PWM_open(unsigned int index, PWM_Params *params)
+{
+    struct PWM_Config *pwm;
+
+    if (index >= EK_TM4C123GXL_PWMCOUNT || simBoardPwm[index].open ||
+        (Sim_options()->faults.pwmOpenFail & (1u << index)) != 0) {
+        return (NULL);
+    }
+
+    pwm = &simBoardPwm[index];
+    pwm->open = true;
+    pwm->period = params->period;
+    pwm->duty = 0;
+    Sim_record(Sim_PwmOpenEvent, index, pwm->period);
+
+    return (pwm);
+}
+
+/*
+ *  ======== PWM_close ========
+ */
+void PWM_close(PWM_Handle handle)
+{
+    PWM_setDuty(handle, 0);
+    handle->open = false;
+}
+
+/*
+ *  ======== PWM_setDuty ========
+ */
+void PWM_setDuty(PWM_Handle handle, uint32_t duty)
+{
+    if (handle->duty != duty) {
+        handle->duty = duty;
+        Sim_record(Sim_PwmDutyEvent, handle->index, duty);
+    }
+}
+
+/*
+ *  ======== EK_TM4C123GXL_initGeneral ========
+ */
+void EK_TM4C123GXL_initGeneral(void)
+{
+}
+
+/*
+ *  ======== EK_TM4C123GXL_initGPIO ========
+ */
+void EK_TM4C123GXL_initGPIO(void)
+{
+    GPIO_init();
+}
+
+/*
+ *  ======== EK_TM4C123GXL_initPWM ========
+ */
+void EK_TM4C123GXL_initPWM(void)
+{
+    PWM_init();
+}
+
+/*
+ * Peripherals the app does not use - nothing to set up
+ */
+
+void EK_TM4C123GXL_initDMA(void)
+{
+}
+
+void EK_TM4C123GXL_initI2C(void)
+{
+}
+
+void EK_TM4C123GXL_initSDSPI(void)
+{
+}
+
+void EK_TM4C123GXL_initSPI(void)
+{
+}
+
+void EK_TM4C123GXL_initUART(void)
+{
+}
+
+void EK_TM4C123GXL_initUSB(EK_TM4C123GXL_USBMode usbMode)
+{
+}
+
+void EK_TM4C123GXL_initWatchdog(void)
+{
+}
+
+void EK_TM4C123GXL_initWiFi(void)
+{
+}
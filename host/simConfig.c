@@ -0,0 +1,29 @@
+/*
+ *  ======== simConfig.c ========
+ *  The parts of pwmled.cfg the app relies on at run time - keep the two in
+ *  step.
+ */
+
+#include <stddef.h>
+
+#include <xdc/std.h>
+
+#include "crashLog.h"
+#include "flashLog.h"
+#include "taskMon.h"
+#include "sim.h"
+
+/* Task.addHookSet() */
+const Sim_HookSet simHookSets[] = {
+    { .registerFxn = TaskMon_registerHook, .switchFxn = TaskMon_switchHook },
+};
+const size_t simHookSetCount = sizeof(simHookSets) / sizeof(simHookSets[0]);
+
+/* Idle.addFunc() */
+const Sim_IdleFxn simIdleFxns[] = {
+    FlashLog_idle,
+};
+const size_t simIdleFxnCount = sizeof(simIdleFxns) / sizeof(simIdleFxns[0]);
+
+/* System.abortFxn */
+Void (*const simAbortFxn)(void) = CrashLog_abortHook;
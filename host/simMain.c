@@ -0,0 +1,415 @@
+/*
+ *  ======== simMain.c ========
+ *  Command-line runner for the host build: sets up the simulator, runs the
+ *  app's main (werewolf.c, built with main renamed to werewolf_main) for a
+ *  stretch of virtual time, then reports what the pins did.
+ *
+ *      werewolf_sim [--millis N] [--target START:END:INCHES]... [--events]
+ *                   [--expect NAME=CHANGES]... [--vcd FILE] [--console]
+ *                   [--pty] [--eeprom FILE] [--flash FILE] [--record-ranges]
+ *                   [--missing-echo P] [--spurious-echo P] [--stuck-echo P]
+ *                   [--jitter-us N] [--pwm-fail NAME]... [--seed N]
+ *                   [--solenoid] [--solenoid-param NAME=VALUE]...
+ *                   [--rising-ms N] [--lowering-ms N]
+ *
+ *  --target puts something INCHES away from START to END ms; outside every
+ *  target the sensor sees nothing. --expect checks how many times a GPIO
+ *  (level changes) or PWM (duty changes) named as in Board.h moved, and
+ *  fails the run if it differs. --events prints every recorded event as
+ *  "ns kind name value". --vcd streams the same changes to a waveform file
+ *  (simVcd.h); events are only kept in memory when --events or --expect
+ *  needs them. --record-ranges turns on recordRanges (werewolf.c), so the
+ *  flash log keeps every ping for replay.c.
+ *
+ *  The fault options set Sim_Options.faults: P is a probability per ping,
+ *  --jitter-us the most a Task_sleep wakeup is late, and --pwm-fail makes
+ *  PWM_open fail for a PWM named as in Board.h. --seed picks a different
+ *  but repeatable run of faults.
+ *
+ *  --solenoid models the body lift (simSolenoid.h) and reports how long
+ *  each show took to get the body up and to settle it back down, against
+ *  lengthOfRisingMode and lengthOfLoweringingMode, and the shortest phases
+ *  that would give the body a quarter more time than it took. A show whose body was
+ *  not up by the end of the rising phase, or not at rest by the end of
+ *  the lowering phase, fails the run. --solenoid-param sets a model
+ *  parameter by its SimSolenoid_Params name (and implies --solenoid);
+ *  --rising-ms and --lowering-ms try other phase lengths.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim.h"
+#include "simSolenoid.h"
+#include "simVcd.h"
+
+#define SIMMAIN_TARGETS     64
+#define SIMMAIN_EXPECTS     32
+
+/* the suggested phase lengths: what the body took, times this, rounded up */
+#define SIMMAIN_PHASE_MARGIN    1.25
+#define SIMMAIN_PHASE_ROUND_MS  100
+
+typedef struct SimMain_Target {
+    uint64_t startNs;
+    uint64_t endNs;
+    double   inches;
+} SimMain_Target;
+
+typedef struct SimMain_Expect {
+    const char *name;
+    long        changes;
+} SimMain_Expect;
+
+static SimMain_Target simMainTargets[SIMMAIN_TARGETS];
+static size_t         simMainTargetCount;
+static SimMain_Expect simMainExpects[SIMMAIN_EXPECTS];
+static size_t         simMainExpectCount;
+static size_t         simMainEventTotal;
+
+static const char *const simMainKindNames[Sim_EVENTKINDS] = {
+    [Sim_GpioEvent]    = "gpio",
+    [Sim_PwmOpenEvent] = "pwmOpen",
+    [Sim_PwmDutyEvent] = "pwm",
+};
+
+extern int  werewolf_main(void);
+extern bool recordRanges;
+extern int  lengthOfRisingMode;
+extern int  lengthOfLoweringingMode;
+
+/*
+ *  ======== simMainRange ========
+ */
+static double simMainRange(uint64_t ns, void *arg)
+{
+    size_t target;
+
+    for (target = 0; target < simMainTargetCount; target++) {
+        if (ns >= simMainTargets[target].startNs && ns < simMainTargets[target].endNs) {
+            return (simMainTargets[target].inches);
+        }
+    }
+
+    return (-1.0);
+}
+
+/*
+ *  ======== simMainCount ========
+ *  Sim observer
+ */
+static void simMainCount(const Sim_Event *event, void *arg)
+{
+    simMainEventTotal++;
+}
+
+/*
+ *  ======== simMainEventName ========
+ */
+static const char *simMainEventName(const Sim_Event *event)
+{
+    return ((event->kind == Sim_GpioEvent) ? SimBoard_gpioName(event->index)
+                                           : SimBoard_pwmName(event->index));
+}
+
+/*
+ *  ======== simMainChanges ========
+ *  Level or duty changes of one named pin, -1 if the name is unknown
+ */
+static long simMainChanges(const char *name)
+{
+    const Sim_Event *events;
+    size_t           count;
+    size_t           i;
+    int              gpio = SimBoard_gpioIndex(name);
+    int              pwm = SimBoard_pwmIndex(name);
+    long             changes = 0;
+
+    if (gpio < 0 && pwm < 0) {
+        return (-1);
+    }
+
+    events = Sim_events(&count);
+    for (i = 0; i < count; i++) {
+        if ((events[i].kind == Sim_GpioEvent && events[i].index == gpio) ||
+            (events[i].kind == Sim_PwmDutyEvent && events[i].index == pwm)) {
+            changes++;
+        }
+    }
+
+    return (changes);
+}
+
+/*
+ *  ======== simMainPhase ========
+ *  Shortest phase, in ms, that covers need with the margin to spare
+ */
+static unsigned long simMainPhase(uint64_t needNs)
+{
+    double millis = needNs / 1.0e6 * SIMMAIN_PHASE_MARGIN;
+
+    return ((unsigned long)(millis / SIMMAIN_PHASE_ROUND_MS + 0.999) * SIMMAIN_PHASE_ROUND_MS);
+}
+
+/*
+ *  ======== simMainSolenoid ========
+ *  Report the body lift; false if any show did not fit its phases
+ */
+static bool simMainSolenoid(void)
+{
+    const SimSolenoid_Show *shows;
+    const SimSolenoid_Show *show;
+    uint32_t                count;
+    uint32_t                i;
+    uint64_t                risingNs = (uint64_t)lengthOfRisingMode * 1000000ull;
+    uint64_t                loweringNs = (uint64_t)lengthOfLoweringingMode * 1000000ull;
+    uint64_t                upMax = 0;
+    uint64_t                settledMax = 0;
+    uint32_t                raised = 0;
+    uint32_t                late = 0;
+    bool                    lateUp;
+    bool                    lateDown;
+
+    SimSolenoid_finish();
+    shows = SimSolenoid_shows(&count);
+
+    for (i = 0; i < count; i++) {
+        show = &shows[i];
+
+        SimSolenoid_late(show, risingNs, loweringNs, &lateUp, &lateDown);
+        if (show->upNs != UINT64_MAX) {
+            upMax = (show->upNs > upMax) ? show->upNs : upMax;
+            raised++;
+        }
+        if (show->settledNs != UINT64_MAX && show->settledNs > settledMax) {
+            settledMax = show->settledNs;
+        }
+
+        fprintf(stderr, "sim: solenoid: show %u at %.3f s: ", i + 1, show->gateOnNs / 1.0e9);
+        if (show->upNs != UINT64_MAX) {
+            fprintf(stderr, "up in %.0f ms", show->upNs / 1.0e6);
+        }
+        else {
+            fprintf(stderr, "never up");
+        }
+        if (show->settledNs != UINT64_MAX) {
+            fprintf(stderr, ", settled %.0f ms after the gate went off", show->settledNs / 1.0e6);
+        }
+        else if (show->gateOffNs != UINT64_MAX) {
+            fprintf(stderr, ", never settled");
+        }
+        fprintf(stderr, ", coil %.0f J%s%s%s%s\n", show->coilJoules,
+                lateUp ? ", NOT UP by the end of the rising phase" : "",
+                lateDown ? ", NOT DOWN by the end of the lowering phase" : "",
+                show->loweredEarly ? ", lowered before it was up" : "",
+                show->raisedEarly ? ", raised again before it settled" : "");
+        if (lateUp || lateDown) {
+            late++;
+        }
+    }
+
+    if (count != 0 && raised == 0) {
+        fprintf(stderr, "sim: solenoid: the body never got all the way up\n");
+    }
+    else if (count != 0) {
+        fprintf(stderr, "sim: solenoid: body needs up to %.0f ms to rise and %.0f ms to settle; "
+                        "rising phase %d ms, lowering %d ms; with %.0f%% to spare they could be %lu and %lu ms\n",
+                upMax / 1.0e6, settledMax / 1.0e6, lengthOfRisingMode, lengthOfLoweringingMode,
+                (SIMMAIN_PHASE_MARGIN - 1.0) * 100.0, simMainPhase(upMax), simMainPhase(settledMax));
+    }
+    if (late != 0) {
+        fprintf(stderr, "sim: solenoid: %u of %u shows did not fit their phases\n", late, count);
+    }
+
+    return (late == 0);
+}
+
+/*
+ *  ======== simMainUsage ========
+ */
+static void simMainUsage(void)
+{
+    fprintf(stderr,
+            "usage: werewolf_sim [--millis N] [--target START:END:INCHES]... [--events]\n"
+            "                    [--expect NAME=CHANGES]... [--vcd FILE] [--console]\n"
+            "                    [--pty] [--eeprom FILE] [--flash FILE] [--record-ranges]\n"
+            "                    [--missing-echo P] [--spurious-echo P] [--stuck-echo P]\n"
+            "                    [--jitter-us N] [--pwm-fail NAME]... [--seed N]\n"
+            "                    [--solenoid] [--solenoid-param NAME=VALUE]...\n"
+            "                    [--rising-ms N] [--lowering-ms N]\n");
+    exit(EXIT_FAILURE);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(int argc, char *argv[])
+{
+    Sim_Options        options;
+    SimSolenoid_Params solenoid;
+    SimMain_Target    *target;
+    SimMain_Expect    *expect;
+    const Sim_Event   *events;
+    size_t             count;
+    size_t             i;
+    unsigned long      startMillis;
+    unsigned long      endMillis;
+    char              *equals;
+    const char        *vcdPath = NULL;
+    bool               printEvents = false;
+    bool               modelSolenoid = false;
+    bool               passed = true;
+    long               changes;
+    clock_t            wallStart;
+    double             wallSeconds;
+    int                arg;
+
+    Sim_Options_init(&options);
+    options.range = simMainRange;
+    SimSolenoid_Params_init(&solenoid);
+
+    for (arg = 1; arg < argc; arg++) {
+        const char *value = (arg + 1 < argc) ? argv[arg + 1] : NULL;
+
+        if (strcmp(argv[arg], "--millis") == 0 && value != NULL) {
+            options.runNs = strtoull(value, NULL, 0) * 1000000ull;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--target") == 0 && value != NULL &&
+                 simMainTargetCount < SIMMAIN_TARGETS) {
+            target = &simMainTargets[simMainTargetCount];
+            if (sscanf(value, "%lu:%lu:%lf", &startMillis, &endMillis, &target->inches) != 3) {
+                simMainUsage();
+            }
+            target->startNs = startMillis * 1000000ull;
+            target->endNs = endMillis * 1000000ull;
+            simMainTargetCount++;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--expect") == 0 && value != NULL &&
+                 simMainExpectCount < SIMMAIN_EXPECTS && (equals = strchr(argv[arg + 1], '=')) != NULL) {
+            *equals = '\0';
+            simMainExpects[simMainExpectCount].name = argv[arg + 1];
+            simMainExpects[simMainExpectCount].changes = strtol(equals + 1, NULL, 0);
+            simMainExpectCount++;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--vcd") == 0 && value != NULL) {
+            vcdPath = value;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--eeprom") == 0 && value != NULL) {
+            options.eepromPath = value;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--flash") == 0 && value != NULL) {
+            options.flashPath = value;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--missing-echo") == 0 && value != NULL) {
+            options.faults.missingEcho = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--spurious-echo") == 0 && value != NULL) {
+            options.faults.spuriousEcho = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--stuck-echo") == 0 && value != NULL) {
+            options.faults.stuckEcho = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--jitter-us") == 0 && value != NULL) {
+            options.faults.wakeupJitterNs = strtoull(value, NULL, 0) * 1000ull;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--pwm-fail") == 0 && value != NULL && SimBoard_pwmIndex(value) >= 0) {
+            options.faults.pwmOpenFail |= 1u << SimBoard_pwmIndex(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--seed") == 0 && value != NULL) {
+            options.faults.seed = strtoull(value, NULL, 0);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--solenoid-param") == 0 && value != NULL) {
+            if (!SimSolenoid_setParam(&solenoid, value)) {
+                simMainUsage();
+            }
+            modelSolenoid = true;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--rising-ms") == 0 && value != NULL) {
+            lengthOfRisingMode = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--lowering-ms") == 0 && value != NULL) {
+            lengthOfLoweringingMode = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--solenoid") == 0) {
+            modelSolenoid = true;
+        }
+        else if (strcmp(argv[arg], "--events") == 0) {
+            printEvents = true;
+        }
+        else if (strcmp(argv[arg], "--console") == 0) {
+            options.console = true;
+        }
+        else if (strcmp(argv[arg], "--pty") == 0) {
+            options.uartPty = true;
+        }
+        else if (strcmp(argv[arg], "--record-ranges") == 0) {
+            recordRanges = true;
+        }
+        else {
+            simMainUsage();
+        }
+    }
+
+    options.record = printEvents || simMainExpectCount != 0;
+
+    wallStart = clock();
+    Sim_init(&options);
+    Sim_addObserver(simMainCount, NULL);
+    if (modelSolenoid) {
+        SimSolenoid_attach(&solenoid);
+    }
+    if (vcdPath != NULL && !SimVcd_open(vcdPath)) {
+        fprintf(stderr, "sim: cannot create %s\n", vcdPath);
+        return (EXIT_FAILURE);
+    }
+    werewolf_main();
+    SimVcd_close();
+    wallSeconds = (double)(clock() - wallStart) / CLOCKS_PER_SEC;
+
+    events = Sim_events(&count);
+    if (printEvents) {
+        for (i = 0; i < count; i++) {
+            printf("%llu %s %s %u\n", (unsigned long long)events[i].ns,
+                   simMainKindNames[events[i].kind], simMainEventName(&events[i]), events[i].value);
+        }
+    }
+
+    for (i = 0; i < simMainExpectCount; i++) {
+        expect = &simMainExpects[i];
+        changes = simMainChanges(expect->name);
+        if (changes != expect->changes) {
+            fprintf(stderr, "sim: %s changed %ld times, expected %ld\n",
+                    expect->name, changes, expect->changes);
+            passed = false;
+        }
+    }
+
+    if (modelSolenoid && !simMainSolenoid()) {
+        passed = false;
+    }
+
+    fprintf(stderr, "sim: %llu ms simulated in %.3f s, %zu events%s\n",
+            (unsigned long long)(Sim_now() / 1000000u), wallSeconds, simMainEventTotal,
+            Sim_aborted() ? ", aborted" : "");
+
+    return ((passed && !Sim_aborted()) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,317 @@
+/*
+ *  ======== simSolenoid.c ========
+ *  Solenoid and body-lift model - see simSolenoid.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "simSolenoid.h"
+
+#define SIMSOLENOID_STEP_NS     20000u      /* 50 kHz; the coil time constant is milliseconds */
+#define SIMSOLENOID_GRAVITY     9.81
+#define SIMSOLENOID_REST_MPS    0.001       /* slower than this off the bottom stop, it stays */
+#define SIMSOLENOID_STEADY      1.0e-6      /* of full current: the coil has stopped changing */
+
+typedef struct SimSolenoid_Field {
+    const char *name;
+    size_t      offset;
+} SimSolenoid_Field;
+
+static const SimSolenoid_Field simSolenoidFields[] = {
+    { "massKg",      offsetof(SimSolenoid_Params, massKg) },
+    { "strokeM",     offsetof(SimSolenoid_Params, strokeM) },
+    { "forceN",      offsetof(SimSolenoid_Params, forceN) },
+    { "gapM",        offsetof(SimSolenoid_Params, gapM) },
+    { "supplyV",     offsetof(SimSolenoid_Params, supplyV) },
+    { "coilOhm",     offsetof(SimSolenoid_Params, coilOhm) },
+    { "coilH",       offsetof(SimSolenoid_Params, coilH) },
+    { "clampOhm",    offsetof(SimSolenoid_Params, clampOhm) },
+    { "dampingNs",   offsetof(SimSolenoid_Params, dampingNs) },
+    { "restitution", offsetof(SimSolenoid_Params, restitution) },
+};
+
+static SimSolenoid_Params simSolenoidParams;
+static int                simSolenoidGate = -1;
+static bool               simSolenoidOn;
+static uint64_t           simSolenoidNs;
+static double             simSolenoidX;         /* m above the bottom stop */
+static double             simSolenoidV;         /* m/s, up */
+static double             simSolenoidI;         /* A */
+static bool               simSolenoidResting;   /* on the bottom stop, not moving */
+
+static SimSolenoid_Show  *simSolenoidShows;
+static uint32_t           simSolenoidShowCount;
+static uint32_t           simSolenoidShowCapacity;
+static SimSolenoid_Show  *simSolenoidShow;      /* the latest, NULL before the first */
+
+/*
+ *  ======== SimSolenoid_Params_init ========
+ *  A 30 mm pull solenoid lifting the body through a lever. None of these
+ *  have been measured on the prop; set them from the real parts.
+ */
+void SimSolenoid_Params_init(SimSolenoid_Params *params)
+{
+    params->massKg = 4.0;
+    params->strokeM = 0.030;
+    params->forceN = 60.0;
+    params->gapM = 0.010;
+    params->supplyV = 12.0;
+    params->coilOhm = 6.0;
+    params->coilH = 0.060;
+    params->clampOhm = 0.0;
+    params->dampingNs = 600.0;
+    params->restitution = 0.2;
+}
+
+/*
+ *  ======== SimSolenoid_setParam ========
+ */
+bool SimSolenoid_setParam(SimSolenoid_Params *params, const char *assignment)
+{
+    const char *equals = strchr(assignment, '=');
+    char       *end;
+    double      value;
+    size_t      field;
+
+    if (equals == NULL) {
+        return (false);
+    }
+    value = strtod(equals + 1, &end);
+    if (end == equals + 1 || *end != '\0') {
+        return (false);
+    }
+
+    for (field = 0; field < sizeof(simSolenoidFields) / sizeof(simSolenoidFields[0]); field++) {
+        if (strlen(simSolenoidFields[field].name) == (size_t)(equals - assignment) &&
+            strncmp(simSolenoidFields[field].name, assignment, equals - assignment) == 0) {
+            *(double *)((char *)params + simSolenoidFields[field].offset) = value;
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+/*
+ *  ======== simSolenoidStep ========
+ *  One step of dt seconds at time ns
+ */
+static void simSolenoidStep(uint64_t ns, double dt)
+{
+    const SimSolenoid_Params *p = &simSolenoidParams;
+    double full = p->supplyV / p->coilOhm;
+    double ratio;
+    double gap;
+    double force;
+
+    /* coil: L di/dt = V - R i, or through the clamp once switched off */
+    if (simSolenoidOn) {
+        simSolenoidI += (p->supplyV - p->coilOhm * simSolenoidI) * dt / p->coilH;
+        simSolenoidShow->coilJoules += simSolenoidI * simSolenoidI * p->coilOhm * dt;
+    }
+    else {
+        simSolenoidI -= (p->coilOhm + p->clampOhm) * simSolenoidI * dt / p->coilH;
+    }
+
+    ratio = simSolenoidI / full;
+    gap = p->strokeM - simSolenoidX + p->gapM;
+    force = p->forceN * ratio * ratio * ((p->strokeM + p->gapM) / gap) * ((p->strokeM + p->gapM) / gap)
+            - p->massKg * SIMSOLENOID_GRAVITY - p->dampingNs * simSolenoidV;
+
+    if (simSolenoidResting && force <= 0.0) {
+        return;
+    }
+    simSolenoidResting = false;
+
+    /* semi-implicit Euler */
+    simSolenoidV += force / p->massKg * dt;
+    simSolenoidX += simSolenoidV * dt;
+
+    if (simSolenoidX >= p->strokeM) {
+        simSolenoidX = p->strokeM;
+        simSolenoidV = 0.0;
+        if (simSolenoidShow != NULL && simSolenoidShow->upNs == UINT64_MAX && simSolenoidOn) {
+            simSolenoidShow->upNs = ns - simSolenoidShow->gateOnNs;
+        }
+    }
+    else if (simSolenoidX <= 0.0) {
+        simSolenoidX = 0.0;
+        simSolenoidV = -simSolenoidV * p->restitution;
+        if (simSolenoidV < SIMSOLENOID_REST_MPS) {
+            simSolenoidV = 0.0;
+            simSolenoidResting = true;
+            if (simSolenoidShow != NULL && simSolenoidShow->settledNs == UINT64_MAX && !simSolenoidOn) {
+                simSolenoidShow->settledNs = ns - simSolenoidShow->gateOffNs;
+            }
+        }
+    }
+}
+
+/*
+ *  ======== simSolenoidRun ========
+ *  Integrate up to ns with the drive as it is
+ */
+static void simSolenoidRun(uint64_t ns)
+{
+    const SimSolenoid_Params *p = &simSolenoidParams;
+    double full = p->supplyV / p->coilOhm;
+    double dt = SIMSOLENOID_STEP_NS / 1.0e9;
+
+    while (simSolenoidNs + SIMSOLENOID_STEP_NS <= ns) {
+        /* nothing left to move: skip to the end */
+        if (!simSolenoidOn && simSolenoidResting && simSolenoidI < SIMSOLENOID_STEADY * full) {
+            simSolenoidI = 0.0;
+            break;
+        }
+        if (simSolenoidOn && simSolenoidX >= p->strokeM &&
+            full - simSolenoidI < SIMSOLENOID_STEADY * full) {
+            simSolenoidShow->coilJoules += full * full * p->coilOhm * (ns - simSolenoidNs) / 1.0e9;
+            break;
+        }
+
+        simSolenoidNs += SIMSOLENOID_STEP_NS;
+        simSolenoidStep(simSolenoidNs, dt);
+    }
+
+    simSolenoidNs = ns;
+}
+
+/*
+ *  ======== simSolenoidEdge ========
+ *  Sim observer
+ */
+static void simSolenoidEdge(const Sim_Event *event, void *arg)
+{
+    bool on;
+
+    if (event->kind != Sim_GpioEvent || event->index != simSolenoidGate) {
+        return;
+    }
+    on = (event->value != 0);
+    if (on == simSolenoidOn) {
+        return;
+    }
+
+    simSolenoidRun(event->ns);
+    simSolenoidOn = on;
+
+    if (on) {
+        if (simSolenoidShow != NULL && simSolenoidShow->settledNs == UINT64_MAX) {
+            simSolenoidShow->raisedEarly = true;
+        }
+        if (simSolenoidShowCount == simSolenoidShowCapacity) {
+            simSolenoidShowCapacity = (simSolenoidShowCapacity != 0) ? simSolenoidShowCapacity * 2 : 64;
+            simSolenoidShows = realloc(simSolenoidShows, simSolenoidShowCapacity * sizeof(SimSolenoid_Show));
+            if (simSolenoidShows == NULL) {
+                fprintf(stderr, "sim: out of memory for solenoid shows\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        simSolenoidShow = &simSolenoidShows[simSolenoidShowCount++];
+        simSolenoidShow->gateOnNs = event->ns;
+        simSolenoidShow->upNs = UINT64_MAX;
+        simSolenoidShow->gateOffNs = UINT64_MAX;
+        simSolenoidShow->settledNs = UINT64_MAX;
+        simSolenoidShow->coilJoules = 0.0;
+        simSolenoidShow->loweredEarly = false;
+        simSolenoidShow->raisedEarly = false;
+        simSolenoidShow->powerOn = !Sim_started();
+        if (simSolenoidX >= simSolenoidParams.strokeM) {
+            simSolenoidShow->upNs = 0;
+        }
+    }
+    else if (simSolenoidShow != NULL) {
+        simSolenoidShow->gateOffNs = event->ns;
+        simSolenoidShow->loweredEarly = (simSolenoidShow->upNs == UINT64_MAX);
+        if (simSolenoidResting) {
+            simSolenoidShow->settledNs = 0;     /* it never left the bottom */
+        }
+    }
+}
+
+/*
+ *  ======== SimSolenoid_attach ========
+ */
+void SimSolenoid_attach(const SimSolenoid_Params *params)
+{
+    if (params != NULL) {
+        simSolenoidParams = *params;
+    }
+    else {
+        SimSolenoid_Params_init(&simSolenoidParams);
+    }
+
+    simSolenoidGate = SimBoard_gpioIndex("transistorGatePin");
+    simSolenoidOn = false;
+    simSolenoidNs = Sim_now();
+    simSolenoidX = 0.0;
+    simSolenoidV = 0.0;
+    simSolenoidI = 0.0;
+    simSolenoidResting = true;
+    simSolenoidShowCount = 0;
+    simSolenoidShow = NULL;
+
+    Sim_addObserver(simSolenoidEdge, NULL);
+}
+
+/*
+ *  ======== SimSolenoid_finish ========
+ */
+void SimSolenoid_finish(void)
+{
+    if (simSolenoidGate >= 0) {
+        simSolenoidRun(Sim_now());
+    }
+}
+
+/*
+ *  ======== SimSolenoid_shows ========
+ */
+const SimSolenoid_Show *SimSolenoid_shows(uint32_t *count)
+{
+    *count = simSolenoidShowCount;
+
+    return (simSolenoidShows);
+}
+
+/*
+ *  ======== SimSolenoid_late ========
+ */
+void SimSolenoid_late(const SimSolenoid_Show *show, uint64_t risingNs, uint64_t loweringNs,
+                      bool *lateUp, bool *lateDown)
+{
+    uint64_t now = Sim_now();
+
+    if (show->upNs != UINT64_MAX) {
+        *lateUp = (show->upNs > risingNs);
+    }
+    else {
+        *lateUp = (show->gateOffNs != UINT64_MAX || now - show->gateOnNs > risingNs);
+    }
+
+    if (show->gateOffNs == UINT64_MAX) {
+        *lateDown = false;
+    }
+    else if (show->settledNs != UINT64_MAX) {
+        *lateDown = (show->settledNs > loweringNs);
+    }
+    else {
+        *lateDown = (show->raisedEarly || now - show->gateOffNs > loweringNs);
+    }
+}
+
+/*
+ *  ======== SimSolenoid_position ========
+ */
+double SimSolenoid_position(void)
+{
+    SimSolenoid_finish();
+
+    return (simSolenoidX / simSolenoidParams.strokeM);
+}
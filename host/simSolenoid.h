@@ -0,0 +1,112 @@
+/*
+ *  ======== simSolenoid.h ========
+ *  Physics of the body lift for the host simulation: the solenoid that
+ *  transistorGatePin switches, and the body it raises and lets fall.
+ *
+ *  One degree of freedom, along the plunger stroke: x = 0 with the body
+ *  down, x = strokeM with it up against the top stop. The coil current
+ *  rises and decays through its L/R time constant (the flyback clamp adds
+ *  clampOhm on the way down); the pull grows with the square of the
+ *  current and falls off with the air gap. The body's weight, reflected
+ *  to the plunger as massKg, is slowed by a dashpot, stops dead at the
+ *  top and bounces at the bottom.
+ *
+ *  The model runs as a Sim observer: between two edges of the gate pin
+ *  the drive is constant, so each edge integrates the span since the last
+ *  one. It takes no virtual time and changes nothing the app sees.
+ *
+ *  Per show it measures how long the body took to get all the way up
+ *  after the gate went high, and to come to rest at the bottom after it
+ *  went low - the floor for lengthOfRisingMode and
+ *  lengthOfLoweringingMode - and counts shows where the gate dropped
+ *  before the body was up, or rose again before it had settled.
+ */
+
+#ifndef __SIMSOLENOID_H
+#define __SIMSOLENOID_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*!
+ *  @def    SimSolenoid_Params
+ */
+typedef struct SimSolenoid_Params {
+    double massKg;          /* body and plunger, reflected to the plunger */
+    double strokeM;
+    double forceN;          /* pull at full stroke and full current */
+    double gapM;            /* fringe gap - the pull at closed is (stroke + gap)^2 / gap^2 times that */
+    double supplyV;
+    double coilOhm;
+    double coilH;
+    double clampOhm;        /* flyback path, in series with the coil when off */
+    double dampingNs;       /* dashpot, N per m/s */
+    double restitution;     /* bounce off the bottom stop, 0..1 */
+} SimSolenoid_Params;
+
+/*!
+ *  @def    SimSolenoid_Show
+ *  @brief  One gate high/low cycle; times in ns, UINT64_MAX if it never happened
+ */
+typedef struct SimSolenoid_Show {
+    uint64_t gateOnNs;
+    uint64_t upNs;          /* gate on to the top stop */
+    uint64_t gateOffNs;
+    uint64_t settledNs;     /* gate off to at rest at the bottom */
+    double   coilJoules;    /* heat in the coil while the gate was on */
+    bool     loweredEarly;  /* the gate went low before the body was up */
+    bool     raisedEarly;   /* the next show started before this one settled */
+    bool     powerOn;       /* the gate's initial level (GPIO_init), not a trigger */
+} SimSolenoid_Show;
+
+/*!
+ *  @brief  The values used when attach is given NULL
+ */
+extern void SimSolenoid_Params_init(SimSolenoid_Params *params);
+
+/*!
+ *  @brief  Start modelling; call after Sim_init, before the app runs
+ */
+extern void SimSolenoid_attach(const SimSolenoid_Params *params);
+
+/*!
+ *  @brief  Set a parameter by its field name ("massKg=3.5")
+ *
+ *  @return false if the name is unknown or the value does not parse
+ */
+extern bool SimSolenoid_setParam(SimSolenoid_Params *params, const char *assignment);
+
+/*!
+ *  @brief  Bring the model up to the current virtual time
+ */
+extern void SimSolenoid_finish(void);
+
+/*!
+ *  @brief  Every show so far, oldest first; valid until the next gate edge
+ */
+extern const SimSolenoid_Show *SimSolenoid_shows(uint32_t *count);
+
+/*!
+ *  @brief  Whether a show's body was late for the app's phases
+ *
+ *  lateUp: not at the top stop risingNs after the gate went on. lateDown:
+ *  not at rest loweringNs after it went off. A phase the run is still in
+ *  is not judged.
+ */
+extern void SimSolenoid_late(const SimSolenoid_Show *show, uint64_t risingNs, uint64_t loweringNs,
+                             bool *lateUp, bool *lateDown);
+
+/*!
+ *  @brief  Body position now, 0 (down) .. 1 (up)
+ */
+extern double SimSolenoid_position(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIMSOLENOID_H */
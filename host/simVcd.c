@@ -0,0 +1,124 @@
+/*
+ *  ======== simVcd.c ========
+ *  Value Change Dump writer - see simVcd.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Board.h"
+#include "sim.h"
+#include "simVcd.h"
+
+#define SIMVCD_BUFFER       (1024 * 1024)
+
+/* identifier codes: GPIOs from '!', PWMs after them */
+#define SIMVCD_GPIO_ID(index)   ((char)('!' + (index)))
+#define SIMVCD_PWM_ID(index)    ((char)('!' + EK_TM4C123GXL_GPIOCOUNT + (index)))
+
+static FILE     *simVcdFile;
+static char     *simVcdBuffer;
+static uint64_t  simVcdLastNs;
+
+/*
+ *  ======== simVcdDuty ========
+ */
+static void simVcdDuty(uint32_t duty, char id)
+{
+    int bit = 31;
+
+    fputc('b', simVcdFile);
+    while (bit > 0 && (duty & (1u << bit)) == 0) {
+        bit--;
+    }
+    for (; bit >= 0; bit--) {
+        fputc((duty & (1u << bit)) ? '1' : '0', simVcdFile);
+    }
+    fprintf(simVcdFile, " %c\n", id);
+}
+
+/*
+ *  ======== simVcdEvent ========
+ *  Sim observer
+ */
+static void simVcdEvent(const Sim_Event *event, void *arg)
+{
+    if (simVcdFile == NULL || event->kind == Sim_PwmOpenEvent) {
+        return;
+    }
+
+    if (event->ns != simVcdLastNs) {
+        fprintf(simVcdFile, "#%llu\n", (unsigned long long)event->ns);
+        simVcdLastNs = event->ns;
+    }
+
+    if (event->kind == Sim_GpioEvent) {
+        fprintf(simVcdFile, "%u%c\n", event->value != 0, SIMVCD_GPIO_ID(event->index));
+    }
+    else {
+        simVcdDuty(event->value, SIMVCD_PWM_ID(event->index));
+    }
+}
+
+/*
+ *  ======== SimVcd_open ========
+ */
+bool SimVcd_open(const char *path)
+{
+    unsigned int index;
+
+    if ((simVcdFile = fopen(path, "w")) == NULL) {
+        return (false);
+    }
+    if ((simVcdBuffer = malloc(SIMVCD_BUFFER)) != NULL) {
+        setvbuf(simVcdFile, simVcdBuffer, _IOFBF, SIMVCD_BUFFER);
+    }
+
+    fprintf(simVcdFile,
+            "$version werewolf_sim $end\n"
+            "$timescale 1ns $end\n"
+            "$scope module werewolf $end\n"
+            "$scope module gpio $end\n");
+    for (index = 0; index < EK_TM4C123GXL_GPIOCOUNT; index++) {
+        fprintf(simVcdFile, "$var wire 1 %c %s $end\n", SIMVCD_GPIO_ID(index), SimBoard_gpioName(index));
+    }
+    fprintf(simVcdFile, "$upscope $end\n$scope module pwm $end\n");
+    for (index = 0; index < EK_TM4C123GXL_PWMCOUNT; index++) {
+        fprintf(simVcdFile, "$var wire 32 %c %s $end\n", SIMVCD_PWM_ID(index), SimBoard_pwmName(index));
+    }
+    fprintf(simVcdFile, "$upscope $end\n$upscope $end\n$enddefinitions $end\n");
+
+    simVcdLastNs = Sim_now();
+    fprintf(simVcdFile, "#%llu\n$dumpvars\n", (unsigned long long)simVcdLastNs);
+    for (index = 0; index < EK_TM4C123GXL_GPIOCOUNT; index++) {
+        fprintf(simVcdFile, "%d%c\n", SimBoard_gpioLevel(index), SIMVCD_GPIO_ID(index));
+    }
+    for (index = 0; index < EK_TM4C123GXL_PWMCOUNT; index++) {
+        simVcdDuty(SimBoard_pwmDuty(index), SIMVCD_PWM_ID(index));
+    }
+    fprintf(simVcdFile, "$end\n");
+
+    Sim_addObserver(simVcdEvent, NULL);
+
+    return (true);
+}
+
+/*
+ *  ======== SimVcd_close ========
+ */
+void SimVcd_close(void)
+{
+    if (simVcdFile == NULL) {
+        return;
+    }
+
+    if (Sim_now() != simVcdLastNs) {
+        fprintf(simVcdFile, "#%llu\n", (unsigned long long)Sim_now());
+    }
+    fclose(simVcdFile);
+    free(simVcdBuffer);
+    simVcdFile = NULL;
+    simVcdBuffer = NULL;
+}
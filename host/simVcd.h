@@ -0,0 +1,42 @@
+/*
+ *  ======== simVcd.h ========
+ *  Value Change Dump of a host simulation run, for GTKWave.
+ *
+ *  Every GPIO is a 1-bit wire and every PWM a 32-bit duty (microseconds),
+ *  named as in Board.h, with virtual-time stamps in nanoseconds. Changes
+ *  are written as the simulation makes them through a large stdio buffer,
+ *  so nothing is held in memory and an hour-long run costs one pass over
+ *  the file.
+ *
+ *      Sim_init(&options);
+ *      SimVcd_open("show.vcd");
+ *      werewolf_main();
+ *      SimVcd_close();
+ */
+
+#ifndef __SIMVCD_H
+#define __SIMVCD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+/*!
+ *  @brief  Start the dump; call after Sim_init and before the app's main
+ *
+ *  @return false if the file could not be created
+ */
+extern bool SimVcd_open(const char *path);
+
+/*!
+ *  @brief  Stamp the end of the run and close the file
+ */
+extern void SimVcd_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIMVCD_H */
@@ -0,0 +1,461 @@
+/*
+ *  ======== slo.c ========
+ *  Visitor-to-reveal latency under a realistic crowd, as one pass/fail
+ *  result: runs the whole app (werewolf_main, distSensorFxn and all) on
+ *  the simulated board, with one prop of a yard layout watching a crowd
+ *  of visitors (crowd.h), and fails if the p99 latency or the share of
+ *  groups missed is over budget.
+ *
+ *      werewolf_slo [--hours H] [--seed S] [--groups-per-hour N]
+ *                   [--beam DEG] [--range INCHES] [--budget-ms N]
+ *                   [--missed-percent N]
+ *                   [--min N] [--max N] [--hits N] [--ping-ms N]
+ *                   [--reset-ms N] [--rising-ms N] [--lowering-ms N]
+ *                   [--solenoid-param NAME=VALUE]... [--list]
+ *                   yard.layout PROP
+ *
+ *  The layout is fleet.c's (crowd.h); its walkway, visitor rate and run
+ *  length are used, and of its props only PROP, which is the sensor the
+ *  app sees through: each ping reads the nearest visitor in PROP's beam.
+ *  PROP's PHASE_MS is when the app starts on the crowd's clock, and its
+ *  PING_MS sets pingIntervalMillis. --hours, --groups-per-hour and
+ *  --ping-ms override the layout. --min, --max, --hits,
+ *  --ping-ms, --reset-ms, --rising-ms and --lowering-ms set werewolf.c's
+ *  TUNABLE trigger parameters, so a change to any of them can be judged
+ *  on the same crowd.
+ *
+ *  Latency is per group of visitors: from the first moment one of them
+ *  is the nearest thing in the beam and inside the trigger window
+ *  (minTriggerDistance .. maxTriggerDistance, looked for every
+ *  SLO_STEP_NS), to the first moment after that the body is all the way
+ *  up - the gate on plus the time the lift took (simSolenoid.h). A group
+ *  that comes into the window with the body already up waits 0; one that
+ *  comes in while the prop is lowering or locked out (resetMillis) waits
+ *  that out and then for its own trigger. A group that has walked on out
+ *  of range of the prop (in any direction) before the body is up is
+ *  missed. Misses have no latency to rank, so they are not in the
+ *  percentiles; instead they have a budget of their own, --missed-percent
+ *  of the groups that came into the window, and going over it fails the
+ *  run as surely as a slow p99 does.
+ *
+ *  The summary goes to stderr, and --list prints every group as
+ *  "group enterMs latencyMs status" on stdout. A crowd and a build always
+ *  give the same numbers, so two builds can be compared run for run.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim.h"
+#include "simSolenoid.h"
+#include "crowd.h"
+#include "werewolfParams.h"
+
+#define SLO_STEP_NS         10000000ull     /* how finely window entry is looked for */
+#define SLO_NEVER           UINT64_MAX
+#define SLO_BUDGET_MS       6000
+#define SLO_MISSED_PERCENT  10          /* of the groups that came into the window */
+
+typedef struct Slo_Group {
+    uint64_t enterNs;       /* into the trigger window, SLO_NEVER if never */
+    uint64_t nearNs;        /* the last of them still within range of the prop */
+    uint64_t latencyNs;     /* SLO_NEVER if missed */
+    bool     blind;         /* came in while the prop was lowering or locked out */
+} Slo_Group;
+
+static Crowd         sloCrowd;
+static Crowd_Layout  sloLayout;
+static Crowd_Sensor  sloSensor;
+static uint64_t      sloPhaseNs;    /* the app's power-on, on the crowd's clock */
+static Slo_Group    *sloGroups;
+static double        sloGroupsPerHour = -1.0;
+static uint64_t      sloRunNs = 3600000ull * 1000000ull;
+
+/*
+ *  ======== sloReadLayout ========
+ *  The walkway and one prop of a fleet.c layout
+ */
+static void sloReadLayout(const char *path, const char *name, double beam, double range)
+{
+    const Crowd_LayoutProp *prop;
+
+    if (!Crowd_readLayout(&sloLayout, path)) {
+        Sim_fail("slo", "cannot use the layout", path);
+    }
+    if ((prop = Crowd_findProp(&sloLayout, name)) == NULL) {
+        fprintf(stderr, "slo: no prop %s in %s\n", name, path);
+        exit(EXIT_FAILURE);
+    }
+    if (sloLayout.runNs != 0) {
+        sloRunNs = sloLayout.runNs;
+    }
+    if (sloGroupsPerHour < 0.0) {
+        sloGroupsPerHour = sloLayout.groupsPerHour;
+    }
+    Crowd_Sensor_init(&sloSensor, prop->x, prop->y, prop->facing, beam, range);
+    sloPhaseNs = prop->phaseNs;
+    if (prop->pingMillis != 0) {
+        pingIntervalMillis = (int)prop->pingMillis;
+    }
+}
+
+/*
+ *  ======== sloRange ========
+ *  Sim range model - the nearest visitor in the prop's beam
+ */
+static double sloRange(uint64_t ns, void *arg)
+{
+    return (Crowd_nearest(&sloCrowd, &sloSensor, ns + sloPhaseNs, NULL));
+}
+
+/*
+ *  ======== sloEnter ========
+ *  When each group first comes into the trigger window, and when the
+ *  last of them is out of range of the prop
+ */
+static void sloEnter(void)
+{
+    Slo_Group *group;
+    uint64_t   ns;
+    double     distance;
+    double     x;
+    double     y;
+    size_t     first;
+    size_t     end;
+    size_t     visitor;
+    size_t     g;
+
+    sloGroups = Sim_alloc("slo", NULL, (sloCrowd.groups + 1) * sizeof(Slo_Group));
+    for (g = 0; g <= sloCrowd.groups; g++) {
+        sloGroups[g].enterNs = SLO_NEVER;
+        sloGroups[g].nearNs = 0;
+        sloGroups[g].latencyNs = SLO_NEVER;
+        sloGroups[g].blind = false;
+    }
+
+    for (ns = 0; ns < sloRunNs; ns += SLO_STEP_NS) {
+        end = Crowd_present(&sloCrowd, ns, &first);
+        for (visitor = first; visitor < end; visitor++) {
+            if (Crowd_position(&sloCrowd, visitor, ns, &x, &y) &&
+                (x - sloSensor.x) * (x - sloSensor.x) + (y - sloSensor.y) * (y - sloSensor.y) <=
+                sloSensor.range * sloSensor.range) {
+                sloGroups[sloCrowd.visitors[visitor].group].nearNs = ns;
+            }
+        }
+
+        distance = Crowd_nearest(&sloCrowd, &sloSensor, ns, &visitor);
+        if (distance >= minTriggerDistance && distance <= maxTriggerDistance) {
+            group = &sloGroups[sloCrowd.visitors[visitor].group];
+            if (group->enterNs == SLO_NEVER) {
+                group->enterNs = ns;
+            }
+        }
+    }
+}
+
+/*
+ *  ======== sloShows ========
+ *  The lifts the app triggered - not one from the gate's power-on level
+ */
+static const SimSolenoid_Show *sloShows(uint32_t *count)
+{
+    const SimSolenoid_Show *shows = SimSolenoid_shows(count);
+
+    while (*count != 0 && shows->powerOn) {
+        shows++;
+        (*count)--;
+    }
+
+    return (shows);
+}
+
+/*
+ *  ======== sloScore ========
+ *  Each group's latency from the shows the body lift saw
+ */
+static void sloScore(void)
+{
+    const SimSolenoid_Show *shows;
+    const SimSolenoid_Show *show;
+    uint64_t                lockoutNs = (uint64_t)(lengthOfLoweringingMode + resetMillis) * 1000000ull;
+    uint64_t                upNs;
+    uint32_t                count;
+    uint32_t                low;
+    uint32_t                high;
+    uint32_t                mid;
+    uint32_t                s;
+    Slo_Group              *group;
+    size_t                  g;
+
+    SimSolenoid_finish();
+    shows = sloShows(&count);
+
+    for (g = 0; g < sloCrowd.groups; g++) {
+        group = &sloGroups[g];
+        if (group->enterNs == SLO_NEVER) {
+            continue;
+        }
+
+        /* the first show whose body was still up (or not yet down) when they came in */
+        low = 0;
+        high = count;
+        while (low < high) {
+            mid = (low + high) / 2;
+            if (shows[mid].gateOffNs != UINT64_MAX && shows[mid].gateOffNs + sloPhaseNs <= group->enterNs) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
+        }
+        if (low != 0 && shows[low - 1].gateOffNs + sloPhaseNs + lockoutNs > group->enterNs) {
+            group->blind = true;
+        }
+
+        for (s = low; s < count; s++) {
+            show = &shows[s];
+            if (show->upNs == UINT64_MAX) {
+                continue;
+            }
+            upNs = sloPhaseNs + show->gateOnNs + show->upNs;
+            if (upNs < group->enterNs) {
+                upNs = group->enterNs;
+            }
+            if (upNs <= group->nearNs) {
+                group->latencyNs = upNs - group->enterNs;
+            }
+            break;
+        }
+    }
+}
+
+/*
+ *  ======== sloCompare ========
+ */
+static int sloCompare(const void *a, const void *b)
+{
+    uint64_t ua = *(const uint64_t *)a;
+    uint64_t ub = *(const uint64_t *)b;
+
+    return ((ua < ub) ? -1 : (ua > ub));
+}
+
+/*
+ *  ======== sloUsage ========
+ */
+static void sloUsage(void)
+{
+    fprintf(stderr,
+            "usage: werewolf_slo [--hours H] [--seed S] [--groups-per-hour N]\n"
+            "                    [--beam DEG] [--range INCHES] [--budget-ms N]\n"
+            "                    [--missed-percent N]\n"
+            "                    [--min N] [--max N] [--hits N] [--ping-ms N]\n"
+            "                    [--reset-ms N] [--rising-ms N] [--lowering-ms N]\n"
+            "                    [--solenoid-param NAME=VALUE]... [--list]\n"
+            "                    yard.layout PROP\n");
+    exit(EXIT_FAILURE);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(int argc, char *argv[])
+{
+    Sim_Options        options;
+    Crowd_Params       params;
+    SimSolenoid_Params solenoid;
+    Slo_Group         *group;
+    uint64_t          *latencies;
+    const char        *layout = NULL;
+    const char        *prop = NULL;
+    double             hours = -1.0;
+    double             beam = 15.0;
+    double             range = 160.0;
+    unsigned long      budgetMillis = SLO_BUDGET_MS;
+    double             missedBudget = SLO_MISSED_PERCENT;
+    double             missedPercent;
+    bool               met;
+    int                pingMillis = 0;
+    bool               list = false;
+    uint32_t           shows;
+    size_t             entered = 0;
+    size_t             revealed = 0;
+    size_t             blind = 0;
+    size_t             g;
+    clock_t            wallStart;
+    double             wallSeconds;
+    double             p99;
+    int                arg;
+
+    Crowd_Params_init(&params);
+    SimSolenoid_Params_init(&solenoid);
+
+    for (arg = 1; arg < argc; arg++) {
+        const char *value = (arg + 1 < argc) ? argv[arg + 1] : NULL;
+
+        if (strcmp(argv[arg], "--hours") == 0 && value != NULL) {
+            hours = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--seed") == 0 && value != NULL) {
+            params.seed = strtoull(value, NULL, 0);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--groups-per-hour") == 0 && value != NULL) {
+            sloGroupsPerHour = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--beam") == 0 && value != NULL) {
+            beam = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--range") == 0 && value != NULL) {
+            range = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--budget-ms") == 0 && value != NULL) {
+            budgetMillis = strtoul(value, NULL, 0);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--missed-percent") == 0 && value != NULL) {
+            missedBudget = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--min") == 0 && value != NULL) {
+            minTriggerDistance = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--max") == 0 && value != NULL) {
+            maxTriggerDistance = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--hits") == 0 && value != NULL) {
+            requiredHitCount = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--ping-ms") == 0 && value != NULL) {
+            pingMillis = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--reset-ms") == 0 && value != NULL) {
+            resetMillis = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--rising-ms") == 0 && value != NULL) {
+            lengthOfRisingMode = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--lowering-ms") == 0 && value != NULL) {
+            lengthOfLoweringingMode = atoi(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--solenoid-param") == 0 && value != NULL) {
+            if (!SimSolenoid_setParam(&solenoid, value)) {
+                sloUsage();
+            }
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--list") == 0) {
+            list = true;
+        }
+        else if (argv[arg][0] != '-' && layout == NULL) {
+            layout = argv[arg];
+        }
+        else if (argv[arg][0] != '-' && prop == NULL) {
+            prop = argv[arg];
+        }
+        else {
+            sloUsage();
+        }
+    }
+    if (layout == NULL || prop == NULL) {
+        sloUsage();
+    }
+
+    sloReadLayout(layout, prop, beam, range);
+    if (hours > 0.0) {
+        sloRunNs = (uint64_t)(hours * 3600.0e9);
+    }
+    if (sloGroupsPerHour >= 0.0) {
+        params.groupsPerHour = sloGroupsPerHour;
+    }
+    if (pingMillis > 0) {
+        pingIntervalMillis = pingMillis;
+    }
+    if (sloPhaseNs >= sloRunNs) {
+        Sim_fail("slo", "the prop powers on after the end of the run:", prop);
+    }
+    if (!Crowd_generate(&sloCrowd, &sloLayout.path, &params, sloRunNs)) {
+        Sim_fail("slo", "cannot generate visitors for", layout);
+    }
+    sloEnter();
+
+    Sim_Options_init(&options);
+    options.runNs = sloRunNs - sloPhaseNs;
+    options.record = false;
+    options.range = sloRange;
+
+    wallStart = clock();
+    Sim_init(&options);
+    SimSolenoid_attach(&solenoid);
+    werewolf_main();
+    wallSeconds = (double)(clock() - wallStart) / CLOCKS_PER_SEC;
+
+    sloScore();
+    sloShows(&shows);
+
+    latencies = Sim_alloc("slo", NULL, (sloCrowd.groups + 1) * sizeof(uint64_t));
+    for (g = 0; g < sloCrowd.groups; g++) {
+        group = &sloGroups[g];
+        if (group->enterNs == SLO_NEVER) {
+            continue;
+        }
+        entered++;
+        blind += group->blind;
+        if (group->latencyNs != SLO_NEVER) {
+            latencies[revealed++] = group->latencyNs;
+        }
+        if (list) {
+            printf("%zu %llu ", g, (unsigned long long)(group->enterNs / 1000000u));
+            if (group->latencyNs != SLO_NEVER) {
+                printf("%llu %s\n", (unsigned long long)(group->latencyNs / 1000000u),
+                       group->blind ? "blind" : "ready");
+            }
+            else {
+                printf("- missed\n");
+            }
+        }
+    }
+    qsort(latencies, revealed, sizeof(uint64_t), sloCompare);
+
+    fprintf(stderr, "slo: %s, %.1f h, %.0f groups/h: %u groups, %zu came into the window, "
+                    "%zu shown to, %zu missed, %zu came in while the prop was blind; %u shows; "
+                    "simulated in %.2f s\n",
+            prop, sloRunNs / 3600.0e9, params.groupsPerHour, sloCrowd.groups, entered,
+            revealed, entered - revealed, blind, shows, wallSeconds);
+    if (Sim_aborted()) {
+        Sim_fail("slo", "the app aborted", NULL);
+    }
+    if (revealed == 0) {
+        Sim_fail("slo", "no group was shown to; nothing to measure", NULL);
+    }
+
+    p99 = latencies[(revealed * 99 + 99) / 100 - 1] / 1.0e6;
+    fprintf(stderr, "slo: window to body up, ms: p50 %.0f  p90 %.0f  p99 %.0f  max %.0f; "
+                    "p99 budget %lu ms: %s\n",
+            latencies[(revealed - 1) / 2] / 1.0e6, latencies[(revealed * 90 + 99) / 100 - 1] / 1.0e6,
+            p99, latencies[revealed - 1] / 1.0e6, budgetMillis,
+            (p99 <= budgetMillis) ? "met" : "MISSED");
+    missedPercent = 100.0 * (entered - revealed) / entered;
+    fprintf(stderr, "slo: missed %zu of %zu groups, %.1f%%; budget %.1f%%: %s\n",
+            entered - revealed, entered, missedPercent, missedBudget,
+            (missedPercent <= missedBudget) ? "met" : "MISSED");
+
+    met = (p99 <= budgetMillis && missedPercent <= missedBudget);
+
+    return (met ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,1062 @@
+/*
+ *  ======== sweep.c ========
+ *  Trigger tuning by brute force: runs the app on the simulated board once
+ *  for every combination of parameter set and visitor trace, and reports
+ *  false-trigger rate, missed-visitor rate and reaction latency for each
+ *  parameter set as CSV.
+ *
+ *      werewolf_sweep [--min LIST] [--max LIST] [--hits LIST] [--ping LIST]
+ *                     [--reset LIST] [--rising LIST] [--lowering LIST]
+ *                     [--missing LIST] [--spurious LIST] [--stuck LIST]
+ *                     [--jitter LIST] [--trace FILE]...
+ *                     [--synthetic N] [--hours H] [--seed S] [-j JOBS]
+ *                     [-o FILE]
+ *
+ *  LIST is "a,b,c" or "first:last:step" and sets minTriggerDistance,
+ *  maxTriggerDistance, requiredHitCount, pingIntervalMillis, resetMillis,
+ *  lengthOfRisingMode and lengthOfLoweringingMode (werewolf.c); each
+ *  defaults to the firmware's value. --missing,
+ *  --spurious and --stuck are the percentage of pings that lose their
+ *  echo, get a phantom one, or stick high, and --jitter the most a wakeup
+ *  is late in us (Sim_Faults); they default to a perfect board. The sweep
+ *  covers every combination.
+ *
+ *  A visitor trace says what was in front of the sensor and which of it
+ *  the prop should have reacted to:
+ *
+ *      millis 3600000
+ *      visitor ID START END INCHES     # one stretch of a visitor (ms)
+ *      clutter START END INCHES        # anything that should not trigger
+ *
+ *  Stretches with the same ID are one visitor, present from the start of
+ *  the first to the end of the last. The sensor sees the nearest thing in
+ *  front of it. --synthetic N generates N traces of --hours each: visitors
+ *  who walk up, linger and leave, people passing further out, leaves on
+ *  the sensor and single-ping glitches.
+ *
+ *  Scoring, per run:
+ *      a visitor is missed if no show was running at any time they were
+ *      there;
+ *      a show is a false trigger if it started while no visitor was there
+ *      (or within one ping interval of one leaving);
+ *      reaction latency is from a visitor's arrival to the show that
+ *      started for them;
+ *      a show is unsafe if the body lift (simSolenoid.h, default model)
+ *      was not up by the end of the rising phase or at rest by the end of
+ *      the lowering phase.
+ *
+ *  Shorter rising and lowering phases end each show sooner, so the next
+ *  visitor is less likely to arrive while the prop is blind; the unsafe
+ *  column says how short they can go.
+ *
+ *  The app keeps its state in globals, so each run is its own process.
+ *  Before any thread starts, the parent forks one runner per worker; a
+ *  runner stays single-threaded and, for each run its worker thread asks
+ *  for through a pipe, forks a child from its own untouched copy of the
+ *  parent. The child sets the parameters, runs werewolf_main and writes
+ *  its score back, which the runner passes on. Forking only from
+ *  single-threaded processes keeps the children clear of locks (malloc,
+ *  stdio) that another thread held at the time of the fork. The workers
+ *  share the runs through a work-stealing pool - each takes from the back
+ *  of its own deque and, when that is empty, steals from the front of
+ *  another's - so long traces do not leave cores idle at the end of the
+ *  sweep.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "sim.h"
+#include "simSolenoid.h"
+#include "werewolfParams.h"
+
+#define SWEEP_PARAMS        11
+#define SWEEP_VALUES        64
+#define SWEEP_MAX_LATENCIES 4096
+
+/* Sim_Faults, as whole numbers */
+static int sweepMissingPercent;
+static int sweepSpuriousPercent;
+static int sweepStuckPercent;
+static int sweepJitterMicros;
+
+typedef struct Sweep_Param {
+    const char *option;
+    const char *column;
+    int        *value;
+    int         values[SWEEP_VALUES];
+    size_t      count;
+} Sweep_Param;
+
+typedef struct Sweep_Segment {
+    uint64_t startNs;
+    uint64_t endNs;
+    double   inches;
+    int      visitor;       /* index into visitors, -1 for clutter */
+} Sweep_Segment;
+
+typedef struct Sweep_Visitor {
+    uint64_t arriveNs;
+    uint64_t leaveNs;
+} Sweep_Visitor;
+
+typedef struct Sweep_Trace {
+    char          *name;
+    uint64_t       runNs;
+    Sweep_Segment *segments;        /* sorted by start */
+    size_t         segmentCount;
+    uint64_t       longestNs;       /* longest segment, bounds the search */
+    Sweep_Visitor *visitors;
+    size_t         visitorCount;
+} Sweep_Trace;
+
+/* what a child sends back, followed by latencies[] in ms */
+typedef struct Sweep_Score {
+    uint32_t ok;
+    uint32_t visitors;
+    uint32_t missed;
+    uint32_t shows;
+    uint32_t falseTriggers;
+    uint32_t unsafe;
+    uint32_t latencies;
+} Sweep_Score;
+
+typedef struct Sweep_Job {
+    size_t       set;
+    size_t       trace;
+    Sweep_Score  score;
+    uint32_t    *latencies;
+} Sweep_Job;
+
+typedef struct Sweep_Deque {
+    pthread_mutex_t lock;
+    size_t         *jobs;
+    size_t          head;
+    size_t          tail;
+} Sweep_Deque;
+
+/* a worker thread's runner process */
+typedef struct Sweep_Runner {
+    pid_t pid;
+    int   request;          /* job indexes to the runner */
+    int   reply;            /* Sweep_Score and latencies back */
+} Sweep_Runner;
+
+typedef struct Sweep_Show {
+    uint64_t startNs;
+    uint64_t endNs;
+} Sweep_Show;
+
+static Sweep_Param sweepParams[SWEEP_PARAMS] = {
+    { .option = "--min",    .column = "minTriggerDistance",      .value = &minTriggerDistance },
+    { .option = "--max",    .column = "maxTriggerDistance",      .value = &maxTriggerDistance },
+    { .option = "--hits",   .column = "requiredHitCount",        .value = &requiredHitCount },
+    { .option = "--ping",   .column = "pingIntervalMillis",      .value = &pingIntervalMillis },
+    { .option = "--reset",  .column = "resetMillis",             .value = &resetMillis },
+    { .option = "--rising", .column = "lengthOfRisingMode",      .value = &lengthOfRisingMode },
+    { .option = "--lowering", .column = "lengthOfLoweringingMode", .value = &lengthOfLoweringingMode },
+    { .option = "--missing", .column = "missingEchoPercent",      .value = &sweepMissingPercent },
+    { .option = "--spurious", .column = "spuriousEchoPercent",     .value = &sweepSpuriousPercent },
+    { .option = "--stuck",  .column = "stuckEchoPercent",        .value = &sweepStuckPercent },
+    { .option = "--jitter", .column = "wakeupJitterMicros",      .value = &sweepJitterMicros },
+};
+
+static Sweep_Trace *sweepTraces;
+static size_t       sweepTraceCount;
+static size_t       sweepSetCount;
+static Sweep_Job   *sweepJobs;
+static size_t       sweepJobCount;
+static Sweep_Deque *sweepDeques;
+static Sweep_Runner *sweepRunners;
+static size_t       sweepWorkers;
+static size_t       sweepDone;
+static pthread_mutex_t sweepProgressLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* child side */
+static const Sweep_Trace *sweepChildTrace;
+static Sweep_Show        *sweepChildShows;
+static size_t             sweepChildShowCount;
+static size_t             sweepChildShowCapacity;
+
+/*
+ *  ======== sweepParseList ========
+ *  "a,b,c" or "first:last:step"
+ */
+static void sweepParseList(Sweep_Param *param, const char *text)
+{
+    int   first;
+    int   last;
+    int   step;
+    char *copy;
+    char *item;
+    char *save;
+
+    param->count = 0;
+    if (sscanf(text, "%d:%d:%d", &first, &last, &step) == 3) {
+        if (step <= 0 || last < first) {
+            Sim_fail("sweep", "bad range", text);
+        }
+        for (; first <= last && param->count < SWEEP_VALUES; first += step) {
+            param->values[param->count++] = first;
+        }
+        return;
+    }
+
+    copy = strdup(text);
+    for (item = strtok_r(copy, ",", &save); item != NULL && param->count < SWEEP_VALUES;
+         item = strtok_r(NULL, ",", &save)) {
+        param->values[param->count++] = atoi(item);
+    }
+    free(copy);
+    if (param->count == 0) {
+        Sim_fail("sweep", "empty list", text);
+    }
+}
+
+/*
+ *  ======== sweepCompareSegments ========
+ */
+static int sweepCompareSegments(const void *a, const void *b)
+{
+    const Sweep_Segment *x = a;
+    const Sweep_Segment *y = b;
+
+    return ((x->startNs > y->startNs) - (x->startNs < y->startNs));
+}
+
+/*
+ *  ======== sweepAddSegment ========
+ */
+static void sweepAddSegment(Sweep_Trace *trace, uint64_t startNs, uint64_t endNs,
+                            double inches, int visitor)
+{
+    Sweep_Segment *segment;
+
+    if (endNs <= startNs) {
+        return;
+    }
+    trace->segments = Sim_alloc("sweep", trace->segments, (trace->segmentCount + 1) * sizeof(Sweep_Segment));
+    segment = &trace->segments[trace->segmentCount++];
+    segment->startNs = startNs;
+    segment->endNs = endNs;
+    segment->inches = inches;
+    segment->visitor = visitor;
+
+    if (visitor >= 0) {
+        if ((size_t)visitor >= trace->visitorCount) {
+            trace->visitors = Sim_alloc("sweep", trace->visitors, (visitor + 1) * sizeof(Sweep_Visitor));
+            while (trace->visitorCount <= (size_t)visitor) {
+                trace->visitors[trace->visitorCount].arriveNs = UINT64_MAX;
+                trace->visitors[trace->visitorCount].leaveNs = 0;
+                trace->visitorCount++;
+            }
+        }
+        if (startNs < trace->visitors[visitor].arriveNs) {
+            trace->visitors[visitor].arriveNs = startNs;
+        }
+        if (endNs > trace->visitors[visitor].leaveNs) {
+            trace->visitors[visitor].leaveNs = endNs;
+        }
+    }
+}
+
+/*
+ *  ======== sweepFinishTrace ========
+ */
+static void sweepFinishTrace(Sweep_Trace *trace)
+{
+    size_t i;
+    size_t kept = 0;
+
+    qsort(trace->segments, trace->segmentCount, sizeof(Sweep_Segment), sweepCompareSegments);
+    for (i = 0; i < trace->segmentCount; i++) {
+        if (trace->segments[i].endNs - trace->segments[i].startNs > trace->longestNs) {
+            trace->longestNs = trace->segments[i].endNs - trace->segments[i].startNs;
+        }
+    }
+
+    /* visitor IDs in a file need not be dense */
+    for (i = 0; i < trace->visitorCount; i++) {
+        if (trace->visitors[i].arriveNs != UINT64_MAX) {
+            trace->visitors[kept++] = trace->visitors[i];
+        }
+    }
+    trace->visitorCount = kept;
+}
+
+/*
+ *  ======== sweepReadTrace ========
+ */
+static void sweepReadTrace(const char *path)
+{
+    Sweep_Trace  *trace;
+    FILE         *file;
+    char          line[256];
+    unsigned long long millis;
+    unsigned long long start;
+    unsigned long long end;
+    double        inches;
+    int           id;
+    int           number = 0;
+    char         *hash;
+
+    if ((file = fopen(path, "r")) == NULL) {
+        Sim_fail("sweep", "cannot open", path);
+    }
+
+    sweepTraces = Sim_alloc("sweep", sweepTraces, (sweepTraceCount + 1) * sizeof(Sweep_Trace));
+    trace = &sweepTraces[sweepTraceCount++];
+    memset(trace, 0, sizeof(*trace));
+    trace->name = strdup(path);
+    trace->runNs = 3600000ull * 1000000ull;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        number++;
+        if ((hash = strchr(line, '#')) != NULL) {
+            *hash = '\0';
+        }
+        if (sscanf(line, " millis %llu", &millis) == 1) {
+            trace->runNs = millis * 1000000ull;
+        }
+        else if (sscanf(line, " visitor %d %llu %llu %lf", &id, &start, &end, &inches) == 4 && id >= 0) {
+            sweepAddSegment(trace, start * 1000000ull, end * 1000000ull, inches, id);
+        }
+        else if (sscanf(line, " clutter %llu %llu %lf", &start, &end, &inches) == 3) {
+            sweepAddSegment(trace, start * 1000000ull, end * 1000000ull, inches, -1);
+        }
+        else if (strspn(line, " \t\r\n") != strlen(line)) {
+            fprintf(stderr, "sweep: %s:%d: cannot parse\n", path, number);
+            exit(EXIT_FAILURE);
+        }
+    }
+    fclose(file);
+
+    sweepFinishTrace(trace);
+}
+
+/*
+ *  ======== sweepUniform ========
+ *  Sim_randomFrom draws - the same seed gives the same traces everywhere
+ */
+static double sweepUniform(uint64_t *state, double low, double high)
+{
+    return (low + (high - low) * Sim_randomFrom(state));
+}
+
+static double sweepExponential(uint64_t *state, double mean)
+{
+    return (-mean * log(1.0 - Sim_randomFrom(state)));
+}
+
+/*
+ *  ======== sweepWalk ========
+ *  A straight walk between two distances, as 250 ms steps
+ */
+static uint64_t sweepWalk(Sweep_Trace *trace, uint64_t ns, double from, double to,
+                          double millis, int visitor)
+{
+    const uint64_t stepNs = 250000000ull;
+    uint64_t       steps = (uint64_t)(millis / 250.0) + 1;
+    uint64_t       step;
+
+    for (step = 0; step < steps; step++) {
+        sweepAddSegment(trace, ns, ns + stepNs, from + (to - from) * step / steps, visitor);
+        ns += stepNs;
+    }
+
+    return (ns);
+}
+
+/*
+ *  ======== sweepSynthesize ========
+ *  One visitor about every four minutes; between them, passers-by beyond
+ *  the porch, now and then a leaf over the sensor, and glitch echoes.
+ */
+static void sweepSynthesize(unsigned int index, double hours, uint64_t seed)
+{
+    Sweep_Trace *trace;
+    uint64_t     state = (seed + index + 1) * 0x9E3779B97F4A7C15ull;
+    uint64_t     runNs = (uint64_t)(hours * 3600.0e9);
+    uint64_t     ns;
+    double       stand;
+    char         name[32];
+    int          visitor = 0;
+
+    sweepTraces = Sim_alloc("sweep", sweepTraces, (sweepTraceCount + 1) * sizeof(Sweep_Trace));
+    trace = &sweepTraces[sweepTraceCount++];
+    memset(trace, 0, sizeof(*trace));
+    snprintf(name, sizeof(name), "synthetic-%u", index);
+    trace->name = strdup(name);
+    trace->runNs = runNs;
+
+    for (ns = (uint64_t)(sweepExponential(&state, 240e9)); ns < runNs;
+         ns += (uint64_t)(sweepExponential(&state, 240e9))) {
+        stand = sweepUniform(&state, 18.0, 60.0);
+        ns = sweepWalk(trace, ns, 150.0, stand, sweepUniform(&state, 2000.0, 5000.0), visitor);
+        sweepAddSegment(trace, ns, ns + (uint64_t)(sweepUniform(&state, 2000.0, 20000.0) * 1e6), stand, visitor);
+        ns = trace->segments[trace->segmentCount - 1].endNs;
+        ns = sweepWalk(trace, ns, stand, 150.0, 2000.0, visitor);
+        visitor++;
+    }
+    for (ns = (uint64_t)(sweepExponential(&state, 120e9)); ns < runNs;
+         ns += (uint64_t)(sweepExponential(&state, 120e9))) {
+        sweepAddSegment(trace, ns, ns + (uint64_t)(sweepUniform(&state, 2000.0, 6000.0) * 1e6),
+                        sweepUniform(&state, 80.0, 200.0), -1);
+    }
+    for (ns = (uint64_t)(sweepExponential(&state, 600e9)); ns < runNs;
+         ns += (uint64_t)(sweepExponential(&state, 600e9))) {
+        sweepAddSegment(trace, ns, ns + (uint64_t)(sweepUniform(&state, 200.0, 2000.0) * 1e6),
+                        sweepUniform(&state, 3.0, 9.0), -1);
+    }
+    for (ns = (uint64_t)(sweepExponential(&state, 20e9)); ns < runNs;
+         ns += (uint64_t)(sweepExponential(&state, 20e9))) {
+        sweepAddSegment(trace, ns, ns + (uint64_t)(sweepUniform(&state, 1.0, 30.0) * 1e6),
+                        sweepUniform(&state, 5.0, 72.0), -1);
+    }
+
+    sweepFinishTrace(trace);
+}
+
+/*
+ *  ======== sweepRange ========
+ *  Sim range model - the nearest segment in front of the sensor
+ */
+static double sweepRange(uint64_t ns, void *arg)
+{
+    const Sweep_Trace *trace = arg;
+    size_t             low = 0;
+    size_t             high = trace->segmentCount;
+    size_t             mid;
+    double             nearest = -1.0;
+
+    /* first segment that could still be running */
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (trace->segments[mid].startNs + trace->longestNs <= ns) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    for (; low < trace->segmentCount && trace->segments[low].startNs <= ns; low++) {
+        if (ns < trace->segments[low].endNs &&
+            (nearest < 0.0 || trace->segments[low].inches < nearest)) {
+            nearest = trace->segments[low].inches;
+        }
+    }
+
+    return (nearest);
+}
+
+/*
+ *  ======== sweepShowEdge ========
+ *  Sim observer - transistorGatePin marks the show. Only a rise the app
+ *  makes opens one; the level GPIO_init gives the pin is not a show.
+ */
+static void sweepShowEdge(const Sim_Event *event, void *arg)
+{
+    static bool gateOn = false;
+
+    if (event->kind != Sim_GpioEvent || event->index != SimBoard_gpioIndex("transistorGatePin")) {
+        return;
+    }
+    if (!Sim_started()) {
+        gateOn = (event->value != 0);
+        return;
+    }
+
+    if (event->value != 0 && !gateOn) {
+        if (sweepChildShowCount == sweepChildShowCapacity) {
+            sweepChildShowCapacity = (sweepChildShowCapacity != 0) ? sweepChildShowCapacity * 2 : 64;
+            sweepChildShows = Sim_alloc("sweep", sweepChildShows, sweepChildShowCapacity * sizeof(Sweep_Show));
+        }
+        sweepChildShows[sweepChildShowCount].startNs = event->ns;
+        sweepChildShows[sweepChildShowCount].endNs = UINT64_MAX;
+        sweepChildShowCount++;
+    }
+    else if (event->value == 0 && sweepChildShowCount != 0) {
+        sweepChildShows[sweepChildShowCount - 1].endNs = event->ns;
+    }
+    gateOn = (event->value != 0);
+}
+
+/*
+ *  ======== sweepScore ========
+ */
+static void sweepScore(const Sweep_Trace *trace, Sweep_Score *score, uint32_t *latencies)
+{
+    const SimSolenoid_Show *lifts;
+    uint64_t                graceNs = (uint64_t)pingIntervalMillis * 1000000ull;
+    size_t                  visitor;
+    size_t                  show;
+    uint32_t                liftCount;
+    uint32_t                lift;
+    bool                    served;
+    bool                    wanted;
+    bool                    lateUp;
+    bool                    lateDown;
+
+    memset(score, 0, sizeof(*score));
+    score->ok = 1;
+    score->visitors = (uint32_t)trace->visitorCount;
+    score->shows = (uint32_t)sweepChildShowCount;
+
+    for (visitor = 0; visitor < trace->visitorCount; visitor++) {
+        const Sweep_Visitor *v = &trace->visitors[visitor];
+
+        served = false;
+        for (show = 0; show < sweepChildShowCount && !served; show++) {
+            if (sweepChildShows[show].startNs < v->leaveNs && sweepChildShows[show].endNs > v->arriveNs) {
+                served = true;
+                if (sweepChildShows[show].startNs >= v->arriveNs && score->latencies < SWEEP_MAX_LATENCIES) {
+                    latencies[score->latencies++] =
+                        (uint32_t)((sweepChildShows[show].startNs - v->arriveNs) / 1000000ull);
+                }
+            }
+        }
+        if (!served) {
+            score->missed++;
+        }
+    }
+
+    for (show = 0; show < sweepChildShowCount; show++) {
+        wanted = false;
+        for (visitor = 0; visitor < trace->visitorCount && !wanted; visitor++) {
+            wanted = sweepChildShows[show].startNs >= trace->visitors[visitor].arriveNs &&
+                     sweepChildShows[show].startNs <= trace->visitors[visitor].leaveNs + graceNs;
+        }
+        if (!wanted) {
+            score->falseTriggers++;
+        }
+    }
+
+    SimSolenoid_finish();
+    lifts = SimSolenoid_shows(&liftCount);
+    for (lift = 0; lift < liftCount; lift++) {
+        SimSolenoid_late(&lifts[lift], (uint64_t)lengthOfRisingMode * 1000000ull,
+                         (uint64_t)lengthOfLoweringingMode * 1000000ull, &lateUp, &lateDown);
+        if (lateUp || lateDown) {
+            score->unsafe++;
+        }
+    }
+}
+
+/*
+ *  ======== sweepWriteAll ========
+ */
+static void sweepWriteAll(int fd, const void *buf, size_t len)
+{
+    const char *p = buf;
+    ssize_t     written;
+
+    while (len != 0) {
+        written = write(fd, p, len);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            _exit(EXIT_FAILURE);
+        }
+        p += written;
+        len -= (size_t)written;
+    }
+}
+
+/*
+ *  ======== sweepChild ========
+ *  Runs in the forked child; never returns
+ */
+static void sweepChild(const Sweep_Job *job, int fd)
+{
+    static uint32_t latencies[SWEEP_MAX_LATENCIES];
+    Sim_Options     options;
+    Sweep_Score     score;
+    size_t          set = job->set;
+    size_t          param;
+
+    /* the set index counts through the combinations, last parameter fastest */
+    for (param = SWEEP_PARAMS; param-- > 0;) {
+        *sweepParams[param].value = sweepParams[param].values[set % sweepParams[param].count];
+        set /= sweepParams[param].count;
+    }
+
+    sweepChildTrace = &sweepTraces[job->trace];
+    Sim_Options_init(&options);
+    options.runNs = sweepChildTrace->runNs;
+    options.record = false;
+    options.range = sweepRange;
+    options.rangeArg = (void *)sweepChildTrace;
+    options.faults.missingEcho = sweepMissingPercent / 100.0;
+    options.faults.spuriousEcho = sweepSpuriousPercent / 100.0;
+    options.faults.stuckEcho = sweepStuckPercent / 100.0;
+    options.faults.wakeupJitterNs = (uint64_t)sweepJitterMicros * 1000ull;
+    options.faults.seed = job->trace + 1;
+
+    Sim_init(&options);
+    Sim_addObserver(sweepShowEdge, NULL);
+    SimSolenoid_attach(NULL);
+    werewolf_main();
+
+    if (Sim_aborted()) {
+        _exit(EXIT_FAILURE);
+    }
+
+    sweepScore(sweepChildTrace, &score, latencies);
+    sweepWriteAll(fd, &score, sizeof(score));
+    sweepWriteAll(fd, latencies, score.latencies * sizeof(uint32_t));
+    _exit(EXIT_SUCCESS);
+}
+
+/*
+ *  ======== sweepReadAll ========
+ */
+static bool sweepReadAll(int fd, void *buf, size_t len)
+{
+    char    *p = buf;
+    ssize_t  got;
+
+    while (len != 0) {
+        got = read(fd, p, len);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return (false);
+        }
+        p += got;
+        len -= (size_t)got;
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== sweepRunChild ========
+ *  Runs in a runner: forks the child for one job and passes its score on
+ */
+static void sweepRunChild(const Sweep_Job *job, int reply)
+{
+    static uint32_t latencies[SWEEP_MAX_LATENCIES];
+    Sweep_Score     score;
+    int             fds[2];
+    int             status;
+    pid_t           pid = -1;
+
+    memset(&score, 0, sizeof(score));
+    if (pipe(fds) == 0) {
+        pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            sweepChild(job, fds[1]);
+        }
+        close(fds[1]);
+        if (pid < 0 ||
+            !sweepReadAll(fds[0], &score, sizeof(score)) || score.latencies > SWEEP_MAX_LATENCIES ||
+            !sweepReadAll(fds[0], latencies, score.latencies * sizeof(uint32_t))) {
+            memset(&score, 0, sizeof(score));
+        }
+        close(fds[0]);
+    }
+
+    if (pid > 0) {
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+            ;
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            score.ok = 0;
+        }
+    }
+
+    sweepWriteAll(reply, &score, sizeof(score));
+    sweepWriteAll(reply, latencies, score.latencies * sizeof(uint32_t));
+}
+
+/*
+ *  ======== sweepStartRunners ========
+ *  Before any thread exists; each runner serves one worker until its
+ *  request pipe is closed
+ */
+static void sweepStartRunners(void)
+{
+    size_t worker;
+    size_t other;
+    size_t job;
+    int    request[2];
+    int    reply[2];
+
+    /* a runner that died shows as a failed read, not a fatal write */
+    signal(SIGPIPE, SIG_IGN);
+
+    sweepRunners = Sim_alloc("sweep", NULL, sweepWorkers * sizeof(Sweep_Runner));
+    for (worker = 0; worker < sweepWorkers; worker++) {
+        if (pipe(request) != 0 || pipe(reply) != 0) {
+            Sim_fail("sweep", "cannot create pipes", NULL);
+        }
+        sweepRunners[worker].pid = fork();
+        if (sweepRunners[worker].pid < 0) {
+            Sim_fail("sweep", "cannot start runners", NULL);
+        }
+        if (sweepRunners[worker].pid == 0) {
+            for (other = 0; other < worker; other++) {
+                close(sweepRunners[other].request);
+                close(sweepRunners[other].reply);
+            }
+            close(request[1]);
+            close(reply[0]);
+            while (sweepReadAll(request[0], &job, sizeof(job)) && job < sweepJobCount) {
+                sweepRunChild(&sweepJobs[job], reply[1]);
+            }
+            _exit(EXIT_SUCCESS);
+        }
+        close(request[0]);
+        close(reply[1]);
+        sweepRunners[worker].request = request[1];
+        sweepRunners[worker].reply = reply[0];
+    }
+}
+
+/*
+ *  ======== sweepStopRunners ========
+ */
+static void sweepStopRunners(void)
+{
+    size_t worker;
+    int    status;
+
+    for (worker = 0; worker < sweepWorkers; worker++) {
+        close(sweepRunners[worker].request);
+        close(sweepRunners[worker].reply);
+        while (waitpid(sweepRunners[worker].pid, &status, 0) < 0 && errno == EINTR) {
+            ;
+        }
+    }
+}
+
+/*
+ *  ======== sweepRun ========
+ *  Worker thread side: one job through the worker's runner
+ */
+static void sweepRun(const Sweep_Runner *runner, size_t index)
+{
+    Sweep_Job *job = &sweepJobs[index];
+    ssize_t    written;
+
+    memset(&job->score, 0, sizeof(job->score));
+    do {
+        written = write(runner->request, &index, sizeof(index));
+    } while (written < 0 && errno == EINTR);
+    if (written != sizeof(index)) {
+        return;
+    }
+
+    if (sweepReadAll(runner->reply, &job->score, sizeof(job->score)) &&
+        job->score.latencies <= SWEEP_MAX_LATENCIES) {
+        job->latencies = Sim_alloc("sweep", NULL, job->score.latencies * sizeof(uint32_t));
+        if (!sweepReadAll(runner->reply, job->latencies, job->score.latencies * sizeof(uint32_t))) {
+            job->score.ok = 0;
+        }
+    }
+    else {
+        job->score.ok = 0;
+    }
+}
+
+/*
+ *  ======== sweepTake ========
+ *  Own deque from the back, then steal from the front of the others
+ */
+static bool sweepTake(size_t self, size_t *job)
+{
+    Sweep_Deque *deque;
+    size_t       offset;
+    bool         found = false;
+
+    for (offset = 0; offset < sweepWorkers && !found; offset++) {
+        deque = &sweepDeques[(self + offset) % sweepWorkers];
+        pthread_mutex_lock(&deque->lock);
+        if (deque->tail > deque->head) {
+            *job = (offset == 0) ? deque->jobs[--deque->tail] : deque->jobs[deque->head++];
+            found = true;
+        }
+        pthread_mutex_unlock(&deque->lock);
+    }
+
+    return (found);
+}
+
+/*
+ *  ======== sweepWorker ========
+ */
+static void *sweepWorker(void *arg)
+{
+    size_t self = (size_t)(uintptr_t)arg;
+    size_t job;
+
+    while (sweepTake(self, &job)) {
+        sweepRun(&sweepRunners[self], job);
+
+        pthread_mutex_lock(&sweepProgressLock);
+        sweepDone++;
+        if (sweepDone % 16 == 0 || sweepDone == sweepJobCount) {
+            fprintf(stderr, "\rsweep: %zu/%zu runs", sweepDone, sweepJobCount);
+        }
+        pthread_mutex_unlock(&sweepProgressLock);
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== sweepCompareU32 ========
+ */
+static int sweepCompareU32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return ((x > y) - (x < y));
+}
+
+/*
+ *  ======== sweepReport ========
+ */
+static void sweepReport(FILE *out)
+{
+    size_t    set;
+    size_t    trace;
+    size_t    param;
+    size_t    index;
+    size_t    value;
+    uint32_t *latencies = NULL;
+    size_t    latencyCount;
+    double    hours;
+    double    latencySum;
+    uint32_t  runs;
+    uint32_t  failed;
+    uint32_t  visitors;
+    uint32_t  missed;
+    uint32_t  falseTriggers;
+    uint32_t  unsafe;
+    uint32_t  shows;
+
+    for (param = 0; param < SWEEP_PARAMS; param++) {
+        fprintf(out, "%s,", sweepParams[param].column);
+    }
+    fprintf(out, "runs,failedRuns,hours,visitors,shows,missed,missedRate,falseTriggers,"
+                 "falsePerHour,unsafeShows,latencyMeanMs,latencyP50Ms,latencyP95Ms\n");
+
+    for (set = 0; set < sweepSetCount; set++) {
+        runs = failed = visitors = missed = falseTriggers = unsafe = shows = 0;
+        hours = 0.0;
+        latencySum = 0.0;
+        latencyCount = 0;
+
+        for (trace = 0; trace < sweepTraceCount; trace++) {
+            const Sweep_Job *job = &sweepJobs[set * sweepTraceCount + trace];
+
+            runs++;
+            if (!job->score.ok) {
+                failed++;
+                continue;
+            }
+            hours += sweepTraces[trace].runNs / 3600.0e9;
+            visitors += job->score.visitors;
+            missed += job->score.missed;
+            falseTriggers += job->score.falseTriggers;
+            unsafe += job->score.unsafe;
+            shows += job->score.shows;
+            latencies = Sim_alloc("sweep", latencies, (latencyCount + job->score.latencies + 1) * sizeof(uint32_t));
+            for (value = 0; value < job->score.latencies; value++) {
+                latencies[latencyCount++] = job->latencies[value];
+                latencySum += job->latencies[value];
+            }
+        }
+        qsort(latencies, latencyCount, sizeof(uint32_t), sweepCompareU32);
+
+        index = set;
+        {
+            int columns[SWEEP_PARAMS];
+
+            for (param = SWEEP_PARAMS; param-- > 0;) {
+                columns[param] = sweepParams[param].values[index % sweepParams[param].count];
+                index /= sweepParams[param].count;
+            }
+            for (param = 0; param < SWEEP_PARAMS; param++) {
+                fprintf(out, "%d,", columns[param]);
+            }
+        }
+        fprintf(out, "%u,%u,%.2f,%u,%u,%u,%.4f,%u,%.3f,%u,",
+                runs, failed, hours, visitors, shows, missed,
+                (visitors != 0) ? (double)missed / visitors : 0.0,
+                falseTriggers, (hours > 0.0) ? falseTriggers / hours : 0.0, unsafe);
+        if (latencyCount != 0) {
+            fprintf(out, "%.0f,%u,%u\n", latencySum / latencyCount,
+                    latencies[(latencyCount - 1) / 2], latencies[(latencyCount * 95 + 99) / 100 - 1]);
+        }
+        else {
+            fprintf(out, ",,\n");
+        }
+    }
+
+    free(latencies);
+}
+
+/*
+ *  ======== sweepUsage ========
+ */
+static void sweepUsage(void)
+{
+    fprintf(stderr,
+            "usage: werewolf_sweep [--min LIST] [--max LIST] [--hits LIST] [--ping LIST]\n"
+            "                      [--reset LIST] [--rising LIST] [--lowering LIST]\n"
+            "                      [--missing LIST] [--spurious LIST] [--stuck LIST]\n"
+            "                      [--jitter LIST] [--trace FILE]...\n"
+            "                      [--synthetic N] [--hours H] [--seed S] [-j JOBS]\n"
+            "                      [-o FILE]\n"
+            "       LIST is a,b,c or first:last:step\n");
+    exit(EXIT_FAILURE);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(int argc, char *argv[])
+{
+    pthread_t  *threads;
+    FILE       *out = stdout;
+    const char *outPath = NULL;
+    unsigned    synthetic = 0;
+    double      hours = 1.0;
+    uint64_t    seed = 1;
+    long        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t      worker;
+    size_t      job;
+    size_t      param;
+    unsigned    index;
+    int         arg;
+
+    sweepWorkers = (cpus > 0) ? (size_t)cpus : 1;
+    for (param = 0; param < SWEEP_PARAMS; param++) {
+        sweepParams[param].values[0] = *sweepParams[param].value;
+        sweepParams[param].count = 1;
+    }
+
+    for (arg = 1; arg < argc; arg++) {
+        const char *value = (arg + 1 < argc) ? argv[arg + 1] : NULL;
+        bool        matched = false;
+
+        for (param = 0; param < SWEEP_PARAMS && value != NULL; param++) {
+            if (strcmp(argv[arg], sweepParams[param].option) == 0) {
+                sweepParseList(&sweepParams[param], value);
+                matched = true;
+            }
+        }
+        if (matched) {
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--trace") == 0 && value != NULL) {
+            sweepReadTrace(value);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--synthetic") == 0 && value != NULL) {
+            synthetic = (unsigned)strtoul(value, NULL, 0);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--hours") == 0 && value != NULL) {
+            hours = strtod(value, NULL);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--seed") == 0 && value != NULL) {
+            seed = strtoull(value, NULL, 0);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-j") == 0 && value != NULL) {
+            sweepWorkers = (size_t)strtoul(value, NULL, 0);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "-o") == 0 && value != NULL) {
+            outPath = value;
+            arg++;
+        }
+        else {
+            sweepUsage();
+        }
+    }
+
+    if (sweepTraceCount == 0 && synthetic == 0) {
+        synthetic = 4;
+    }
+    for (index = 0; index < synthetic; index++) {
+        sweepSynthesize(index, hours, seed);
+    }
+    if (sweepWorkers == 0) {
+        sweepWorkers = 1;
+    }
+
+    sweepSetCount = 1;
+    for (param = 0; param < SWEEP_PARAMS; param++) {
+        sweepSetCount *= sweepParams[param].count;
+    }
+    sweepJobCount = sweepSetCount * sweepTraceCount;
+    sweepJobs = Sim_alloc("sweep", NULL, sweepJobCount * sizeof(Sweep_Job));
+    for (job = 0; job < sweepJobCount; job++) {
+        sweepJobs[job].set = job / sweepTraceCount;
+        sweepJobs[job].trace = job % sweepTraceCount;
+        sweepJobs[job].latencies = NULL;
+    }
+
+    /* deal the runs out in contiguous blocks; stealing evens out the rest */
+    sweepDeques = Sim_alloc("sweep", NULL, sweepWorkers * sizeof(Sweep_Deque));
+    for (worker = 0; worker < sweepWorkers; worker++) {
+        size_t first = sweepJobCount * worker / sweepWorkers;
+        size_t last = sweepJobCount * (worker + 1) / sweepWorkers;
+
+        pthread_mutex_init(&sweepDeques[worker].lock, NULL);
+        sweepDeques[worker].jobs = Sim_alloc("sweep", NULL, (last - first) * sizeof(size_t));
+        sweepDeques[worker].head = 0;
+        sweepDeques[worker].tail = 0;
+        for (job = first; job < last; job++) {
+            sweepDeques[worker].jobs[sweepDeques[worker].tail++] = job;
+        }
+    }
+
+    fprintf(stderr, "sweep: %zu parameter sets x %zu traces on %zu workers\n",
+            sweepSetCount, sweepTraceCount, sweepWorkers);
+    fflush(stderr);
+    fflush(stdout);
+    sweepStartRunners();
+
+    threads = Sim_alloc("sweep", NULL, sweepWorkers * sizeof(pthread_t));
+    for (worker = 0; worker < sweepWorkers; worker++) {
+        if (pthread_create(&threads[worker], NULL, sweepWorker, (void *)(uintptr_t)worker) != 0) {
+            Sim_fail("sweep", "cannot start worker threads", NULL);
+        }
+    }
+    for (worker = 0; worker < sweepWorkers; worker++) {
+        pthread_join(threads[worker], NULL);
+    }
+    sweepStopRunners();
+    fprintf(stderr, "\n");
+
+    if (outPath != NULL && (out = fopen(outPath, "w")) == NULL) {
+        Sim_fail("sweep", "cannot create", outPath);
+    }
+    sweepReport(out);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,72 @@
+/*
+ *  ======== uartLinkPty.c ========
+ *  UartLink port for a Linux host: frames go to a pseudo-terminal instead
+ *  of UART0, so the same reader that opens the LaunchPad's COM port can
+ *  open the printed /dev/pts path.
+ *
+ *  The master side is non-blocking. A frame that does not fit is dropped
+ *  and counted, like a host that stops reading the real UART.
+ *
+ *  The simulator only opens the pty when Sim_Options.uartPty is set, so
+ *  batch runs do not each leave a terminal behind.
+ */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include "uartLink.h"
+#include "sim.h"
+
+static int uartLinkPtyFd = -1;
+
+/* frames the pty had no room for */
+unsigned long uartLinkPtyFramesLost = 0;
+
+/*
+ *  ======== UartLink_portOpen ========
+ */
+bool UartLink_portOpen(void)
+{
+    struct termios raw;
+
+    if (!Sim_options()->uartPty) {
+        return (false);
+    }
+
+    uartLinkPtyFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (uartLinkPtyFd < 0 || grantpt(uartLinkPtyFd) != 0 || unlockpt(uartLinkPtyFd) != 0) {
+        return (false);
+    }
+
+    /* binary stream - no newline translation or echo */
+    if (tcgetattr(uartLinkPtyFd, &raw) == 0) {
+        cfmakeraw(&raw);
+        tcsetattr(uartLinkPtyFd, TCSANOW, &raw);
+    }
+
+    fprintf(stderr, "uartLink: trace stream on %s\n", ptsname(uartLinkPtyFd));
+
+    return (true);
+}
+
+/*
+ *  ======== UartLink_portSend ========
+ */
+void UartLink_portSend(const void *buf, size_t len)
+{
+    ssize_t written = write(uartLinkPtyFd, buf, len);
+
+    if (written != (ssize_t)len) {
+        uartLinkPtyFramesLost++;
+    }
+
+    UartLink_txDone();
+}
@@ -0,0 +1,51 @@
+/*
+ *  ======== werewolfParams.h ========
+ *  werewolf.c's trigger and show parameters, for the host tools that run
+ *  it or reason about it (sweep.c, slo.c, fleet.c, replay.c).
+ *
+ *  The TUNABLE ones are writable in the host build (-DTUNABLE= in the
+ *  Makefile); the rest are const on the host as on the board.
+ */
+
+#ifndef __WEREWOLFPARAMS_H
+#define __WEREWOLFPARAMS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* TUNABLE */
+extern int       minTriggerDistance;
+extern int       maxTriggerDistance;
+extern int       requiredHitCount;
+extern int       pingIntervalMillis;
+extern int       resetMillis;
+extern int       lengthOfRisingMode;
+extern int       lengthOfLoweringingMode;
+
+extern const int headLiftMillisForHowlingMode;
+extern const int lengthOfHowlMillis;
+extern const int lengthOfHowlingMode;
+
+/*!
+ *  @brief  werewolf.c's main, renamed by -Dmain=werewolf_main
+ */
+extern int werewolf_main(void);
+
+/*!
+ *  @brief  What distSensorFxn sleeps through after a trigger, ms - the
+ *          show and the lockout after it, with the parameters as set now
+ */
+static inline uint32_t WerewolfParams_showMillis(void)
+{
+    return ((uint32_t)(lengthOfRisingMode + headLiftMillisForHowlingMode + lengthOfHowlMillis +
+                       lengthOfHowlingMode + lengthOfLoweringingMode + resetMillis));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WEREWOLFPARAMS_H */
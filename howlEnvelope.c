@@ -0,0 +1,37 @@
+/*
+ *  ======== howlEnvelope.c ========
+ *  Generated by tools/howl_envelope.py from --synthetic - do not edit.
+ */
+
+#include <stdint.h>
+
+#include "howlEnvelope.h"
+
+/* Place into subsections to allow the TI linker to remove items properly */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_SECTION(howlEnvelope, ".const:howlEnvelope")
+#endif
+
+const uint16_t howlEnvelopeFrames = 300;
+
+const uint8_t howlEnvelope[] = {
+      0,   0,  15,  23,  31,  40,  49,  58,  68,  76,  85,  93, 100, 107, 113, 118,
+    122, 126, 129, 130, 132, 133, 133, 134, 135, 136, 137, 140, 143, 148, 154, 156,
+    160, 164, 170, 177, 184, 192, 200, 208, 217, 225, 232, 238, 244, 249, 252, 254,
+    255, 254, 253, 249, 245, 239, 233, 226, 218, 210, 201, 193, 185, 178, 171, 165,
+    160, 157, 154, 153, 153, 155, 158, 162, 167, 174, 181, 188, 196, 205, 213, 221,
+    229, 236, 242, 247, 251, 253, 255, 255, 254, 251, 247, 242, 236, 229, 222, 214,
+    205, 197, 189, 181, 174, 168, 162, 158, 155, 153, 153, 154, 156, 160, 165, 171,
+    177, 185, 193, 201, 209, 217, 225, 232, 239, 244, 249, 252, 254, 255, 254, 252,
+    249, 244, 239, 232, 225, 217, 209, 201, 193, 185, 177, 171, 165, 160, 156, 154,
+    153, 153, 155, 158, 162, 168, 174, 181, 189, 197, 205, 214, 222, 229, 236, 242,
+    247, 251, 254, 255, 255, 253, 251, 247, 242, 236, 229, 221, 213, 205, 196, 188,
+    181, 174, 167, 162, 158, 155, 153, 153, 154, 157, 160, 165, 171, 178, 185, 193,
+    201, 210, 218, 226, 233, 239, 245, 249, 253, 254, 255, 254, 252, 249, 244, 238,
+    232, 225, 217, 208, 200, 192, 184, 177, 170, 164, 160, 156, 154, 153, 153, 155,
+    158, 163, 166, 170, 174, 179, 184, 189, 194, 198, 202, 205, 207, 208, 208, 206,
+    204, 200, 196, 190, 184, 177, 169, 161, 153, 144, 136, 128, 120, 113, 106, 100,
+     95,  90,  87,  84,  82,  80,  79,  79,  79,  80,  81,  82,  83,  84,  84,  85,
+     84,  84,  83,  82,  80,  77,  75,  71,  68,  64,  60,  55,  51,  46,  42,  37,
+     33,  29,  26,  22,  19,  16,  13,   0,   0,   0,   0,   0,
+};
@@ -0,0 +1,32 @@
+/*
+ *  ======== howlEnvelope.h ========
+ *  Loudness of the howl sound, one value per frame, for the mouth servo.
+ *
+ *  howlEnvelope.c is generated by tools/howl_envelope.py from the same WAV
+ *  that is loaded on the sound board; regenerate it whenever the sound
+ *  changes. Frame 0 is the moment howlingPin is pulled low.
+ */
+
+#ifndef __HOWLENVELOPE_H
+#define __HOWLENVELOPE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* must match FRAME_MILLIS in tools/howl_envelope.py */
+#define HowlEnvelope_FRAME_MILLIS   20
+
+/* envelope values run from 0 (silent, mouth closed) to this (mouth fully open) */
+#define HowlEnvelope_MAX            255
+
+extern const uint16_t howlEnvelopeFrames;
+extern const uint8_t  howlEnvelope[];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOWLENVELOPE_H */
@@ -0,0 +1,207 @@
+/*
+ *  ======== latency.c ========
+ *  Trigger-to-actuation latency - see latency.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "cycles.h"
+#include "latency.h"
+#include "trace.h"
+
+#if Latency_ENABLED
+
+typedef struct Latency_Running {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} Latency_Running;
+
+static uint32_t        latencyStamps[Latency_COUNT];   /* current episode */
+static uint32_t        latencyNext = Latency_COUNT;    /* checkpoint expected next */
+static uint32_t        latencyCount;                   /* episodes that reached Latency_FirstGpio */
+static uint32_t        latencyPwmCount;                /* and of those, Latency_FirstPwm */
+static uint32_t        latencyAbandoned;
+static Latency_Running latencyRunning[Latency_COUNT];
+static uint32_t        latencyWindow[Latency_WINDOW][Latency_COUNT];
+static uint32_t        latencyRanked[Latency_WINDOW];  /* Latency_getStats' copy of one column */
+
+/*
+ *  ======== latencyFold ========
+ *  Add one checkpoint of the current episode to the statistics, count
+ *  being the episodes already in them; scheduler locked
+ */
+static void latencyFold(uint32_t checkpoint, uint32_t count)
+{
+    Latency_Running *running = &latencyRunning[checkpoint];
+    uint32_t         elapsed = latencyStamps[checkpoint] - latencyStamps[Latency_EchoEdge];
+
+    if (count == 0 || elapsed < running->min) {
+        running->min = elapsed;
+    }
+    if (elapsed > running->max) {
+        running->max = elapsed;
+    }
+    running->sum += elapsed;
+    latencyWindow[count % Latency_WINDOW][checkpoint] = elapsed;
+}
+
+/*
+ *  ======== Latency_init ========
+ */
+void Latency_init(void)
+{
+    Cycles_init();
+}
+
+/*
+ *  ======== Latency_mark ========
+ */
+void Latency_mark(Latency_Checkpoint checkpoint)
+{
+    uint32_t now = Cycles_get();
+    bool     completed = false;
+    uint32_t toGpio = 0;
+    uint32_t toPwm = 0;
+    uint32_t i;
+    UInt     key;
+
+    key = Task_disable();
+
+    if (checkpoint == Latency_EchoEdge) {
+        if (latencyNext > Latency_TriggerConfirmed && latencyNext <= Latency_FirstGpio) {
+            latencyAbandoned++;
+        }
+        latencyStamps[Latency_EchoEdge] = now;
+        latencyNext = Latency_SampleAccepted;
+    }
+    else if (checkpoint == latencyNext) {
+        latencyStamps[checkpoint] = now;
+        latencyNext++;
+        if (checkpoint == Latency_FirstGpio) {
+            for (i = Latency_SampleAccepted; i <= Latency_FirstGpio; i++) {
+                latencyFold(i, latencyCount);
+            }
+            latencyCount++;
+        }
+        else if (checkpoint == Latency_FirstPwm) {
+            latencyFold(Latency_FirstPwm, latencyPwmCount);
+            latencyPwmCount++;
+            toGpio = latencyStamps[Latency_FirstGpio] - latencyStamps[Latency_EchoEdge];
+            toPwm = latencyStamps[Latency_FirstPwm] - latencyStamps[Latency_EchoEdge];
+            completed = true;
+        }
+    }
+
+    Task_restore(key);
+
+    if (completed) {
+        Trace_event(Trace_Latency, toGpio, toPwm);
+    }
+}
+
+/*
+ *  ======== Latency_endRising ========
+ */
+void Latency_endRising(void)
+{
+    bool     completed = false;
+    uint32_t toGpio = 0;
+    UInt     key = Task_disable();
+
+    if (latencyNext == Latency_FirstPwm) {
+        toGpio = latencyStamps[Latency_FirstGpio] - latencyStamps[Latency_EchoEdge];
+        latencyNext = Latency_COUNT;
+        completed = true;
+    }
+
+    Task_restore(key);
+
+    if (completed) {
+        Trace_event(Trace_Latency, toGpio, 0);
+    }
+}
+
+/*
+ *  ======== Latency_getStats ========
+ *  The window column is copied out with the scheduler locked and ranked
+ *  after it is released, in a static copy rather than on the 512-byte
+ *  task stacks.
+ */
+void Latency_getStats(Latency_Checkpoint checkpoint, Latency_Stats *stats)
+{
+    Latency_Running running;
+    uint32_t        count;
+    uint32_t        samples;
+    uint32_t        rank;
+    uint32_t        i;
+    uint32_t        j;
+    UInt            key;
+
+    memset(stats, 0, sizeof(*stats));
+
+    key = Task_disable();
+
+    count = (checkpoint == Latency_FirstPwm) ? latencyPwmCount : latencyCount;
+    stats->count = count;
+    stats->abandoned = latencyAbandoned;
+    if (checkpoint == Latency_EchoEdge || count == 0) {
+        Task_restore(key);
+        return;
+    }
+
+    running = latencyRunning[checkpoint];
+    samples = (count < Latency_WINDOW) ? count : Latency_WINDOW;
+    for (i = 0; i < samples; i++) {
+        latencyRanked[i] = latencyWindow[i][checkpoint];
+    }
+
+    Task_restore(key);
+
+    stats->min = running.min;
+    stats->max = running.max;
+    stats->avg = (uint32_t)(running.sum / count);
+
+    /* nearest rank: smallest sample with at least ceil(0.99 n) samples <= it */
+    rank = (samples * 99 + 99) / 100;
+    stats->p99 = UINT32_MAX;
+    for (i = 0; i < samples; i++) {
+        uint32_t candidate = latencyRanked[i];
+        uint32_t atOrBelow = 0;
+
+        if (candidate >= stats->p99) {
+            continue;
+        }
+        for (j = 0; j < samples; j++) {
+            if (latencyRanked[j] <= candidate) {
+                atOrBelow++;
+            }
+        }
+        if (atOrBelow >= rank) {
+            stats->p99 = candidate;
+        }
+    }
+}
+
+/*
+ *  ======== Latency_reset ========
+ */
+void Latency_reset(void)
+{
+    UInt key = Task_disable();
+
+    latencyNext = Latency_COUNT;
+    latencyCount = 0;
+    latencyPwmCount = 0;
+    latencyAbandoned = 0;
+    memset(latencyRunning, 0, sizeof(latencyRunning));
+
+    Task_restore(key);
+}
+
+#endif /* Latency_ENABLED */
@@ -0,0 +1,121 @@
+/*
+ *  ======== latency.h ========
+ *  Trigger-to-actuation latency: checkpoints along the path from the echo
+ *  edge to the first servo movement.
+ *
+ *  Latency_mark() stamps a checkpoint with the cycle counter (cycles.h).
+ *  An echo edge starts a new episode; each later checkpoint counts only if
+ *  it follows the previous one, and only the first time it is reached.
+ *  Reaching Latency_FirstGpio completes an episode: the time from the echo
+ *  edge to every checkpoint up to it is folded into the running
+ *  statistics. An episode that confirms a trigger and is then replaced by
+ *  a new echo edge before it gets there is counted as abandoned.
+ *
+ *  Latency_FirstPwm is only taken while the show is still rising, up to
+ *  Latency_endRising(): a servo the trigger moves (the head going down to
+ *  look), not the first move of the show's script (the mouth at the howl,
+ *  seconds later). Servo_setAngle can mark every update and just the
+ *  first one in time is taken. With no head task running no servo moves
+ *  then, so Latency_FirstPwm counts fewer episodes than the rest. Either
+ *  way, one Trace_Latency record per episode is written once the rising
+ *  phase is over or a servo has moved, its second argument 0 if none did.
+ *
+ *  p99 is exact over the last Latency_WINDOW episodes (nearest rank).
+ *  All calls are for Task context; Latency_getStats ranks in a static copy,
+ *  so call it from one task at a time.
+ *
+ *  On the host the platform layer supplies Cycles_get() from the simulated
+ *  clock, so the same figures come out of a simulation run.
+ *
+ *  Build with --define=Latency_ENABLED=0 to compile every call away.
+ */
+
+#ifndef __LATENCY_H
+#define __LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef Latency_ENABLED
+#define Latency_ENABLED     1
+#endif
+
+/* episodes kept for the p99 */
+#ifndef Latency_WINDOW
+#define Latency_WINDOW      100
+#endif
+
+/*!
+ *  @def    Latency_Checkpoint
+ *  @brief  Points along the trigger path, in the order they must be reached
+ */
+typedef enum Latency_Checkpoint {
+    Latency_EchoEdge = 0,       /* echo pulse ended - the distance is known */
+    Latency_SampleAccepted,     /* the distance is inside the trigger window */
+    Latency_TriggerConfirmed,   /* decided to start the show */
+    Latency_StateTransition,    /* state is RisingMode */
+    Latency_FirstGpio,          /* transistorGatePin driven */
+    Latency_FirstPwm,           /* first servo update afterwards, while still rising */
+
+    Latency_COUNT
+} Latency_Checkpoint;
+
+/*!
+ *  @def    Latency_Stats
+ *  @brief  Time from the echo edge to one checkpoint, in CPU cycles
+ */
+typedef struct Latency_Stats {
+    uint32_t count;         /* completed episodes that reached the checkpoint */
+    uint32_t abandoned;     /* episodes triggered but never completed */
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+} Latency_Stats;
+
+#if Latency_ENABLED
+
+/*!
+ *  @brief  Start the cycle counter
+ */
+extern void Latency_init(void);
+
+/*!
+ *  @brief  Stamp a checkpoint
+ */
+extern void Latency_mark(Latency_Checkpoint checkpoint);
+
+/*!
+ *  @brief  The show has left its rising phase; servo updates from now on
+ *          are not the reaction to the trigger
+ */
+extern void Latency_endRising(void);
+
+/*!
+ *  @brief  Statistics for one checkpoint; Latency_EchoEdge is all zero
+ */
+extern void Latency_getStats(Latency_Checkpoint checkpoint, Latency_Stats *stats);
+
+/*!
+ *  @brief  Forget every episode
+ */
+extern void Latency_reset(void);
+
+#else
+
+#define Latency_init()
+#define Latency_mark(checkpoint)
+#define Latency_endRising()
+#define Latency_getStats(checkpoint, stats)
+#define Latency_reset()
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LATENCY_H */
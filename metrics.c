@@ -0,0 +1,64 @@
+/*
+ *  ======== metrics.c ========
+ *  Event counters - see metrics.h.
+ */
+
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "metrics.h"
+#include "trace.h"
+
+#define METRICS_PERIOD_TICKS    ((Metrics_PERIOD_MILLIS * 1000) / Clock_tickPeriod)
+
+volatile uint32_t metricsCounters[Metrics_COUNT];
+volatile uint32_t metricsGeneration;
+
+static Clock_Struct metricsClockStruct;
+
+/*
+ *  ======== metricsClockFxn ========
+ */
+static Void metricsClockFxn(UArg arg)
+{
+    Metrics_Snapshot snapshot;
+    uint32_t         counter;
+
+    Metrics_snapshot(&snapshot);
+    for (counter = 0; counter < Metrics_COUNT; counter++) {
+        Trace_event(Trace_Metrics, counter, snapshot.counters[counter]);
+    }
+}
+
+/*
+ *  ======== Metrics_init ========
+ */
+void Metrics_init(void)
+{
+    Clock_Params clockParams;
+
+    Clock_Params_init(&clockParams);
+    clockParams.period = METRICS_PERIOD_TICKS;
+    clockParams.startFlag = TRUE;
+    Clock_construct(&metricsClockStruct, metricsClockFxn, METRICS_PERIOD_TICKS, &clockParams);
+}
+
+/*
+ *  ======== Metrics_snapshot ========
+ *  Increments are atomic, so an unchanged generation means no increment
+ *  landed while the table was being copied.
+ */
+void Metrics_snapshot(Metrics_Snapshot *snapshot)
+{
+    uint32_t generation;
+    uint32_t counter;
+
+    do {
+        generation = metricsGeneration;
+        for (counter = 0; counter < Metrics_COUNT; counter++) {
+            snapshot->counters[counter] = metricsCounters[counter];
+        }
+    } while (generation != metricsGeneration);
+}
@@ -0,0 +1,84 @@
+/*
+ *  ======== metrics.h ========
+ *  On-device event counters for tuning the trigger from field data.
+ *
+ *  Metrics_increment() is atomic: the read-modify-write runs with
+ *  interrupts masked for a few cycles, so it is safe from any context.
+ *  Each increment also bumps a generation count, which lets
+ *  Metrics_snapshot() take a consistent copy of the whole table without
+ *  locking - it copies, and copies again if the generation moved.
+ *
+ *  Metrics_init() starts a periodic Trace_Metrics report (one record per
+ *  counter) so the totals reach the UART link and the host decoder.
+ */
+
+#ifndef __METRICS_H
+#define __METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#ifndef Metrics_PERIOD_MILLIS
+#define Metrics_PERIOD_MILLIS   10000
+#endif
+
+/*!
+ *  @def    Metrics_Counter
+ *
+ *  NOTE: IDs appear in Trace_Metrics records - append new counters at the end.
+ */
+typedef enum Metrics_Counter {
+    Metrics_Pings = 0,          /* distance measurements attempted */
+    Metrics_EchoTimeouts,       /* pulseDuration gave up */
+    Metrics_InWindowSamples,    /* distance inside the trigger window */
+    Metrics_ConfirmedTriggers,  /* shows started */
+    Metrics_AbortedShows,       /* shows cut short by a crash (counted at the next boot) */
+    Metrics_SolenoidCycles,     /* transistorGatePin on and off again */
+
+    Metrics_COUNT
+} Metrics_Counter;
+
+/*!
+ *  @def    Metrics_Snapshot
+ */
+typedef struct Metrics_Snapshot {
+    uint32_t counters[Metrics_COUNT];
+} Metrics_Snapshot;
+
+extern volatile uint32_t metricsCounters[Metrics_COUNT];
+extern volatile uint32_t metricsGeneration;
+
+/*!
+ *  @brief  Start the periodic report
+ */
+extern void Metrics_init(void);
+
+/*!
+ *  @brief  Consistent copy of every counter, without locking
+ */
+extern void Metrics_snapshot(Metrics_Snapshot *snapshot);
+
+/*
+ *  ======== Metrics_increment ========
+ */
+static inline void Metrics_increment(Metrics_Counter counter)
+{
+    UInt key = Hwi_disable();
+
+    metricsCounters[counter]++;
+    metricsGeneration++;
+
+    Hwi_restore(key);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __METRICS_H */
@@ -0,0 +1,135 @@
+/*
+ *  ======== motion.c ========
+ *  Layered motion mixer - see motion.h.
+ */
+
+#include <stdint.h>
+
+#include "servo.h"
+#include "easing.h"
+#include "motion.h"
+
+/* on average one twitch every 64 ticks (a few seconds at 40 ms) */
+#define MOTION_TWITCH_MASK  0x3F
+
+typedef struct Motion_ChannelState {
+    Servo_Angle  layer[Motion_LAYERS];
+    uint16_t     weight[Motion_LAYERS];
+    Servo_Angle  minAngle;
+    Servo_Angle  maxAngle;
+    Servo_Angle  lastAngle;
+
+    /* noise generator */
+    Easing_Phase bobPhase;
+    Easing_Phase bobPhaseInc;
+    Servo_Angle  bobAngle;
+    Servo_Angle  twitchAngle;
+    Servo_Angle  twitch;
+} Motion_ChannelState;
+
+static Motion_ChannelState motionChannels[Servo_COUNT] = {
+    {
+        .weight = {Motion_WEIGHT_ONE, Motion_WEIGHT_ONE, Motion_WEIGHT_ONE},
+        .minAngle = Servo_ANGLE_MIN,
+        .maxAngle = Servo_ANGLE_MAX,
+        .lastAngle = -1
+    },
+    {
+        .weight = {Motion_WEIGHT_ONE, Motion_WEIGHT_ONE, Motion_WEIGHT_ONE},
+        .minAngle = Servo_ANGLE_MIN,
+        .maxAngle = Servo_ANGLE_MAX,
+        .lastAngle = -1
+    },
+    {
+        .weight = {Motion_WEIGHT_ONE, Motion_WEIGHT_ONE, Motion_WEIGHT_ONE},
+        .minAngle = Servo_ANGLE_MIN,
+        .maxAngle = Servo_ANGLE_MAX,
+        .lastAngle = -1
+    }
+};
+
+/* xorshift32 shared by all channels - a race between tasks only reshuffles it */
+static uint32_t motionRandom = 0x2545F491;
+
+/*
+ *  ======== Motion_setLimits ========
+ */
+void Motion_setLimits(Servo_Channel channel, Servo_Angle minAngle, Servo_Angle maxAngle)
+{
+    motionChannels[channel].minAngle = minAngle;
+    motionChannels[channel].maxAngle = maxAngle;
+}
+
+/*
+ *  ======== Motion_setLayer ========
+ */
+void Motion_setLayer(Servo_Channel channel, Motion_Layer layer, Servo_Angle value)
+{
+    motionChannels[channel].layer[layer] = value;
+}
+
+/*
+ *  ======== Motion_setWeight ========
+ */
+void Motion_setWeight(Servo_Channel channel, Motion_Layer layer, uint16_t weight)
+{
+    motionChannels[channel].weight[layer] = weight;
+}
+
+/*
+ *  ======== Motion_setNoise ========
+ */
+void Motion_setNoise(Servo_Channel channel, Servo_Angle bobAngle, int bobMillis,
+                     Servo_Angle twitchAngle, int tickMillis)
+{
+    Motion_ChannelState *ch = &motionChannels[channel];
+
+    ch->bobAngle = bobAngle;
+    ch->bobPhaseInc = (bobMillis > 0) ? Easing_phaseStep(bobMillis, tickMillis) : 0;
+    ch->twitchAngle = twitchAngle;
+    ch->twitch = 0;
+}
+
+/*
+ *  ======== Motion_update ========
+ */
+Servo_Angle Motion_update(Servo_Channel channel)
+{
+    Motion_ChannelState *ch = &motionChannels[channel];
+    int32_t mixed;
+
+    /* noise layer: a slow breath plus the tail of the latest twitch */
+    motionRandom ^= motionRandom << 13;
+    motionRandom ^= motionRandom >> 17;
+    motionRandom ^= motionRandom << 5;
+    if ((motionRandom & MOTION_TWITCH_MASK) == 0) {
+        ch->twitch = (motionRandom & 0x80000000) ? ch->twitchAngle : -ch->twitchAngle;
+    }
+    else {
+        ch->twitch = (ch->twitch * 3) / 4;
+    }
+    ch->bobPhase += ch->bobPhaseInc;
+    ch->layer[Motion_Noise] = ch->twitch +
+        Easing_lerp(Easing_Sine, ch->bobPhase, -ch->bobAngle, ch->bobAngle);
+
+    mixed = ((int32_t)ch->layer[Motion_Base]     * ch->weight[Motion_Base] +
+             (int32_t)ch->layer[Motion_Noise]    * ch->weight[Motion_Noise] +
+             (int32_t)ch->layer[Motion_Tracking] * ch->weight[Motion_Tracking]) / Motion_WEIGHT_ONE;
+
+    if (mixed < ch->minAngle) {
+        mixed = ch->minAngle;
+    }
+    if (mixed > ch->maxAngle) {
+        mixed = ch->maxAngle;
+    }
+
+    if (mixed != ch->lastAngle) {
+        Servo_setAngle(channel, (Servo_Angle)mixed);
+        ch->lastAngle = (Servo_Angle)mixed;
+    }
+    else {
+        Servo_still(channel);
+    }
+
+    return (ch->lastAngle);
+}
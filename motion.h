@@ -0,0 +1,86 @@
+/*
+ *  ======== motion.h ========
+ *  Per-channel motion mixer.
+ *
+ *  Each servo channel has a fixed set of layers. The owning task writes the
+ *  base trajectory, the mixer generates the procedural noise layer itself,
+ *  and anything that wants to aim the head can write the tracking offset.
+ *  Motion_update() sums the weighted layers, clamps the result to the
+ *  channel's limits and hands it to Servo_setAngle().
+ *
+ *  All state is in a static table; an update costs the same few dozen
+ *  instructions whatever the layers contain.
+ */
+
+#ifndef __MOTION_H
+#define __MOTION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "servo.h"
+
+/* Layer weights are Q8 fixed point: 256 is 1.0 */
+#define Motion_WEIGHT_ONE   256
+
+/*!
+ *  @def    Motion_Layer
+ *  @brief  Layers summed for every channel
+ *
+ *  Motion_Base      absolute angle of the scripted move
+ *  Motion_Noise     offset generated by the mixer (breathing bob and twitches)
+ *  Motion_Tracking  offset towards whatever the prop is looking at
+ */
+typedef enum Motion_Layer {
+    Motion_Base = 0,
+    Motion_Noise,
+    Motion_Tracking,
+
+    Motion_LAYERS
+} Motion_Layer;
+
+/*!
+ *  @brief  Set the angles a channel may never leave
+ */
+extern void Motion_setLimits(Servo_Channel channel, Servo_Angle minAngle, Servo_Angle maxAngle);
+
+/*!
+ *  @brief  Set a layer's value; Motion_Noise is overwritten by the mixer
+ */
+extern void Motion_setLayer(Servo_Channel channel, Motion_Layer layer, Servo_Angle value);
+
+/*!
+ *  @brief  Set a layer's weight, Motion_WEIGHT_ONE being full strength
+ */
+extern void Motion_setWeight(Servo_Channel channel, Motion_Layer layer, uint16_t weight);
+
+/*!
+ *  @brief  Configure the procedural noise layer
+ *
+ *  @param  bobAngle        peak of the slow breathing bob, 0 for none
+ *  @param  bobMillis       length of one breath
+ *  @param  twitchAngle     size of a random twitch, 0 for none
+ *  @param  tickMillis      how often the channel's task calls Motion_update
+ */
+extern void Motion_setNoise(Servo_Channel channel, Servo_Angle bobAngle, int bobMillis,
+                            Servo_Angle twitchAngle, int tickMillis);
+
+/*!
+ *  @brief  Mix the layers, clamp, and drive the servo if the angle changed
+ *
+ *  An unchanged angle counts towards the channel's servo idle time.
+ *
+ *  Call once per tick from the task that owns the channel.
+ *
+ *  @return the angle the servo is now at
+ */
+extern Servo_Angle Motion_update(Servo_Channel channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOTION_H */
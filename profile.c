@@ -0,0 +1,175 @@
+/*
+ *  ======== profile.c ========
+ *  Profiling markers and latency histograms - see profile.h.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "cycles.h"
+#include "profile.h"
+#include "trace.h"
+
+#if Profile_ENABLED
+
+#define PROFILE_PERIOD_TICKS    ((Profile_PERIOD_MILLIS * 1000) / Clock_tickPeriod)
+
+typedef struct Profile_Histogram {
+    uint32_t count;
+    uint32_t max;
+    uint32_t buckets[Profile_BUCKETS];
+} Profile_Histogram;
+
+static Profile_Histogram profileHistograms[Profile_COUNT];
+static Clock_Struct      profileClockStruct;
+
+/*
+ *  ======== profileLog2 ========
+ *  Index of the highest set bit; 0 for 0
+ */
+static inline uint32_t profileLog2(uint32_t value)
+{
+    if (value == 0) {
+        return (0);
+    }
+#if defined(__TI_COMPILER_VERSION__)
+    return (31 - __clz(value));
+#elif defined(__GNUC__)
+    return (31 - __builtin_clz(value));
+#else
+    {
+        uint32_t bit = 0;
+
+        while (value >>= 1) {
+            bit++;
+        }
+        return (bit);
+    }
+#endif
+}
+
+/*
+ *  ======== profilePercentile ========
+ *  Bucket holding the sample at rank ceil(count * permille / 1000)
+ */
+static uint32_t profilePercentile(const Profile_Histogram *hist, uint32_t permille)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)hist->count * permille + 999) / 1000);
+    uint32_t seen = 0;
+    uint32_t bucket;
+
+    for (bucket = 0; bucket < Profile_BUCKETS - 1; bucket++) {
+        seen += hist->buckets[bucket];
+        if (seen >= rank) {
+            break;
+        }
+    }
+    return (bucket);
+}
+
+/*
+ *  ======== profileBucketTop ========
+ *  Largest duration a bucket can hold, capped at the observed maximum
+ */
+static inline uint32_t profileBucketTop(uint32_t bucket, uint32_t max)
+{
+    uint32_t top = (bucket >= 31) ? 0xFFFFFFFF : (2u << bucket) - 1;
+
+    return ((top < max) ? top : max);
+}
+
+/*
+ *  ======== profileClockFxn ========
+ *  One Trace_ProfileStats record per point that has samples
+ */
+static Void profileClockFxn(UArg arg)
+{
+    Profile_Histogram hist;
+    uint32_t          point;
+    UInt              key;
+
+    for (point = 0; point < Profile_COUNT; point++) {
+        key = Hwi_disable();
+        hist = profileHistograms[point];
+        Hwi_restore(key);
+
+        if (hist.count == 0) {
+            continue;
+        }
+        Trace_event(Trace_ProfileStats,
+                    point | (profilePercentile(&hist, 500) << 8)
+                          | (profilePercentile(&hist, 990) << 16),
+                    hist.max);
+    }
+}
+
+/*
+ *  ======== Profile_init ========
+ */
+void Profile_init(void)
+{
+    Clock_Params clockParams;
+
+    Cycles_init();
+
+    Clock_Params_init(&clockParams);
+    clockParams.period = PROFILE_PERIOD_TICKS;
+    clockParams.startFlag = TRUE;
+    Clock_construct(&profileClockStruct, profileClockFxn, PROFILE_PERIOD_TICKS, &clockParams);
+}
+
+/*
+ *  ======== Profile_record ========
+ */
+void Profile_record(Profile_Point point, uint32_t cycles)
+{
+    Profile_Histogram *hist = &profileHistograms[point];
+    uint32_t           bucket = profileLog2(cycles);
+    UInt               key;
+
+    key = Hwi_disable();
+
+    hist->count++;
+    hist->buckets[bucket]++;
+    if (cycles > hist->max) {
+        hist->max = cycles;
+    }
+
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== Profile_getStats ========
+ */
+void Profile_getStats(Profile_Point point, Profile_Stats *stats)
+{
+    Profile_Histogram hist;
+    UInt              key;
+
+    key = Hwi_disable();
+    hist = profileHistograms[point];
+    Hwi_restore(key);
+
+    stats->count = hist.count;
+    stats->max = hist.max;
+    stats->p50 = (hist.count != 0) ? profileBucketTop(profilePercentile(&hist, 500), hist.max) : 0;
+    stats->p99 = (hist.count != 0) ? profileBucketTop(profilePercentile(&hist, 990), hist.max) : 0;
+}
+
+/*
+ *  ======== Profile_reset ========
+ */
+void Profile_reset(void)
+{
+    UInt key = Hwi_disable();
+
+    memset(profileHistograms, 0, sizeof(profileHistograms));
+
+    Hwi_restore(key);
+}
+
+#endif /* Profile_ENABLED */
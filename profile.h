@@ -0,0 +1,109 @@
+/*
+ *  ======== profile.h ========
+ *  Begin/end profiling markers with on-device latency histograms.
+ *
+ *  Bracket a section with Profile_BEGIN(point) / Profile_END(point) in the
+ *  same block. The duration in CPU cycles (DWT CYCCNT, see cycles.h) goes
+ *  into a log2 histogram for that point - bucket n counts durations in
+ *  [2^n, 2^(n+1)) - so p50/p99/max come from Profile_getStats() without
+ *  streaming every sample. Profile_init() also starts a periodic
+ *  Trace_ProfileStats report so the numbers reach the host.
+ *
+ *  Percentiles are the upper edge of the bucket they fall in (at most 2x
+ *  pessimistic), capped at the exact maximum.
+ *
+ *  Build with --define=Profile_ENABLED=0 and the markers expand to nothing.
+ */
+
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "cycles.h"
+
+#ifndef Profile_ENABLED
+#define Profile_ENABLED         1
+#endif
+
+#ifndef Profile_PERIOD_MILLIS
+#define Profile_PERIOD_MILLIS   5000
+#endif
+
+/* one per bit of a cycle count */
+#define Profile_BUCKETS         32
+
+/*!
+ *  @def    Profile_Point
+ *  @brief  Profiled sections
+ *
+ *  NOTE: IDs appear in Trace_ProfileStats records - append new points at the end.
+ */
+typedef enum Profile_Point {
+    Profile_PulseDuration = 0,  /* echo measurement in distSensorFxn */
+    Profile_PwmUpdate,          /* Servo_setAngle */
+    Profile_GpioWrite,          /* writePin */
+    Profile_StateChange,        /* changeState */
+
+    Profile_COUNT
+} Profile_Point;
+
+/*!
+ *  @def    Profile_Stats
+ *  @brief  Summary of one point's histogram, in CPU cycles
+ */
+typedef struct Profile_Stats {
+    uint32_t count;
+    uint32_t p50;
+    uint32_t p99;
+    uint32_t max;
+} Profile_Stats;
+
+#if Profile_ENABLED
+
+#define Profile_BEGIN(point) \
+    uint32_t profileStart_##point = Cycles_get()
+
+#define Profile_END(point) \
+    Profile_record(point, Cycles_get() - profileStart_##point)
+
+/*!
+ *  @brief  Start the cycle counter and the periodic report
+ */
+extern void Profile_init(void);
+
+/*!
+ *  @brief  Add one duration to a point's histogram; callable from any context
+ */
+extern void Profile_record(Profile_Point point, uint32_t cycles);
+
+/*!
+ *  @brief  Summarise a point's histogram
+ */
+extern void Profile_getStats(Profile_Point point, Profile_Stats *stats);
+
+/*!
+ *  @brief  Empty every histogram
+ */
+extern void Profile_reset(void);
+
+#else
+
+#define Profile_BEGIN(point)
+#define Profile_END(point)
+#define Profile_init()
+#define Profile_record(point, cycles)
+#define Profile_getStats(point, stats)
+#define Profile_reset()
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROFILE_H */
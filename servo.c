@@ -0,0 +1,292 @@
+/*
+ *  ======== servo.c ========
+ *  Angle-to-pulse-width calibration and servo output.
+ *
+ *  Each channel has a small table of pulse widths (microseconds) at evenly
+ *  spaced angles. Between two points the pulse width is linearly
+ *  interpolated in integer math, so a lookup is one divide by a constant,
+ *  one multiply and two table reads.
+ *
+ *  Idle channels are parked with a 0 us pulse width, which stops the pulse
+ *  train at the next period boundary; the servo rail on servoPowerPin is
+ *  only cut when every open channel that has been driven is parked and
+ *  allows it. A channel opened but never moved has been sending no pulses
+ *  all along, so it does not hold the rail up.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/drivers/GPIO.h>
+#include <ti/drivers/PWM.h>
+
+#include "Board.h"
+#include "servo.h"
+#include "trace.h"
+#include "profile.h"
+#include "latency.h"
+
+/* Place into subsections to allow the TI linker to remove items properly */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_SECTION(servoCalTable, ".const:servoCalTable")
+#endif
+
+/*
+ * Pulse width at calibration point on the straight line through two
+ * measured (angle, pulse width) pairs, rounded towards the first
+ */
+#define SERVO_CAL_LINE(point, angle0, us0, angle1, us1) \
+    ((us0) + ((point) * Servo_CAL_STEP - (angle0)) * ((us1) - (us0)) / ((angle1) - (angle0)))
+
+#define SERVO_CAL_ROW(angle0, us0, angle1, us1) {       \
+    SERVO_CAL_LINE(0, angle0, us0, angle1, us1),        \
+    SERVO_CAL_LINE(1, angle0, us0, angle1, us1),        \
+    SERVO_CAL_LINE(2, angle0, us0, angle1, us1),        \
+    SERVO_CAL_LINE(3, angle0, us0, angle1, us1),        \
+    SERVO_CAL_LINE(4, angle0, us0, angle1, us1),        \
+    SERVO_CAL_LINE(5, angle0, us0, angle1, us1),        \
+    SERVO_CAL_LINE(6, angle0, us0, angle1, us1),        \
+    SERVO_CAL_LINE(7, angle0, us0, angle1, us1),        \
+    SERVO_CAL_LINE(8, angle0, us0, angle1, us1),        \
+}
+
+/*
+ * Pulse widths at 0, 22.5, 45 ... 180 degrees.
+ * NOTE: The order of the channels must coincide with Servo_Channel.
+ *
+ * UNCALIBRATED: only the duties the firmware already used have been seen
+ * on the prop; every other point is a straight line through them. Replace
+ * a row with measured widths once the horn has been checked against a
+ * protractor at each angle.
+ *
+ * Head turn: minDutyToLeftShoulder (750) at 0 degrees, centeredDuty (1500)
+ *            at 90 and maxDutyToRightShoulder (2000) at 180, with linear
+ *            spacing between each pair - so the right half is flatter.
+ * Head lift: headLiftDutyDown (700) at 18 degrees and headLiftDutyUp
+ *            (1700) at 108, extended to both ends.
+ * Mouth:     minDutyMouthOpen (750) at 22.5 degrees and maxDutyMouthClose
+ *            (2000) at 135, extended to both ends.
+ */
+#if Servo_CAL_POINTS != 9
+#error "servoCalTable rows are written out for 9 calibration points"
+#endif
+
+const uint16_t servoCalTable[Servo_COUNT][Servo_CAL_POINTS] = {
+    /* Servo_HeadSideToSide */
+    {
+        SERVO_CAL_LINE(0, 0, 750, 900, 1500),
+        SERVO_CAL_LINE(1, 0, 750, 900, 1500),
+        SERVO_CAL_LINE(2, 0, 750, 900, 1500),
+        SERVO_CAL_LINE(3, 0, 750, 900, 1500),
+        SERVO_CAL_LINE(4, 0, 750, 900, 1500),
+        SERVO_CAL_LINE(5, 900, 1500, 1800, 2000),
+        SERVO_CAL_LINE(6, 900, 1500, 1800, 2000),
+        SERVO_CAL_LINE(7, 900, 1500, 1800, 2000),
+        SERVO_CAL_LINE(8, 900, 1500, 1800, 2000),
+    },
+    /* Servo_HeadUpDown */
+    SERVO_CAL_ROW(180, 700, 1080, 1700),
+    /* Servo_MouthOpenClose */
+    SERVO_CAL_ROW(225, 750, 1350, 2000),
+};
+
+static const unsigned int servoPwmIndex[Servo_COUNT] = {
+    Board_HeadSideToSide_servo,
+    Board_HeadUpDown_servo,
+    Board_MouthOpenClose_servo,
+};
+
+typedef struct Servo_State {
+    PWM_Handle       handle;
+    Servo_IdlePolicy policy;
+    uint32_t         stillTicks;
+    uint32_t         lastMoveTick;
+    uint32_t         detachTick;
+    bool             driven;        /* set an angle since it was opened */
+    bool             detached;
+    Servo_Stats      stats;
+} Servo_State;
+
+static Servo_State servoStates[Servo_COUNT];
+
+static bool     servoRailOff = false;
+static uint32_t servoRailOffTick;
+static uint32_t servoRailOffMillis;
+
+/*
+ *  ======== servoTicksToMillis ========
+ */
+static uint32_t servoTicksToMillis(uint32_t ticks)
+{
+    return ((uint32_t)(((uint64_t)ticks * Clock_tickPeriod) / 1000));
+}
+
+/*
+ *  ======== servoAttach ========
+ *  Called with the new pulse width already loaded
+ */
+static void servoAttach(Servo_State *servo, uint32_t now)
+{
+    UInt key = Task_disable();
+
+    servo->detached = false;
+    Trace_event(Trace_ServoIdle, servo - servoStates, 0);
+    servo->stats.detachedMillis += servoTicksToMillis(now - servo->detachTick);
+
+    if (servoRailOff) {
+        GPIO_write(servoPowerPin, 1);
+        Trace_event(Trace_ServoRail, 1, 0);
+        servoRailOffMillis += servoTicksToMillis(now - servoRailOffTick);
+        servoRailOff = false;
+    }
+
+    Task_restore(key);
+}
+
+/*
+ *  ======== servoDetach ========
+ */
+static void servoDetach(Servo_State *servo, uint32_t now)
+{
+    unsigned int i;
+    bool         railCanGo = true;
+    UInt         key = Task_disable();
+
+    PWM_setDuty(servo->handle, 0);
+    servo->detached = true;
+    Trace_event(Trace_ServoIdle, servo - servoStates, 1);
+    servo->detachTick = now;
+    servo->stats.detachCount++;
+
+    for (i = 0; i < Servo_COUNT; i++) {
+        /* opened and never moved (an inactive task's), it has no pulses to stop */
+        if (servoStates[i].handle != NULL && servoStates[i].driven &&
+            (!servoStates[i].detached || servoStates[i].policy != Servo_IdlePowerOff)) {
+            railCanGo = false;
+        }
+    }
+    if (railCanGo && !servoRailOff) {
+        GPIO_write(servoPowerPin, 0);
+        Trace_event(Trace_ServoRail, 0, 0);
+        servoRailOff = true;
+        servoRailOffTick = now;
+    }
+
+    Task_restore(key);
+}
+
+/*
+ *  ======== Servo_open ========
+ */
+PWM_Handle Servo_open(Servo_Channel channel, uint16_t periodMicros)
+{
+    PWM_Params servoPwmParams;
+
+    PWM_Params_init(&servoPwmParams);
+    servoPwmParams.period = periodMicros;
+    servoStates[channel].handle = PWM_open(servoPwmIndex[channel], &servoPwmParams);
+    servoStates[channel].lastMoveTick = Clock_getTicks();
+    servoStates[channel].driven = false;
+
+    return (servoStates[channel].handle);
+}
+
+/*
+ *  ======== Servo_dutyForAngle ========
+ */
+uint16_t Servo_dutyForAngle(Servo_Channel channel, Servo_Angle angle)
+{
+    const uint16_t *points = servoCalTable[channel];
+    int32_t offset;
+    int32_t segment;
+    int32_t frac;
+
+    if (angle <= Servo_ANGLE_MIN) {
+        return (points[0]);
+    }
+    if (angle >= Servo_ANGLE_MAX) {
+        return (points[Servo_CAL_POINTS - 1]);
+    }
+
+    offset  = angle - Servo_ANGLE_MIN;
+    segment = offset / Servo_CAL_STEP;
+    frac    = offset - segment * Servo_CAL_STEP;
+
+    return ((uint16_t)(points[segment] +
+        ((int32_t)(points[segment + 1] - points[segment]) * frac) / Servo_CAL_STEP));
+}
+
+/*
+ *  ======== Servo_setAngle ========
+ */
+void Servo_setAngle(Servo_Channel channel, Servo_Angle angle)
+{
+    Servo_State *servo = &servoStates[channel];
+    uint32_t     now = Clock_getTicks();
+    uint16_t     duty = Servo_dutyForAngle(channel, angle);
+
+    Profile_BEGIN(Profile_PwmUpdate);
+    PWM_setDuty(servo->handle, duty);
+    Profile_END(Profile_PwmUpdate);
+    Trace_event(Trace_PwmDuty, channel, duty);
+    Latency_mark(Latency_FirstPwm);     /* ignored unless a trigger is in flight */
+    servo->lastMoveTick = now;
+    servo->driven = true;
+
+    if (servo->detached) {
+        servoAttach(servo, now);
+    }
+}
+
+/*
+ *  ======== Servo_setIdlePolicy ========
+ */
+void Servo_setIdlePolicy(Servo_Channel channel, Servo_IdlePolicy policy, uint32_t stillMillis)
+{
+    servoStates[channel].policy = policy;
+    servoStates[channel].stillTicks = (uint32_t)(((uint64_t)stillMillis * 1000) / Clock_tickPeriod);
+}
+
+/*
+ *  ======== Servo_still ========
+ */
+void Servo_still(Servo_Channel channel)
+{
+    Servo_State *servo = &servoStates[channel];
+    uint32_t     now;
+
+    if (servo->detached || servo->policy == Servo_IdleHold) {
+        return;
+    }
+
+    now = Clock_getTicks();
+    if (now - servo->lastMoveTick >= servo->stillTicks) {
+        servoDetach(servo, now);
+    }
+}
+
+/*
+ *  ======== Servo_getStats ========
+ */
+void Servo_getStats(Servo_Channel channel, Servo_Stats *stats)
+{
+    Servo_State *servo = &servoStates[channel];
+    uint32_t     now;
+    UInt         key = Task_disable();
+
+    now = Clock_getTicks();
+    *stats = servo->stats;
+    if (servo->detached) {
+        stats->detachedMillis += servoTicksToMillis(now - servo->detachTick);
+    }
+    stats->poweredOffMillis = servoRailOffMillis;
+    if (servoRailOff) {
+        stats->poweredOffMillis += servoTicksToMillis(now - servoRailOffTick);
+    }
+
+    Task_restore(key);
+}
@@ -0,0 +1,120 @@
+/*
+ *  ======== servo.h ========
+ *  Angle-based servo output for the werewolf.
+ *
+ *  Motion code in werewolf.c talks in angles (tenths of a degree, 0..1800).
+ *  Servo_setAngle() runs every request through a per-channel calibration
+ *  table before it reaches PWM_setDuty(), so an equal angle step gives an
+ *  equal step at the horn even though the servos are not linear in duty.
+ *
+ *  A servo that has been held still for its idle time stops receiving
+ *  pulses, and once every servo is idle the shared power rail on
+ *  servoPowerPin can be switched off too. The next Servo_setAngle()
+ *  re-engages it.
+ */
+
+#ifndef __SERVO_H
+#define __SERVO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <ti/drivers/PWM.h>
+
+/* Angles are in tenths of a degree; 900 is the servo's mechanical centre */
+typedef int16_t Servo_Angle;
+
+#define Servo_ANGLE_MIN     0
+#define Servo_ANGLE_MAX     1800
+
+/*
+ * Calibration points are spaced evenly across Servo_ANGLE_MIN..MAX so the
+ * segment lookup is a divide by a constant. Changing the point count only
+ * needs the tables in servo.c to grow or shrink to match.
+ */
+#define Servo_CAL_POINTS    9
+#define Servo_CAL_STEP      ((Servo_ANGLE_MAX - Servo_ANGLE_MIN) / (Servo_CAL_POINTS - 1))
+
+/*!
+ *  @def    Servo_Channel
+ *  @brief  The servos driven by the werewolf, in Board.h PWM order
+ */
+typedef enum Servo_Channel {
+    Servo_HeadSideToSide = 0,
+    Servo_HeadUpDown,
+    Servo_MouthOpenClose,
+
+    Servo_COUNT
+} Servo_Channel;
+
+/*!
+ *  @def    Servo_IdlePolicy
+ *  @brief  What a channel does after it has been still for its idle time
+ *
+ *  Servo_IdleHold      keep driving the last pulse width (holding torque)
+ *  Servo_IdleStopPwm   stop the pulses so the servo goes limp and quiet
+ *  Servo_IdlePowerOff  stop the pulses, and switch servoPowerPin off once
+ *                      every open channel is idle with this policy
+ */
+typedef enum Servo_IdlePolicy {
+    Servo_IdleHold = 0,
+    Servo_IdleStopPwm,
+    Servo_IdlePowerOff
+} Servo_IdlePolicy;
+
+/*!
+ *  @def    Servo_Stats
+ *  @brief  Idle counters for one channel
+ */
+typedef struct Servo_Stats {
+    uint32_t detachCount;       /* times the channel went idle */
+    uint32_t detachedMillis;    /* total time without pulses, including now */
+    uint32_t poweredOffMillis;  /* total time the shared rail was off */
+} Servo_Stats;
+
+/*!
+ *  @brief  Open the PWM behind a servo channel
+ *
+ *  @return the PWM handle, or NULL if the driver could not open it
+ */
+extern PWM_Handle Servo_open(Servo_Channel channel, uint16_t periodMicros);
+
+/*!
+ *  @brief  Convert an angle to a pulse width using the channel's table
+ *
+ *  Angles outside Servo_ANGLE_MIN..MAX are clamped to the table ends.
+ */
+extern uint16_t Servo_dutyForAngle(Servo_Channel channel, Servo_Angle angle);
+
+/*!
+ *  @brief  Move a servo to an angle through its calibration table
+ *
+ *  Re-engages an idle channel: the pulse width is loaded before the rail is
+ *  powered, so the first pulse the servo sees is the new position.
+ */
+extern void Servo_setAngle(Servo_Channel channel, Servo_Angle angle);
+
+/*!
+ *  @brief  Choose what a channel does after stillMillis without a move
+ */
+extern void Servo_setIdlePolicy(Servo_Channel channel, Servo_IdlePolicy policy, uint32_t stillMillis);
+
+/*!
+ *  @brief  Tell the channel it was not moved this tick
+ *
+ *  Detaches the channel once it has been still for its idle time.
+ */
+extern void Servo_still(Servo_Channel channel);
+
+/*!
+ *  @brief  Read a channel's idle counters
+ */
+extern void Servo_getStats(Servo_Channel channel, Servo_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SERVO_H */
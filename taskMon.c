@@ -0,0 +1,166 @@
+/*
+ *  ======== taskMon.c ========
+ *  Per-task CPU time and stack high-water telemetry - see taskMon.h.
+ */
+
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "cycles.h"
+#include "taskMon.h"
+#include "trace.h"
+
+#define TASKMON_PERIOD_TICKS    ((TaskMon_PERIOD_MILLIS * 1000) / Clock_tickPeriod)
+
+static Int           taskMonHookId;
+static Task_Handle   taskMonTasks[TaskMon_COUNT];
+static uint32_t      taskMonCycles[TaskMon_COUNT];  /* running totals for this period */
+static uint32_t      taskMonLastSwitch;
+static uint32_t      taskMonPeriodStart;
+static TaskMon_Stats taskMonStats[TaskMon_COUNT];
+static Clock_Struct  taskMonClockStruct;
+
+/*
+ *  ======== taskMonId ========
+ *  Watched tasks carry (id + 1) in their hook context; anything else is 0
+ */
+static inline TaskMon_Id taskMonId(Task_Handle task)
+{
+    UArg context = (UArg)Task_getHookContext(task, taskMonHookId);
+
+    return ((context != 0) ? (TaskMon_Id)(context - 1) : TaskMon_Other);
+}
+
+/*
+ *  ======== TaskMon_registerHook ========
+ */
+Void TaskMon_registerHook(Int hookSetId)
+{
+    taskMonHookId = hookSetId;
+}
+
+/*
+ *  ======== TaskMon_switchHook ========
+ *  Runs with interrupts enabled but the scheduler locked; the Hwi guard in
+ *  taskMonClockFxn is the only other writer.
+ */
+Void TaskMon_switchHook(Task_Handle prev, Task_Handle next)
+{
+    uint32_t now = Cycles_get();
+
+    if (prev != NULL) {
+        UInt key = Hwi_disable();
+
+        taskMonCycles[taskMonId(prev)] += now - taskMonLastSwitch;
+        taskMonLastSwitch = now;
+
+        Hwi_restore(key);
+    }
+    else {
+        taskMonLastSwitch = now;
+    }
+}
+
+/*
+ *  ======== taskMonClockFxn ========
+ *  Close the period and publish one Trace_TaskStats record per task.
+ */
+static Void taskMonClockFxn(UArg arg)
+{
+    uint32_t   cycles[TaskMon_COUNT];
+    uint32_t   elapsed;
+    uint32_t   now;
+    uint32_t   id;
+    Task_Stat  stat;
+    UInt       key;
+
+    key = Hwi_disable();
+
+    /* charge the task we interrupted up to now, then start a new period */
+    now = Cycles_get();
+    taskMonCycles[taskMonId(Task_self())] += now - taskMonLastSwitch;
+    taskMonLastSwitch = now;
+    elapsed = now - taskMonPeriodStart;
+    taskMonPeriodStart = now;
+    for (id = 0; id < TaskMon_COUNT; id++) {
+        cycles[id] = taskMonCycles[id];
+        taskMonCycles[id] = 0;
+    }
+
+    Hwi_restore(key);
+
+    for (id = 0; id < TaskMon_COUNT; id++) {
+        TaskMon_Stats *stats = &taskMonStats[id];
+
+        stats->cycles = cycles[id];
+        stats->loadPermille = (elapsed != 0) ?
+            (uint16_t)(((uint64_t)cycles[id] * 1000) / elapsed) : 0;
+
+        if (taskMonTasks[id] != NULL) {
+            /* walks the stack for the fill pattern - fine at this rate */
+            Task_stat(taskMonTasks[id], &stat);
+            stats->stackPeak = (uint16_t)stat.used;
+            stats->stackSize = (uint16_t)stat.stackSize;
+        }
+
+        Trace_event(Trace_TaskStats,
+                    id | ((uint32_t)stats->stackPeak << 16),
+                    stats->loadPermille | ((uint32_t)stats->stackSize << 16));
+    }
+}
+
+/*
+ *  ======== TaskMon_init ========
+ */
+void TaskMon_init(void)
+{
+    Clock_Params clockParams;
+
+    Cycles_init();
+    taskMonLastSwitch = Cycles_get();
+    taskMonPeriodStart = taskMonLastSwitch;
+
+    TaskMon_watch(TaskMon_Idle, Task_getIdleTask());
+
+    Clock_Params_init(&clockParams);
+    clockParams.period = TASKMON_PERIOD_TICKS;
+    clockParams.startFlag = TRUE;
+    Clock_construct(&taskMonClockStruct, taskMonClockFxn, TASKMON_PERIOD_TICKS, &clockParams);
+}
+
+/*
+ *  ======== TaskMon_watch ========
+ */
+void TaskMon_watch(TaskMon_Id id, Task_Handle task)
+{
+    if (id >= TaskMon_Other || task == NULL) {
+        return;
+    }
+
+    taskMonTasks[id] = task;
+    Task_setHookContext(task, taskMonHookId, (Ptr)(UArg)(id + 1));
+}
+
+/*
+ *  ======== TaskMon_idOf ========
+ */
+TaskMon_Id TaskMon_idOf(Task_Handle task)
+{
+    return (taskMonId(task));
+}
+
+/*
+ *  ======== TaskMon_getStats ========
+ */
+void TaskMon_getStats(TaskMon_Id id, TaskMon_Stats *stats)
+{
+    UInt key = Hwi_disable();
+
+    *stats = taskMonStats[id];
+
+    Hwi_restore(key);
+}
@@ -0,0 +1,89 @@
+/*
+ *  ======== taskMon.h ========
+ *  Per-task CPU time and stack high-water telemetry.
+ *
+ *  A Task switch hook (configured in pwmled.cfg) charges the cycles since
+ *  the previous switch to the task being switched out. Every
+ *  TaskMon_PERIOD_MILLIS a Clock function turns the totals into a load
+ *  figure, measures each stack's high-water mark with Task_stat and writes
+ *  one Trace_TaskStats record per task, so it reaches the UART link and the
+ *  host decoder like any other event.
+ *
+ *  Hwi and Swi time is charged to whichever task they interrupted.
+ */
+
+#ifndef __TASKMON_H
+#define __TASKMON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Task.h>
+
+#ifndef TaskMon_PERIOD_MILLIS
+#define TaskMon_PERIOD_MILLIS   5000
+#endif
+
+/*!
+ *  @def    TaskMon_Id
+ *  @brief  Tasks with their own row in the telemetry
+ *
+ *  NOTE: IDs appear in Trace_TaskStats records - append new tasks at the end.
+ */
+typedef enum TaskMon_Id {
+    TaskMon_Idle = 0,
+    TaskMon_HeadSideToSide,
+    TaskMon_HeadUpDown,
+    TaskMon_MouthOpenClose,
+    TaskMon_DistSensor,
+    TaskMon_Other,          /* any task not registered with TaskMon_watch */
+
+    TaskMon_COUNT
+} TaskMon_Id;
+
+/*!
+ *  @def    TaskMon_Stats
+ *  @brief  Figures for one task over the last period
+ */
+typedef struct TaskMon_Stats {
+    uint32_t cycles;            /* CPU cycles used in the last period */
+    uint16_t loadPermille;      /* share of the CPU, 0..1000 */
+    uint16_t stackPeak;         /* deepest stack use seen, bytes */
+    uint16_t stackSize;         /* bytes */
+} TaskMon_Stats;
+
+/*!
+ *  @brief  Start the cycle counter and the periodic report
+ *
+ *  The idle task is watched automatically.
+ */
+extern void TaskMon_init(void);
+
+/*!
+ *  @brief  Give a task its own telemetry row
+ */
+extern void TaskMon_watch(TaskMon_Id id, Task_Handle task);
+
+/*!
+ *  @brief  A task's row; TaskMon_Other if it was never watched
+ */
+extern TaskMon_Id TaskMon_idOf(Task_Handle task);
+
+/*!
+ *  @brief  Copy a task's figures from the last completed period
+ */
+extern void TaskMon_getStats(TaskMon_Id id, TaskMon_Stats *stats);
+
+/* Task hook functions - referenced from pwmled.cfg */
+extern Void TaskMon_registerHook(Int hookSetId);
+extern Void TaskMon_switchHook(Task_Handle prev, Task_Handle next);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TASKMON_H */
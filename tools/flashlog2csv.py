@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+Decode the werewolf's flash event log into CSV.
+
+Usage:
+    flashlog2csv.py flashlog.bin > history.csv
+
+flashlog.bin is a read-out of the FLASHLOG region (FlashLog_BASE, 128 KB),
+for example with UniFlash or the CCS memory browser. Pages are written
+oldest to newest, then the lines of each page in order:
+
+    sequence,boot,tick,event,value
+
+tick is the Clock tick (ms) since that boot. Event names come from
+flashLog.h. Pages without the magic word (erased, or cut short by a reset)
+are skipped, and so are records after a page's last commit mark.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from trace2chrome import REPO, c_enum  # noqa: E402
+
+MAGIC = 0x32465757
+COMMIT = 0xFE
+PAGE_SIZE = 1024
+HEADER = struct.Struct("<IIHHI")
+
+
+def varint(page, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = page[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, pos
+
+
+def page_records(page):
+    """Yield (tick, event, value) for the committed records of one page."""
+    _, _, _, _, tick = HEADER.unpack_from(page)
+    value = 0
+    pos = HEADER.size
+    pending = []
+    while pos < len(page) and page[pos] != 0xFF:
+        if page[pos] == COMMIT:
+            yield from pending
+            pending = []
+            pos += 1
+            continue
+        event = page[pos]
+        try:
+            delta, pos = varint(page, pos + 1)
+            change, pos = varint(page, pos)
+        except IndexError:
+            return
+        tick = (tick + delta) & 0xFFFFFFFF
+        value = (value + ((change >> 1) ^ -(change & 1))) & 0xFFFFFFFF
+        pending.append((tick, event, value))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="raw copy of the FLASHLOG region")
+    parser.add_argument("--src", default=REPO, help="firmware source directory for names")
+    args = parser.parse_args()
+
+    names = {v: k.replace("FlashLog_", "")
+             for v, k in c_enum(os.path.join(args.src, "flashLog.h"), "FlashLog_Event").items()}
+    data = open(args.input, "rb").read()
+
+    pages = []
+    for offset in range(0, len(data) - PAGE_SIZE + 1, PAGE_SIZE):
+        page = data[offset:offset + PAGE_SIZE]
+        magic, sequence, boot, _, _ = HEADER.unpack_from(page)
+        if magic == MAGIC:
+            pages.append((sequence, boot, page))
+    pages.sort(key=lambda p: p[0])
+
+    out = sys.stdout
+    out.write("sequence,boot,tick,event,value\n")
+    for sequence, boot, page in pages:
+        for tick, event, value in page_records(page):
+            out.write("%d,%d,%d,%s,%d\n" % (sequence, boot, tick,
+                                            names.get(event, "event%d" % event), value))
+
+
+if __name__ == "__main__":
+    main()
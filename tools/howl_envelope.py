@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+Generate howlEnvelope.c - the mouth servo's amplitude envelope for the howl.
+
+Usage:
+    howl_envelope.py howl.wav > howlEnvelope.c
+    howl_envelope.py --synthetic > howlEnvelope.c
+
+The WAV must be the same file loaded on the sound board behind howlingPin.
+Each HowlEnvelope_FRAME_MILLIS slice is reduced to its RMS level, normalised
+so the loudest slice is 255, and slices under the gate are closed to 0.
+
+--synthetic writes a stand-in shape (attack, wavering sustain, tail) for
+lengthOfHowlMillis so the mouth has something to follow before the real
+sound is measured.
+"""
+
+import argparse
+import math
+import struct
+import sys
+import wave
+
+FRAME_MILLIS = 20
+HOWL_MILLIS = 6000
+GATE = 0.05
+
+
+def wav_levels(path):
+    with wave.open(path, "rb") as w:
+        channels = w.getnchannels()
+        width = w.getsampwidth()
+        rate = w.getframerate()
+        raw = w.readframes(w.getnframes())
+
+    if width == 1:
+        samples = [b - 128 for b in raw]
+        full = 128.0
+    elif width == 2:
+        samples = struct.unpack("<%dh" % (len(raw) // 2), raw)
+        full = 32768.0
+    else:
+        sys.exit("only 8 and 16 bit WAV files are supported")
+
+    # mix down to mono
+    mono = [sum(samples[i:i + channels]) / channels
+            for i in range(0, len(samples), channels)]
+
+    per_frame = rate * FRAME_MILLIS // 1000
+    levels = []
+    for start in range(0, len(mono), per_frame):
+        chunk = mono[start:start + per_frame]
+        levels.append(math.sqrt(sum(s * s for s in chunk) / len(chunk)) / full)
+    return levels
+
+
+def synthetic_levels():
+    frames = HOWL_MILLIS // FRAME_MILLIS
+    levels = []
+    for i in range(frames):
+        t = i * FRAME_MILLIS / 1000.0
+        attack = min(1.0, t / 0.6)
+        tail = min(1.0, max(0.0, (HOWL_MILLIS / 1000.0 - t) / 1.5))
+        waver = 0.8 + 0.2 * math.sin(2 * math.pi * 1.3 * t)
+        levels.append(attack * tail * waver)
+    return levels
+
+
+def emit(levels, source):
+    peak = max(levels) or 1.0
+    values = [0 if l / peak < GATE else int(round(255 * l / peak)) for l in levels]
+
+    out = sys.stdout
+    out.write("/*\n")
+    out.write(" *  ======== howlEnvelope.c ========\n")
+    out.write(" *  Generated by tools/howl_envelope.py from %s - do not edit.\n" % source)
+    out.write(" */\n\n")
+    out.write("#include <stdint.h>\n\n")
+    out.write('#include "howlEnvelope.h"\n\n')
+    out.write("/* Place into subsections to allow the TI linker to remove items properly */\n")
+    out.write("#if defined(__TI_COMPILER_VERSION__)\n")
+    out.write('#pragma DATA_SECTION(howlEnvelope, ".const:howlEnvelope")\n')
+    out.write("#endif\n\n")
+    out.write("const uint16_t howlEnvelopeFrames = %d;\n\n" % len(values))
+    out.write("const uint8_t howlEnvelope[] = {\n")
+    for i in range(0, len(values), 16):
+        out.write("    " + ", ".join("%3d" % v for v in values[i:i + 16]) + ",\n")
+    out.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("wav", nargs="?", help="howl sound file")
+    parser.add_argument("--synthetic", action="store_true",
+                        help="write a stand-in envelope instead of measuring a file")
+    args = parser.parse_args()
+
+    if args.synthetic:
+        emit(synthetic_levels(), "--synthetic")
+    elif args.wav:
+        emit(wav_levels(args.wav), args.wav.split("/")[-1])
+    else:
+        parser.error("give a WAV file or --synthetic")
+
+
+if __name__ == "__main__":
+    main()
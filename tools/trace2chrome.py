@@ -0,0 +1,370 @@
+#!/usr/bin/env python3
+"""
+Decode a werewolf trace into Chrome trace-event JSON.
+
+Usage:
+    trace2chrome.py capture.bin -o show.json          # UART stream (uartLink frames)
+    trace2chrome.py /dev/ttyACM0 -o show.json         # live, until Ctrl-C
+    trace2chrome.py /dev/ttyUSB0 --baud 921600 -o show.json
+    trace2chrome.py --dump traceBuffer.bin -o ram.json   # raw dump of traceBuffer
+
+Open the result in chrome://tracing or https://ui.perfetto.dev.
+
+A serial device is put in raw mode at --baud (UartLink_BAUD, 115200, by
+default), 8N1 with no echo, line editing or CR/LF translation - the tty
+defaults would mangle the binary frames.
+
+Event, state, pin, servo, task, profile point and metric names are read
+from the C sources (trace.h, werewolf.c, Board.h, EK_TM4C123GXL.h,
+servo.h, taskMon.h, profile.h, metrics.h), so the decoder follows the
+firmware without edits.
+Input is processed one frame at a time and events are written as they are
+decoded, so memory use does not grow with the length of the capture.
+
+Timestamps are 32-bit Timestamp counts; wraps are unwound on the fly, which
+needs at least one record per wrap period (about 53 s at 80 MHz - the
+500 ms ping keeps well inside that).
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+import termios
+
+MAGIC = 0x52545757
+MAGIC_BYTES = struct.pack("<I", MAGIC)
+RECORD = struct.Struct("<IHHII")
+FRAME_HEADER = struct.Struct("<IHH")
+DUMP_HEADER = struct.Struct("<IHHI")
+MAX_FRAME_RECORDS = 256
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+# ---------------------------------------------------------------- sources
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def c_enum(path, name):
+    """Return {value: identifier} for 'typedef enum <name> {...}' in path."""
+    text = strip_comments(open(path).read())
+    match = re.search(r"enum\s+%s\s*\{(.*?)\}" % re.escape(name), text, re.S)
+    if not match:
+        sys.exit("%s: enum %s not found" % (path, name))
+    values = {}
+    value = -1
+    for item in match.group(1).split(","):
+        item = item.strip()
+        if not item:
+            continue
+        ident, _, init = item.partition("=")
+        value = int(init.strip(), 0) if init.strip() else value + 1
+        values[value] = ident.strip()
+    return values
+
+
+def board_gpio_names(src):
+    """Map GPIO index to the Board.h name the application uses."""
+    ek = c_enum(os.path.join(src, "EK_TM4C123GXL.h"), "EK_TM4C123GXL_GPIOName")
+    index_of = {ident: value for value, ident in ek.items()}
+    names = {value: ident.replace("EK_TM4C123GXL_", "") for value, ident in ek.items()}
+    board = open(os.path.join(src, "Board.h")).read()
+    for alias, target in re.findall(r"#define\s+(\w+)\s+(EK_TM4C123GXL_\w+)", board):
+        # first Board.h alias wins (Board_LED0 before any later duplicates)
+        if target in index_of and names[index_of[target]] == target.replace("EK_TM4C123GXL_", ""):
+            names[index_of[target]] = alias
+    return names
+
+
+class Names(object):
+    def __init__(self, src):
+        self.events = {v: k.replace("Trace_", "")
+                       for v, k in c_enum(os.path.join(src, "trace.h"), "Trace_Event").items()}
+        self.states = c_enum(os.path.join(src, "werewolf.c"), "state_values")
+        self.pins = board_gpio_names(src)
+        self.servos = {v: k.replace("Servo_", "")
+                       for v, k in c_enum(os.path.join(src, "servo.h"), "Servo_Channel").items()
+                       if k != "Servo_COUNT"}
+        self.tasks = {v: k.replace("TaskMon_", "")
+                      for v, k in c_enum(os.path.join(src, "taskMon.h"), "TaskMon_Id").items()
+                      if k != "TaskMon_COUNT"}
+        self.metrics = {v: k.replace("Metrics_", "")
+                        for v, k in c_enum(os.path.join(src, "metrics.h"), "Metrics_Counter").items()
+                        if k != "Metrics_COUNT"}
+        self.points = {v: k.replace("Profile_", "")
+                       for v, k in c_enum(os.path.join(src, "profile.h"), "Profile_Point").items()
+                       if k != "Profile_COUNT"}
+
+    def event(self, ident):
+        return self.events.get(ident, "event%d" % ident)
+
+    def state(self, value):
+        return self.states.get(value, "state%d" % value)
+
+    def pin(self, index):
+        return self.pins.get(index, "gpio%d" % index)
+
+    def servo(self, channel):
+        return self.servos.get(channel, "servo%d" % channel)
+
+    def task(self, ident):
+        return self.tasks.get(ident, "task%d" % ident)
+
+    def metric(self, ident):
+        return self.metrics.get(ident, "metric%d" % ident)
+
+    def point(self, ident):
+        return self.points.get(ident, "point%d" % ident)
+
+
+# ---------------------------------------------------------------- input
+
+def read_exact(stream, n):
+    data = b""
+    while len(data) < n:
+        chunk = stream.read(n - len(data))
+        if not chunk:
+            return None
+        data += chunk
+    return data
+
+
+def open_input(path, baud):
+    """Open the capture; a serial device is configured for the uartLink stream."""
+    if path == "-":
+        return sys.stdin.buffer
+    stream = open(path, "rb")
+    if os.isatty(stream.fileno()):
+        speed = getattr(termios, "B%d" % baud, None)
+        if speed is None:
+            sys.exit("%s: unsupported baud rate %d" % (path, baud))
+        attrs = termios.tcgetattr(stream.fileno())
+        attrs[0] = 0                                            # iflag: no CR/LF or parity handling
+        attrs[1] = 0                                            # oflag
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL  # cflag: 8N1, ignore modem lines
+        attrs[3] = 0                                            # lflag: not canonical, no echo
+        attrs[4] = attrs[5] = speed
+        attrs[6][termios.VMIN] = 1
+        attrs[6][termios.VTIME] = 0
+        termios.tcsetattr(stream.fileno(), termios.TCSANOW, attrs)
+        termios.tcflush(stream.fileno(), termios.TCIFLUSH)
+    return stream
+
+
+def uart_records(stream, on_drop):
+    """Yield records from a uartLink frame stream, resynchronising on MAGIC."""
+    while True:
+        window = read_exact(stream, 4)
+        if window is None:
+            return
+        # slide byte by byte until the window holds the magic number
+        while window != MAGIC_BYTES:
+            byte = stream.read(1)
+            if not byte:
+                return
+            window = (window + byte)[-4:]
+        rest = read_exact(stream, FRAME_HEADER.size - 4)
+        if rest is None:
+            return
+        _, count, dropped = FRAME_HEADER.unpack(MAGIC_BYTES + rest)
+        if count > MAX_FRAME_RECORDS:
+            continue
+        if dropped:
+            on_drop(dropped)
+        for _ in range(count):
+            raw = read_exact(stream, RECORD.size)
+            if raw is None:
+                return
+            yield RECORD.unpack(raw)
+
+
+def dump_records(stream, on_drop):
+    """Yield records oldest-first from a raw copy of traceBuffer."""
+    header = read_exact(stream, DUMP_HEADER.size)
+    if header is None:
+        sys.exit("dump is too short")
+    magic, size, count, write_count = DUMP_HEADER.unpack(header)
+    if magic != MAGIC or size != RECORD.size:
+        sys.exit("not a traceBuffer dump (magic %08x, record size %d)" % (magic, size))
+    if write_count > count:
+        on_drop(write_count - count)
+    filled = min(write_count, count)
+    first = write_count - filled
+    # the ring is at most a few KB, so it is read whole to reorder it
+    ring = read_exact(stream, count * RECORD.size) or b""
+    for n in range(filled):
+        slot = (first + n) % count
+        yield RECORD.unpack_from(ring, slot * RECORD.size)
+
+
+# ---------------------------------------------------------------- output
+
+class ChromeWriter(object):
+    PID = 1
+    TRACKS = ["show", "sensor", "servos", "pins", "trace"]
+
+    def __init__(self, out, names, freq):
+        self.out = out
+        self.names = names
+        self.freq = float(freq)
+        self.first = True
+        self.base = None
+        self.epoch = 0.0
+        self.last_ts = 0.0
+        self.last_raw = None
+        self.wraps = 0
+        self.open_state = None
+        self.last_seq = None
+        self.out.write("[\n")
+        for tid, track in enumerate(self.TRACKS):
+            self.emit({"ph": "M", "name": "thread_name", "pid": self.PID, "tid": tid,
+                       "args": {"name": track}})
+        self.emit({"ph": "M", "name": "process_name", "pid": self.PID,
+                   "args": {"name": "werewolf"}})
+
+    def emit(self, event):
+        if not self.first:
+            self.out.write(",\n")
+        self.first = False
+        self.out.write(json.dumps(event, separators=(",", ":")))
+
+    def micros(self, raw):
+        if self.last_raw is not None and raw < self.last_raw:
+            self.wraps += 1
+        self.last_raw = raw
+        ticks = raw + (self.wraps << 32)
+        if self.base is None:
+            self.base = ticks
+        self.last_ts = self.epoch + (ticks - self.base) * 1e6 / self.freq
+        return self.last_ts
+
+    def tid(self, track):
+        return self.TRACKS.index(track)
+
+    def instant(self, ts, track, name, args=None):
+        self.emit({"ph": "i", "s": "t", "name": name, "pid": self.PID, "tid": self.tid(track),
+                   "ts": ts, "args": args or {}})
+
+    def counter(self, ts, name, args):
+        self.emit({"ph": "C", "name": name, "pid": self.PID, "ts": ts, "args": args})
+
+    def dropped(self, count):
+        self.instant(self.last_ts, "trace", "dropped %d records" % count, {"dropped": count})
+
+    def record(self, rec):
+        raw, ident, seq, arg0, arg1 = rec
+        name = self.names.event(ident)
+
+        if name == "Boot":
+            # a reboot restarts the timestamp: carry on the timeline from the
+            # last event seen, at the rate the firmware reports
+            self.freq = float(arg0) or self.freq
+            self.epoch = self.last_ts
+            self.base = None
+            self.last_raw = None
+            self.wraps = 0
+            self.instant(self.epoch, "trace", "boot", {"hz": arg0, "tickPeriod": arg1})
+        if self.last_seq is not None and name != "Boot":
+            gap = (seq - self.last_seq - 1) & 0xFFFF
+            if gap:
+                self.instant(self.micros(raw), "trace", "seq gap %d" % gap, {"lost": gap})
+        self.last_seq = seq
+
+        ts = self.micros(raw)
+
+        if name == "StateChange":
+            if self.open_state is not None:
+                self.emit({"ph": "E", "pid": self.PID, "tid": self.tid("show"), "ts": ts})
+            self.open_state = self.names.state(arg0)
+            self.emit({"ph": "B", "name": self.open_state, "pid": self.PID,
+                       "tid": self.tid("show"), "ts": ts})
+        elif name == "Ping":
+            self.instant(ts, "sensor", "ping", {"duration": arg0, "distance": arg1})
+            self.counter(ts, "distance (in)", {"distance": arg1})
+        elif name == "EchoTimeout":
+            phase = {0: "prior pulse", 1: "never started", 2: "maxed out"}.get(arg0, str(arg0))
+            self.instant(ts, "sensor", "echo timeout: " + phase, {"loops": arg1})
+        elif name == "PwmDuty":
+            self.counter(ts, "duty " + self.names.servo(arg0), {"us": arg1})
+        elif name == "ServoAngle":
+            self.counter(ts, "angle " + self.names.servo(arg0), {"deg10": arg1})
+        elif name == "ServoIdle":
+            self.instant(ts, "servos", "%s %s" % (self.names.servo(arg0),
+                                                  "detached" if arg1 else "attached"))
+        elif name == "ServoRail":
+            self.counter(ts, "servoPowerPin", {"level": arg0})
+        elif name == "TaskStats":
+            task = self.names.task(arg0 & 0xFFFF)
+            self.counter(ts, "cpu " + task, {"permille": arg1 & 0xFFFF})
+            if arg1 >> 16:
+                self.counter(ts, "stack " + task, {"peak": arg0 >> 16, "size": arg1 >> 16})
+        elif name == "ProfileStats":
+            # percentiles arrive as log2 buckets: report each bucket's upper edge
+            top = lambda bucket: min((2 << bucket) - 1, arg1) * 1e6 / self.freq
+            point = self.names.point(arg0 & 0xFF)
+            self.counter(ts, "latency " + point, {"p50 us": top((arg0 >> 8) & 0xFF),
+                                                  "p99 us": top((arg0 >> 16) & 0xFF),
+                                                  "max us": arg1 * 1e6 / self.freq})
+        elif name == "Latency":
+            # a servo latency of 0 means none moved while the show was rising
+            latency = {"gate": arg0 * 1e6 / self.freq}
+            if arg1:
+                latency["servo"] = arg1 * 1e6 / self.freq
+            self.instant(ts, "sensor", "trigger latency",
+                         {"to " + key + " us": value for key, value in latency.items()})
+            self.counter(ts, "trigger latency (us)", latency)
+        elif name == "Crash":
+            reason = {1: "exception", 2: "abort"}.get(arg0 & 0xFFFF, str(arg0 & 0xFFFF))
+            task = arg0 >> 16
+            self.instant(ts, "trace", "previous boot crashed: " + reason,
+                         {"task": "-" if task == 0xFFFF else self.names.task(task),
+                          "pc": "0x%08x" % arg1})
+        elif name == "Metrics":
+            self.counter(ts, "count " + self.names.metric(arg0), {"total": arg1})
+        elif name == "GpioWrite":
+            self.counter(ts, self.names.pin(arg0), {"level": arg1})
+        elif name != "Boot":
+            self.instant(ts, "trace", name, {"arg0": arg0, "arg1": arg1})
+
+    def close(self):
+        if self.open_state is not None:
+            self.emit({"ph": "E", "pid": self.PID, "tid": self.tid("show"), "ts": self.last_ts})
+        self.out.write("\n]\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="capture file, serial device or - for stdin")
+    parser.add_argument("-o", "--output", default="-", help="JSON file (default stdout)")
+    parser.add_argument("--dump", action="store_true",
+                        help="input is a raw memory dump of traceBuffer")
+    parser.add_argument("--freq", type=float, default=80e6,
+                        help="Timestamp rate if the capture has no Boot record (default 80 MHz)")
+    parser.add_argument("--src", default=REPO, help="firmware source directory for names")
+    parser.add_argument("--baud", type=int, default=115200,
+                        help="serial device speed (default 115200, UartLink_BAUD)")
+    args = parser.parse_args()
+
+    names = Names(args.src)
+    stream = open_input(args.input, args.baud)
+    out = sys.stdout if args.output == "-" else open(args.output, "w")
+
+    writer = ChromeWriter(out, names, args.freq)
+    reader = dump_records if args.dump else uart_records
+    try:
+        for rec in reader(stream, writer.dropped):
+            writer.record(rec)
+    except KeyboardInterrupt:
+        pass
+    writer.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,63 @@
+/*
+ *  ======== trace.c ========
+ *  Binary event trace - see trace.h.
+ */
+
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/Timestamp.h>
+#include <xdc/runtime/Types.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "trace.h"
+
+#if (Trace_RECORDS & (Trace_RECORDS - 1)) != 0
+#error "Trace_RECORDS must be a power of two"
+#endif
+
+Trace_Buffer traceBuffer;
+
+#if Trace_ENABLED
+
+/*
+ *  ======== Trace_init ========
+ */
+void Trace_init(void)
+{
+    Types_FreqHz freq;
+
+    traceBuffer.recordSize = sizeof(Trace_Record);
+    traceBuffer.records = Trace_RECORDS;
+    traceBuffer.writeCount = 0;
+    traceBuffer.magic = Trace_MAGIC;
+
+    Timestamp_getFreq(&freq);
+    Trace_event(Trace_Boot, freq.lo, Clock_tickPeriod);
+}
+
+/*
+ *  ======== Trace_event ========
+ */
+void Trace_event(Trace_Event event, uint32_t arg0, uint32_t arg1)
+{
+    Trace_Record *rec;
+    uint32_t      count;
+    UInt          key;
+
+    key = Hwi_disable();
+
+    count = traceBuffer.writeCount;
+    rec = &traceBuffer.ring[count & (Trace_RECORDS - 1)];
+    rec->timestamp = Timestamp_get32();
+    rec->event = (uint16_t)event;
+    rec->seq = (uint16_t)count;
+    rec->arg0 = arg0;
+    rec->arg1 = arg1;
+    traceBuffer.writeCount = count + 1;
+
+    Hwi_restore(key);
+}
+
+#endif
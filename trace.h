@@ -0,0 +1,113 @@
+/*
+ *  ======== trace.h ========
+ *  Binary event trace for the werewolf's hot paths.
+ *
+ *  Trace_event() copies a fixed 16-byte record (timestamp, event ID,
+ *  sequence number and two arguments) into a RAM ring. Nothing is
+ *  formatted on the target: the ring is read out later (debugger memory
+ *  dump, or a transport that drains it) and decoded on the host.
+ *
+ *  The record is written with interrupts masked for the handful of stores
+ *  it takes, so Trace_event() is safe from Task, Swi and Hwi context and
+ *  costs a few dozen cycles. When the ring is full the oldest records are
+ *  overwritten.
+ *
+ *  Build with --define=Trace_ENABLED=0 to compile every call away.
+ */
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef Trace_ENABLED
+#define Trace_ENABLED       1
+#endif
+
+/* ring length in records, must be a power of two */
+#ifndef Trace_RECORDS
+#define Trace_RECORDS       64
+#endif
+
+/* "WWTR" - lets the host tool find and check the ring in a raw RAM dump */
+#define Trace_MAGIC         0x52545757
+
+/*!
+ *  @def    Trace_Event
+ *  @brief  Event IDs and the meaning of their two arguments
+ *
+ *  NOTE: IDs are part of the stream format - append new events at the end.
+ */
+typedef enum Trace_Event {
+    Trace_Boot = 0,         /* Timestamp frequency (Hz),  Clock_tickPeriod (us)  */
+    Trace_StateChange,      /* new state_values,          previous state         */
+    Trace_Ping,             /* echo duration (loops),     distance (inches)      */
+    Trace_EchoTimeout,      /* 0 prior pulse, 1 no start, 2 maxed out, loops     */
+    Trace_PwmDuty,          /* Servo_Channel,             pulse width (us)       */
+    Trace_GpioWrite,        /* Board.h GPIO index,        level                  */
+    Trace_ServoIdle,        /* Servo_Channel,             1 detached, 0 attached */
+    Trace_ServoRail,        /* 0 off, 1 on,               0                      */
+    Trace_ServoAngle,       /* Servo_Channel,             angle (0.1 degree)     */
+    Trace_TaskStats,        /* TaskMon_Id | stack peak << 16, load (permille) | stack size << 16 */
+    Trace_ProfileStats,     /* Profile_Point | p50 log2 << 8 | p99 log2 << 16, max (cycles) */
+    Trace_Latency,          /* echo edge to transistorGatePin, to first PWM update while rising or 0 (cycles) */
+    Trace_Crash,            /* previous boot: CrashLog_Reason | task << 16, fault pc */
+    Trace_Metrics,          /* Metrics_Counter,           total since boot       */
+
+    Trace_EVENTCOUNT
+} Trace_Event;
+
+/*!
+ *  @def    Trace_Record
+ *  @brief  One 16-byte trace record, little endian on the wire
+ */
+typedef struct Trace_Record {
+    uint32_t timestamp;     /* xdc.runtime.Timestamp counts */
+    uint16_t event;         /* Trace_Event */
+    uint16_t seq;           /* increments per record; gaps mean lost records */
+    uint32_t arg0;
+    uint32_t arg1;
+} Trace_Record;
+
+/*!
+ *  @def    Trace_Buffer
+ *  @brief  The ring, with a header so a raw dump is self-describing
+ */
+typedef struct Trace_Buffer {
+    uint32_t     magic;         /* Trace_MAGIC once Trace_init has run */
+    uint16_t     recordSize;    /* sizeof(Trace_Record) */
+    uint16_t     records;       /* Trace_RECORDS */
+    uint32_t     writeCount;    /* records ever written; slot is writeCount % records */
+    Trace_Record ring[Trace_RECORDS];
+} Trace_Buffer;
+
+extern Trace_Buffer traceBuffer;
+
+#if Trace_ENABLED
+
+/*!
+ *  @brief  Reset the ring and write the Trace_Boot record
+ */
+extern void Trace_init(void);
+
+/*!
+ *  @brief  Append one record; callable from any context
+ */
+extern void Trace_event(Trace_Event event, uint32_t arg0, uint32_t arg1);
+
+#else
+
+#define Trace_init()
+#define Trace_event(event, arg0, arg1)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRACE_H */
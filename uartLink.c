@@ -0,0 +1,147 @@
+/*
+ *  ======== uartLink.c ========
+ *  Trace ring to serial port framing - see uartLink.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "trace.h"
+#include "uartLink.h"
+
+typedef struct UartLink_Frame {
+    UartLink_FrameHeader header;
+    Trace_Record         records[UartLink_FRAME_RECORDS];
+} UartLink_Frame;
+
+static UartLink_Frame uartLinkFrame;
+static Clock_Struct   uartLinkClockStruct;
+
+static bool           uartLinkOpen = false;
+static volatile bool  uartLinkBusy = false;
+static uint32_t       uartLinkReadCount;
+static uint32_t       uartLinkDroppedSinceFrame;
+static UartLink_Stats uartLinkStats;
+
+/*
+ *  ======== uartLinkClockFxn ========
+ */
+static Void uartLinkClockFxn(UArg arg)
+{
+    UartLink_service();
+}
+
+/*
+ *  ======== UartLink_init ========
+ */
+bool UartLink_init(void)
+{
+    Clock_Params clockParams;
+
+    if (!UartLink_portOpen()) {
+        return (false);
+    }
+
+    /* start from the oldest record still in the ring, so Trace_Boot goes out */
+    uartLinkReadCount = (traceBuffer.writeCount > Trace_RECORDS) ?
+        traceBuffer.writeCount - Trace_RECORDS : 0;
+    uartLinkOpen = true;
+
+    Clock_Params_init(&clockParams);
+    clockParams.period = UartLink_POLL_TICKS;
+    clockParams.startFlag = TRUE;
+    Clock_construct(&uartLinkClockStruct, uartLinkClockFxn, UartLink_POLL_TICKS, &clockParams);
+
+    return (true);
+}
+
+/*
+ *  ======== UartLink_service ========
+ */
+void UartLink_service(void)
+{
+    uint32_t writeCount;
+    uint32_t pending;
+    uint32_t lost;
+    uint32_t i;
+    UInt     key;
+
+    key = Hwi_disable();
+
+    if (!uartLinkOpen || uartLinkBusy) {
+        if (uartLinkBusy) {
+            uartLinkStats.busyPolls++;
+        }
+        Hwi_restore(key);
+        return;
+    }
+
+    writeCount = traceBuffer.writeCount;
+    pending = writeCount - uartLinkReadCount;
+
+    /* the writer lapped us: skip to the oldest record still in the ring */
+    if (pending > Trace_RECORDS) {
+        lost = pending - Trace_RECORDS;
+        uartLinkStats.recordsDropped += lost;
+        uartLinkDroppedSinceFrame += lost;
+        uartLinkReadCount = writeCount - Trace_RECORDS;
+        pending = Trace_RECORDS;
+    }
+
+    if (pending == 0) {
+        Hwi_restore(key);
+        return;
+    }
+
+    if (pending > UartLink_FRAME_RECORDS) {
+        pending = UartLink_FRAME_RECORDS;
+    }
+
+    /* copy out so the ring can keep wrapping while the frame is on the wire */
+    for (i = 0; i < pending; i++) {
+        uartLinkFrame.records[i] =
+            traceBuffer.ring[(uartLinkReadCount + i) & (Trace_RECORDS - 1)];
+    }
+    uartLinkFrame.header.magic = Trace_MAGIC;
+    uartLinkFrame.header.records = (uint16_t)pending;
+    uartLinkFrame.header.dropped = (uartLinkDroppedSinceFrame > 0xFFFF) ?
+        0xFFFF : (uint16_t)uartLinkDroppedSinceFrame;
+
+    uartLinkDroppedSinceFrame = 0;
+    uartLinkReadCount += pending;
+    uartLinkStats.recordsSent += pending;
+    uartLinkBusy = true;
+
+    Hwi_restore(key);
+
+    UartLink_portSend(&uartLinkFrame,
+        sizeof(UartLink_FrameHeader) + pending * sizeof(Trace_Record));
+}
+
+/*
+ *  ======== UartLink_txDone ========
+ */
+void UartLink_txDone(void)
+{
+    uartLinkStats.framesSent++;
+    uartLinkBusy = false;
+
+    /* keep the port saturated while there is a backlog */
+    UartLink_service();
+}
+
+/*
+ *  ======== UartLink_getStats ========
+ */
+void UartLink_getStats(UartLink_Stats *stats)
+{
+    UInt key = Hwi_disable();
+
+    *stats = uartLinkStats;
+
+    Hwi_restore(key);
+}
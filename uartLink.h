@@ -0,0 +1,106 @@
+/*
+ *  ======== uartLink.h ========
+ *  Streams the trace ring out of Board_UART0 in the background.
+ *
+ *  A periodic Clock function copies whatever the trace ring holds into a
+ *  frame and hands it to the port, which sends it without the CPU (uDMA on
+ *  the board, a pseudo-terminal on a Linux host). The sender never waits:
+ *  if the port is still busy the records stay in the ring, and if the ring
+ *  wraps before they are sent the lost records are counted and reported in
+ *  the next frame header.
+ *
+ *  Wire format: frames of
+ *      UartLink_FrameHeader, then header.records * Trace_Record
+ *  all little endian.
+ */
+
+#ifndef __UARTLINK_H
+#define __UARTLINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "trace.h"
+
+#ifndef UartLink_BAUD
+#define UartLink_BAUD           115200
+#endif
+
+/* records per frame - one DMA transfer */
+#ifndef UartLink_FRAME_RECORDS
+#define UartLink_FRAME_RECORDS  8
+#endif
+
+/* how often the ring is checked, in Clock ticks */
+#ifndef UartLink_POLL_TICKS
+#define UartLink_POLL_TICKS     10
+#endif
+
+/*!
+ *  @def    UartLink_FrameHeader
+ *  @brief  Start of every frame on the wire
+ */
+typedef struct UartLink_FrameHeader {
+    uint32_t magic;         /* Trace_MAGIC, for resynchronising mid-stream */
+    uint16_t records;       /* Trace_Records following this header */
+    uint16_t dropped;       /* records lost since the previous frame, saturating */
+} UartLink_FrameHeader;
+
+/*!
+ *  @def    UartLink_Stats
+ *  @brief  Transport counters
+ */
+typedef struct UartLink_Stats {
+    uint32_t framesSent;
+    uint32_t recordsSent;
+    uint32_t recordsDropped;    /* overwritten in the ring before they were sent */
+    uint32_t busyPolls;         /* polls that found the port still sending */
+} UartLink_Stats;
+
+/*!
+ *  @brief  Open the port and start the periodic drain
+ *
+ *  @return false if the port could not be opened
+ */
+extern bool UartLink_init(void);
+
+/*!
+ *  @brief  Send the next frame if the port is free; callable from any context
+ */
+extern void UartLink_service(void);
+
+/*!
+ *  @brief  Called by the port when the last frame has left
+ */
+extern void UartLink_txDone(void);
+
+/*!
+ *  @brief  Copy the transport counters
+ */
+extern void UartLink_getStats(UartLink_Stats *stats);
+
+/*
+ * Port - implemented once per platform (uartLinkTiva.c on the board)
+ */
+
+/*!
+ *  @brief  Bring up the serial port
+ */
+extern bool UartLink_portOpen(void);
+
+/*!
+ *  @brief  Start sending a frame; must not block. Call UartLink_txDone()
+ *          when the buffer may be reused.
+ */
+extern void UartLink_portSend(const void *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UARTLINK_H */
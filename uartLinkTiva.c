@@ -0,0 +1,92 @@
+/*
+ *  ======== uartLinkTiva.c ========
+ *  UartLink port for the EK_TM4C123GXL: UART0 (the LaunchPad's virtual COM
+ *  port on PA0/PA1) fed by uDMA channel 9 in basic mode.
+ *
+ *  The uDMA completion interrupt arrives on the UART0 vector; the Hwi just
+ *  tells UartLink the frame buffer is free again.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+#include <xdc/runtime/Types.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/family/arm/m3/Hwi.h>
+
+#include <inc/hw_ints.h>
+#include <inc/hw_memmap.h>
+#include <inc/hw_types.h>
+#include <inc/hw_uart.h>
+
+#include <driverlib/uart.h>
+#include <driverlib/udma.h>
+
+#include "Board.h"
+#include "uartLink.h"
+
+/* Hwi_Struct used in the UartLink_portOpen Hwi_construct call */
+static Hwi_Struct uartLinkHwiStruct;
+
+/*
+ *  ======== uartLinkHwi ========
+ */
+static Void uartLinkHwi(UArg arg)
+{
+    UARTIntClear(UART0_BASE, UARTIntStatus(UART0_BASE, true));
+
+    if (uDMAChannelModeGet(UDMA_CHANNEL_UART0TX | UDMA_PRI_SELECT) == UDMA_MODE_STOP) {
+        UartLink_txDone();
+    }
+}
+
+/*
+ *  ======== UartLink_portOpen ========
+ */
+bool UartLink_portOpen(void)
+{
+    Error_Block  eb;
+    Hwi_Params   hwiParams;
+    Types_FreqHz cpuFreq;
+
+    Board_initDMA();
+    Board_initUART();
+
+    Error_init(&eb);
+    Hwi_Params_init(&hwiParams);
+    Hwi_construct(&(uartLinkHwiStruct), INT_UART0, uartLinkHwi, &hwiParams, &eb);
+    if (Error_check(&eb)) {
+        return (false);
+    }
+
+    BIOS_getCpuFreq(&cpuFreq);
+    UARTConfigSetExpClk(UART0_BASE, cpuFreq.lo, UartLink_BAUD,
+                        UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE);
+    UARTFIFOLevelSet(UART0_BASE, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+    UARTDMAEnable(UART0_BASE, UART_DMA_TX);
+
+    uDMAChannelAssign(UDMA_CH9_UART0TX);
+    uDMAChannelAttributeDisable(UDMA_CHANNEL_UART0TX,
+                                UDMA_ATTR_ALTSELECT | UDMA_ATTR_HIGH_PRIORITY |
+                                UDMA_ATTR_REQMASK);
+    uDMAChannelAttributeEnable(UDMA_CHANNEL_UART0TX, UDMA_ATTR_USEBURST);
+    uDMAChannelControlSet(UDMA_CHANNEL_UART0TX | UDMA_PRI_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_4);
+
+    UARTEnable(UART0_BASE);
+
+    return (true);
+}
+
+/*
+ *  ======== UartLink_portSend ========
+ */
+void UartLink_portSend(const void *buf, size_t len)
+{
+    uDMAChannelTransferSet(UDMA_CHANNEL_UART0TX | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+                           (void *)buf, (void *)(UART0_BASE + UART_O_DR), len);
+    uDMAChannelEnable(UDMA_CHANNEL_UART0TX);
+}
@@ -33,6 +33,21 @@
  * to board-specific files (e.g., EK_TM4C123GXL.h)
  */
 #include "Board.h"
+#include "servo.h"
+#include "easing.h"
+#include "motion.h"
+#include "howlEnvelope.h"
+#include "trace.h"
+#include "uartLink.h"
+#include "taskMon.h"
+#include "profile.h"
+#include "latency.h"
+#include "crashLog.h"
+#include "flashLog.h"
+#include "metrics.h"
+#include "appLog.h"
+#include "detect.h"
+#include "bench.h"
 
 #define TASKSTACKSIZE   512
 
@@ -56,6 +71,12 @@ Task_Handle distSensorTask;
  * Constants - to be adjusted to control behavior
  */
 
+// TUNABLE values are const on the board; the host build defines TUNABLE empty
+// so host/sweep.c and host/simMain.c can set them per simulated run
+#ifndef TUNABLE
+#define TUNABLE const
+#endif
+
 typedef enum state_values {
     PanningMode = 0,
     RisingMode,
@@ -65,48 +86,64 @@ typedef enum state_values {
 
 int state = PanningMode;
 
-const int minTriggerDistance = 10;      // minimum distance, inches,  object must be away in order to trigger
-const int maxTriggerDistance = 72;      // maximum distance, inches, object must be away in order to trigger
+volatile bool   howlPlaying = false;    // set by distSensorFxn while howlingPin is low
+volatile UInt32 howlStartTick = 0;      // Clock tick at which howlingPin went low
+
+TUNABLE int minTriggerDistance = 10;    // minimum distance, inches,  object must be away in order to trigger
+TUNABLE int maxTriggerDistance = 72;    // maximum distance, inches, object must be away in order to trigger
 
 const bool distSensorActive = true;
 const bool headturnActive = false;
 const bool headliftActive = false;
-const bool mouthActive    = false;
+const bool mouthActive    = true;
 const bool breathingActive    = true;
+TUNABLE bool recordRanges = false;      // log pings to flash for host/replay.c - only those that change the distance, the rest as repeat counts (a night is 15-30 KB, so ~4 nights fit)
 
 const int headTurnMillisForPanningMode   = 5000; //time to go from left-to-right or right-to-left
 const int headLiftMillisForRisingMode    = 3000;  //time to get head looking down while rising
 const int headTurnMillisForRisingingMode = 3000;  //time to get head pointed forward
-const int lengthOfRisingMode             = 6000;  //time spent in rising mode - start to finish
+TUNABLE int lengthOfRisingMode           = 6000;  //time spent in rising mode - start to finish, at least the body's rise (host/simSolenoid.c)
 const int headLiftMillisForHowlingMode   = 3000;  //time to raise head to howl
 const int lengthOfHowlMillis             = 6000;  //length of howl sound
 const int lengthOfHowlingMode            = 6000;  //time spent in howling mode - start to finish
 const int headLiftMillisForLoweringMode  = 5000;  //time to lower head while lowering
-const int lengthOfLoweringingMode        = 5000;  //time spent in lowering mode - start to finish
-const int requiredHitCount               = 2;     //number of matching hits from distance sensor to trigger rise
-const int resetMillis                    = 5000;  //time before allowed to re-trigger
-
-const int minDutyToLeftShoulder = 750;
-const int maxDutyToRightShoulder = 2000;
-const int centeredDuty = 1500;
-      int headTurnServoDutyInc = 10;
+TUNABLE int lengthOfLoweringingMode      = 5000;  //time spent in lowering mode - start to finish, at least the body's fall and settle
+TUNABLE int requiredHitCount             = 1;     //number of matching hits in a row from distance sensor to trigger rise - 1 is what the board always did; 2 delays each trigger by a ping
+TUNABLE int resetMillis                  = 5000;  //time before allowed to re-trigger
+TUNABLE int pingIntervalMillis           = 500;   //time between distance checks
+const int sensorSummaryMillis            = 300000; //how often the closest distance and timeout count go to the flash log - ~12 bytes each, programmed in place, so ~4 weeks fit with 100 shows a night
+
+// servo positions are angles in tenths of a degree - servo.c maps them to duty
+const Servo_IdlePolicy servoIdlePolicy = Servo_IdlePowerOff; //also cuts servoPowerPin once all servos are still; Servo_IdleStopPwm keeps the rail up
+const int servoIdleMillis = 1500;           //time a servo must be still before it is let go
+const int minAngleToLeftShoulder = 0;       //duty 750
+const int maxAngleToRightShoulder = 1800;   //duty 2000
+const int centeredAngle = 900;              //duty 1500
+const Easing_Curve headTurnPanCurve = Easing_Sine;  //shape of the left-right-left sweep
+const int headTurnTwitchAngle = 0;          //size of random glances mixed on top of the sweep, 0 for none
 const int headTurnDurationOfInc = 40;
 
-const int headLiftDutyUp = 1700;    //1700 seems right for panning mode and howl
-const int headLiftDutyDown = 700;   //700 seems right for rising mode (looking down)
-      int headLiftServoDutyInc = 10;
+const int headLiftAngleUp = 1080;   //duty 1700 seems right for panning mode and howl
+const int headLiftAngleDown = 180;  //duty 700 seems right for rising mode (looking down)
+const int headLiftSniffAngle = 0;          //height of sniffing nods while panning, 0 holds the head still
+const int headLiftMillisForSniff = 1500;   //time for one sniffing nod
+const int headLiftBreathAngle = 0;         //breathing bob mixed on top of every head lift move, 0 for none
+const int headLiftMillisForBreath = 4000;  //time for one breath
 const int headLiftDurationOfInc = 40;
 
-const int minDutyMouthOpen = 750;
-const int maxDutyMouthClose = 2000;
-      int mouthOpenCloseServoDutyInc = 10;
-const int mouthOpenCloseDurationOfInc = 40;
+const int minAngleMouthOpen = 225;      //duty 750
+const int maxAngleMouthClose = 1350;    //duty 2000
+const int mouthLeadMillis = 60;             //servo lag - read the envelope this far ahead so the jaw keeps up with the sound
+const int mouthOpenCloseDurationOfInc = HowlEnvelope_FRAME_MILLIS;
+
+// log levels at start-up - change them while running with AppLog_setLevel or appLogLevels[] in the debugger
+const AppLog_Level logHeadTurn = AppLog_Warn;
+const AppLog_Level logHeadLift = AppLog_Warn;
+const AppLog_Level logMouthOpenClose = AppLog_Info;     // Debug traces each change of mouth angle
+const AppLog_Level logDistSensor = AppLog_Info;         // Info prints each raise and lower
 
-// logging flags
-const bool logHeadTurn = false;
-const bool logHeadLift = false;
-const bool logMouthOpenClose = true;
-const bool logDistSensor = true;
+int pulseDuration(int pinIndex);
+Void logFxn(String text);
 
 
 /*
@@ -116,19 +153,22 @@ const bool logDistSensor = true;
 Void headSideToSideFxn(UArg arg0, UArg arg1)
 {
     PWM_Handle headSideToSideServo; //********************** JJM
-    PWM_Params servoPwmParams;
     uint16_t   pwmServoPeriod = 3000;      // Period in microseconds 20,000 <=> 50Hz
 
-    PWM_Params_init(&servoPwmParams);
-    servoPwmParams.period = pwmServoPeriod;
-    headSideToSideServo = PWM_open(Board_HeadSideToSide_servo, &servoPwmParams); //************ JJM "Board_PWM2_servo" comes from Board.h but points to EK_TM4C123GXL.h PWM enum
+    headSideToSideServo = Servo_open(Servo_HeadSideToSide, pwmServoPeriod); //************ JJM Servo_HeadSideToSide maps to "Board_HeadSideToSide_servo" in servo.c
     if (headSideToSideServo == NULL) {
         System_abort("headSideToSideServo did not open");
     }
 
-    uint16_t   servoDuty = centeredDuty; //starting duty (servo position)
+    Servo_setIdlePolicy(Servo_HeadSideToSide, servoIdlePolicy, servoIdleMillis);
+    Motion_setLimits(Servo_HeadSideToSide, minAngleToLeftShoulder, maxAngleToRightShoulder);
+    Motion_setNoise(Servo_HeadSideToSide, 0, 0, headTurnTwitchAngle, headTurnDurationOfInc);
 
-    System_printf("servoDuty: %i\nservoDutyInc: %i\ndurationOfInc= %i\n", servoDuty, headTurnServoDutyInc,headTurnDurationOfInc);
+    Servo_Angle  servoAngle = centeredAngle; //starting angle (servo position)
+    Easing_Phase panPhase = 0x4000;          //a quarter of the way through the sweep is centered
+    Easing_Phase panPhaseInc = Easing_phaseStep(2 * headTurnMillisForPanningMode, headTurnDurationOfInc);
+
+    System_printf("servoAngle: %i\npanPhaseInc: %i\ndurationOfInc= %i\n", servoAngle, panPhaseInc,headTurnDurationOfInc);
     System_flush();
 
     /* Loop forever incrementing the PWM duty */
@@ -136,32 +176,21 @@ Void headSideToSideFxn(UArg arg0, UArg arg1)
 
         if(headturnActive) {
           if(state == PanningMode) {
-              if(logHeadTurn) {
-                  System_printf("setting headTurn to duty: %i\n", servoDuty);
-                  System_flush();
-              }
-              PWM_setDuty(headSideToSideServo, servoDuty);
-              if(headTurnServoDutyInc > 0) {
-                  servoDuty += headTurnServoDutyInc;
-                  if(servoDuty > maxDutyToRightShoulder) {
-                      headTurnServoDutyInc = -1 * headTurnServoDutyInc;
-                      servoDuty += headTurnServoDutyInc;
-                  }
-              }
-              if(headTurnServoDutyInc < 0) {
-                  servoDuty += headTurnServoDutyInc;
-                  if(servoDuty < minDutyToLeftShoulder) {
-                      headTurnServoDutyInc = -1 * headTurnServoDutyInc;
-                      servoDuty += headTurnServoDutyInc;
-                  }
+              if(AppLog_enabled(AppLog_HeadTurn, AppLog_Debug)) {
+                  Trace_event(Trace_ServoAngle, Servo_HeadSideToSide, servoAngle);
               }
+              Motion_setLayer(Servo_HeadSideToSide, Motion_Base, servoAngle);
 
-              Task_sleep(headTurnDurationOfInc);
+              // one full curve is left shoulder -> right shoulder -> left shoulder
+              panPhase += panPhaseInc;
+              servoAngle = Easing_lerp(headTurnPanCurve, panPhase, minAngleToLeftShoulder, maxAngleToRightShoulder);
           }
 
           if(state == RisingMode) {
               ;
           }
+
+          Motion_update(Servo_HeadSideToSide);
         }
 
         Task_sleep(headTurnDurationOfInc);
@@ -169,6 +198,40 @@ Void headSideToSideFxn(UArg arg0, UArg arg1)
 }
 
 
+/*
+ *  ======== easeHeadLift ========
+ *  Moves the head lift along the ease-in-out curve, one table sample per tick,
+ *  until the move is done or the state changes. Returns the last angle set.
+ */
+int easeHeadLift(int fromAngle, int toAngle, int millis, int moveState)
+{
+    Easing_Phase phaseInc = Easing_phaseStep(millis, headLiftDurationOfInc);
+    uint32_t     phase = 0;
+    int          headLiftAngle = fromAngle;
+
+    while (state == moveState && phase <= 0xFFFF) {
+        headLiftAngle = Easing_lerp(Easing_EaseInOut, (Easing_Phase)phase, fromAngle, toAngle);
+        if(AppLog_enabled(AppLog_HeadLift, AppLog_Debug)) {
+            Trace_event(Trace_ServoAngle, Servo_HeadUpDown, headLiftAngle);
+        }
+        Motion_setLayer(Servo_HeadUpDown, Motion_Base, headLiftAngle);
+        Motion_update(Servo_HeadUpDown);
+
+        phase += phaseInc;
+        Task_sleep(headLiftDurationOfInc);
+    }
+
+    // the last step can fall short of the end of the table
+    if(state == moveState && headLiftAngle != toAngle) {
+        headLiftAngle = toAngle;
+        Motion_setLayer(Servo_HeadUpDown, Motion_Base, headLiftAngle);
+        Motion_update(Servo_HeadUpDown);
+    }
+
+    return headLiftAngle;
+}
+
+
 /*
  *  ======== headUpAndDownFxn ========
  *  Task periodically increments the PWM duty for the on board LED.
@@ -176,111 +239,166 @@ Void headSideToSideFxn(UArg arg0, UArg arg1)
 Void headUpAndDownFxn(UArg arg0, UArg arg1)
 {
     PWM_Handle headUpAndDownServo; //********************** JJM
-    PWM_Params headUpAndDownServoPwmParams;
     uint16_t   headUpAndDownServoPeriod = 3000;      // Period in microseconds 20,000 <=> 50Hz
 
-    PWM_Params_init(&headUpAndDownServoPwmParams);
-    headUpAndDownServoPwmParams.period = headUpAndDownServoPeriod;
-    headUpAndDownServo = PWM_open(Board_HeadUpDown_servo, &headUpAndDownServoPwmParams);
+    headUpAndDownServo = Servo_open(Servo_HeadUpDown, headUpAndDownServoPeriod);
     if (headUpAndDownServo == NULL) {
         System_abort("Board_HeadUpDown_servo did not open");
     }
 
-    int headLiftDuty = headLiftDutyUp;
-    int currentHeadLiftDuty = -1;
+    Servo_setIdlePolicy(Servo_HeadUpDown, servoIdlePolicy, servoIdleMillis);
+    Motion_setLimits(Servo_HeadUpDown, headLiftAngleDown, headLiftAngleUp);
+    Motion_setNoise(Servo_HeadUpDown, headLiftBreathAngle, headLiftMillisForBreath, 0, headLiftDurationOfInc);
+
+    int headLiftAngle = headLiftAngleUp;
+    int currentHeadLiftAngle = headLiftAngleUp;
+    Easing_Phase sniffPhase = 0;
+    Easing_Phase sniffPhaseInc = Easing_phaseStep(headLiftMillisForSniff, headLiftDurationOfInc);
 
     while (headliftActive) {
 
 
         if(state == PanningMode) {
-            headLiftDuty = headLiftDutyUp;
+            headLiftAngle = headLiftAngleUp - Easing_lerp(Easing_Sniff, sniffPhase, 0, headLiftSniffAngle);
+            sniffPhase += sniffPhaseInc;
 
-            if(logHeadLift) {
-                System_printf("setting headLift to duty: %i\n", headLiftDuty);
-                System_flush();
-            }
-            if(headLiftDuty != currentHeadLiftDuty) {
-                PWM_setDuty(headUpAndDownServo, headLiftDuty);
-                currentHeadLiftDuty = headLiftDuty;
+            if(AppLog_enabled(AppLog_HeadLift, AppLog_Debug)) {
+                Trace_event(Trace_ServoAngle, Servo_HeadUpDown, headLiftAngle);
             }
+            // the mixer only drives the servo when the mixed angle changes
+            Motion_setLayer(Servo_HeadUpDown, Motion_Base, headLiftAngle);
+            Motion_update(Servo_HeadUpDown);
+            currentHeadLiftAngle = headLiftAngle;
 
             Task_sleep(headLiftDurationOfInc);
         }
 
         if(state == RisingMode) {
-            while (state == RisingMode && headLiftDuty < headLiftDutyDown) {
-                if(logHeadLift) {
-                    System_printf("setting headLift to duty: %i\n", headLiftDuty);
-                    System_flush();
-                }
-                PWM_setDuty(headUpAndDownServo, headLiftDuty);
-
-                headLiftDuty += headLiftServoDutyInc;
+            // look down at the visitor while the body rises...
+            currentHeadLiftAngle = easeHeadLift(currentHeadLiftAngle, headLiftAngleDown, headLiftMillisForRisingMode, RisingMode);
+            while (state == RisingMode) {
+                Motion_update(Servo_HeadUpDown);
+                Task_sleep(headLiftDurationOfInc);
+            }
+        }
 
+        if(state == HowlingMode) {
+            // ...then lift the head back up to howl
+            currentHeadLiftAngle = easeHeadLift(currentHeadLiftAngle, headLiftAngleUp, headLiftMillisForHowlingMode, HowlingMode);
+            while (state == HowlingMode) {
+                Motion_update(Servo_HeadUpDown);
                 Task_sleep(headLiftDurationOfInc);
             }
         }
+
+        if(state == LoweringMode) {
+            Motion_update(Servo_HeadUpDown);
+            Task_sleep(headLiftDurationOfInc);
+        }
     }
 }
 
 
 /*
  *  ======== mouthOpenCloseFxn ========
- *  Task periodically increments the PWM duty for the on board LED.
+ *  Task opens the mouth in step with the howl, following the loudness
+ *  envelope in howlEnvelope.c. The mouth stays closed the rest of the time.
  */
-/*
 Void mouthOpenCloseFxn(UArg arg0, UArg arg1)
 {
     PWM_Handle mouthOpenCloseServo; //********************** JJM
-    PWM_Params mouthOpenCloseServoParams;
     uint16_t   mouthOpenCloseServoPeriod = 3000;      // Period in microseconds 20,000 <=> 50Hz
 
-    PWM_Params_init(&mouthOpenCloseServoParams);
-    mouthOpenCloseServoParams.period = mouthOpenCloseServoPeriod;
-    mouthOpenCloseServo = PWM_open(Board_MouthOpenClose_servo, &mouthOpenCloseServoParams); //************ JJM "Board_PWM2_servo" comes from Board.h but points to EK_TM4C123GXL.h PWM enum
+    mouthOpenCloseServo = Servo_open(Servo_MouthOpenClose, mouthOpenCloseServoPeriod); //************ JJM Servo_MouthOpenClose maps to "Board_MouthOpenClose_servo" in servo.c
     if (mouthOpenCloseServo == NULL) {
         System_abort("mouthOpenCloseServo did not open");
     }
 
-    uint16_t   mouthOpenCloseServoDuty = minDutyMouthOpen; //starting duty (servo position)
+    Servo_setIdlePolicy(Servo_MouthOpenClose, servoIdlePolicy, servoIdleMillis);
+    Motion_setLimits(Servo_MouthOpenClose, minAngleMouthOpen, maxAngleMouthClose);
+
+    Servo_Angle mouthOpenCloseServoAngle = maxAngleMouthClose; //starting angle (mouth closed)
+    Servo_Angle tracedAngle = -1;   // the still mouth between howls is not worth 50 records a second
+    UInt32      howlMillis;
+    UInt32      frame;
 
-    System_printf("mouthOpenCloseServoDuty: %i\nmouthOpenCloseServoDutyInc: %i\nmouthOpenCloseDurationOfInc= %i\n", mouthOpenCloseServoDuty, mouthOpenCloseServoDutyInc,mouthOpenCloseDurationOfInc);
+    System_printf("mouthOpenCloseServoAngle: %i\nhowlEnvelopeFrames: %i\nmouthOpenCloseDurationOfInc= %i\n", mouthOpenCloseServoAngle, howlEnvelopeFrames,mouthOpenCloseDurationOfInc);
     System_flush();
 
     while (mouthActive) {
+        mouthOpenCloseServoAngle = maxAngleMouthClose;
+
+        if(howlPlaying) {
+            // pick the frame from the clock rather than by counting sleeps, so a
+            // late wakeup skips a frame instead of pushing the rest of the howl back
+            howlMillis = ((Clock_getTicks() - howlStartTick) * Clock_tickPeriod) / 1000 + mouthLeadMillis;
+            frame = howlMillis / HowlEnvelope_FRAME_MILLIS;
+            if(frame < howlEnvelopeFrames) {
+                mouthOpenCloseServoAngle = maxAngleMouthClose +
+                    ((minAngleMouthOpen - maxAngleMouthClose) * howlEnvelope[frame]) / HowlEnvelope_MAX;
+            }
+        }
 
-        if(mouthActive) {
-          if(state == PanningMode) {
-              if(logMouthOpenClose) {
-                  System_printf("setting mouth to duty: %i\n", mouthOpenCloseServoDuty);
-                  System_flush();
-              }
-              PWM_setDuty(mouthOpenCloseServo, mouthOpenCloseServoDuty);
-              if(mouthOpenCloseServoDutyInc > 0) {
-                  mouthOpenCloseServoDuty += mouthOpenCloseServoDutyInc;
-                  if(mouthOpenCloseServoDuty > maxDutyMouthClose) {
-                      mouthOpenCloseServoDutyInc = -1 * mouthOpenCloseServoDutyInc;
-                      mouthOpenCloseServoDuty += mouthOpenCloseServoDutyInc;
-                  }
-              }
-              if(mouthOpenCloseServoDutyInc < 0) {
-                  mouthOpenCloseServoDuty += mouthOpenCloseServoDutyInc;
-                  if(mouthOpenCloseServoDuty < minDutyMouthOpen) {
-                      mouthOpenCloseServoDutyInc = -1 * mouthOpenCloseServoDutyInc;
-                      mouthOpenCloseServoDuty += mouthOpenCloseServoDutyInc;
-                  }
-              }
+        if(mouthOpenCloseServoAngle != tracedAngle && AppLog_enabled(AppLog_MouthOpenClose, AppLog_Debug)) {
+            Trace_event(Trace_ServoAngle, Servo_MouthOpenClose, mouthOpenCloseServoAngle);
+            tracedAngle = mouthOpenCloseServoAngle;
+        }
+        Motion_setLayer(Servo_MouthOpenClose, Motion_Base, mouthOpenCloseServoAngle);
+        Motion_update(Servo_MouthOpenClose);
 
-              Task_sleep(mouthOpenCloseDurationOfInc);
-          }
+        Task_sleep(mouthOpenCloseDurationOfInc);
+    }
+}
 
-          if(state == RisingMode) {
-              ;
-          }
-        }
+/*
+ *  ======== changeState ========
+ *  Every show phase change goes through here so it lands in the trace
+ */
+Void changeState(state_values newState)
+{
+    Profile_BEGIN(Profile_StateChange);
+    Trace_event(Trace_StateChange, newState, state);
+    CrashLog_noteState(newState);
+    state = newState;
+    Profile_END(Profile_StateChange);
+}
+
+/*
+ *  ======== writePin ========
+ *  GPIO_write that also traces the new level
+ */
+Void writePin(unsigned int index, unsigned int value)
+{
+    Profile_BEGIN(Profile_GpioWrite);
+    GPIO_write(index, value);
+    Trace_event(Trace_GpioWrite, index, value);
+    Profile_END(Profile_GpioWrite);
+}
+
+/*
+ *  ======== recordRange ========
+ *  Log a ping for host/replay.c. Pings at the same distance as the last
+ *  Range record are only counted, and the count goes in as a RangeRepeat
+ *  just before the next Range - a trigger's ping and a summary's always
+ *  get one, so a trigger follows its own ping and a power-off loses no
+ *  more than the summary does.
+ */
+Void recordRange(uint16_t duration, uint16_t distance, bool always)
+{
+    static uint16_t recordedDistance = UINT16_MAX;
+    static uint32_t repeats = 0;
+
+    if(distance == recordedDistance && !always) {
+        repeats++;
+        return;
     }
+    if(repeats != 0) {
+        FlashLog_append(FlashLog_RangeRepeat, repeats);
+        repeats = 0;
+    }
+    FlashLog_append(FlashLog_Range, duration);
+    recordedDistance = distance;
 }
-*/
 
 /*
  *  ======== distSensorTaskFxn ========
@@ -288,8 +406,18 @@ Void mouthOpenCloseFxn(UArg arg0, UArg arg1)
  */
 Void distSensorFxn(UArg arg0, UArg arg1)
 {
-    uint16_t   duration = 0;
-    uint16_t   distance = 0;
+    uint16_t      duration = 0;
+    uint16_t      distance = 0;
+    uint16_t      closestDistance = UINT16_MAX; // since the last flash log summary
+    uint32_t      echoTimeouts = 0;
+    UInt32        summaryTick = Clock_getTicks();
+    bool          summaryDue;
+    UInt32        showStartTick;
+    Detect_Params detectParams = { minTriggerDistance, maxTriggerDistance, requiredHitCount };
+    Detect_State  detect;
+    Detect_Result result;
+
+    Detect_init(&detect, &detectParams);
 
     /* Loop forever incrementing the PWM duty */
     while (distSensorActive) {
@@ -299,71 +427,107 @@ Void distSensorFxn(UArg arg0, UArg arg1)
         // CHECK DISTANCE
         // Send signal to Trigger pin on distance sensor
         // The sensor is triggered by a HIGH pulse of 10 or more microseconds.
-        GPIO_write(Dist_Sensor_Trigger, 0);     // Give a short LOW pulse beforehand to ensure a clean HIGH pulse:
-        GPIO_write(Board_LED0, Board_LED_OFF);  // turn off blue LED
+        writePin(Dist_Sensor_Trigger, 0);     // Give a short LOW pulse beforehand to ensure a clean HIGH pulse:
+        writePin(Board_LED0, Board_LED_OFF);  // turn off blue LED
         Task_sleep(5*1/Clock_tickPeriod);       // sleep a bit while pin is low
-        GPIO_write(Dist_Sensor_Trigger, 1);     // set pin high to signal sensor to check distance
-        GPIO_write(Board_LED0, Board_LED_ON);   // turn on blue LED to show sensor is checking
+        writePin(Dist_Sensor_Trigger, 1);     // set pin high to signal sensor to check distance
+        writePin(Board_LED0, Board_LED_ON);   // turn on blue LED to show sensor is checking
         Task_sleep(1);                          // need at least 10 microseconds of signal being on trigger pin to invoke sensor to read
-        GPIO_write(Dist_Sensor_Trigger, 0);     // set pulse back to low
+        writePin(Dist_Sensor_Trigger, 0);     // set pulse back to low
 
+        Profile_BEGIN(Profile_PulseDuration);
         duration = pulseDuration(Dist_Sensor_Echo); // measure pulse duration on echo pin - needs very low latency
-        distance = duration/74/2;
+        Profile_END(Profile_PulseDuration);
+        distance = Detect_distance(duration);
+
+        writePin(Board_LED0, Board_LED_OFF);  // turn off blue LED to show no more measuring
+
+        Trace_event(Trace_Ping, duration, distance);
+        Metrics_increment(Metrics_Pings);
+        if(duration == 0) {
+            echoTimeouts++;
+        }
+        else if(distance < closestDistance) {
+            closestDistance = distance;
+        }
 
-        GPIO_write(Board_LED0, Board_LED_OFF);  // turn off blue LED to show no more measuring
+        result = Detect_sample(&detect, distance);
+        if(result != Detect_Miss) {
+            Latency_mark(Latency_SampleAccepted);
+            Metrics_increment(Metrics_InWindowSamples);
+        }
 
-        if(logDistSensor) {
-            System_printf("duration: %i  distance: %i\n", duration, distance);
-            System_flush();
+        summaryDue = (Clock_getTicks() - summaryTick) * Clock_tickPeriod / 1000 >= (UInt32)sensorSummaryMillis;
+        if(recordRanges) {
+            recordRange(duration, distance, result == Detect_Trigger || summaryDue);
+        }
+        if(summaryDue) {
+            if(closestDistance != UINT16_MAX) {
+                FlashLog_append(FlashLog_Closest, closestDistance);
+            }
+            if(echoTimeouts != 0) {
+                FlashLog_append(FlashLog_EchoTimeouts, echoTimeouts);
+            }
+            closestDistance = UINT16_MAX;
+            echoTimeouts = 0;
+            summaryTick = Clock_getTicks();
+            FlashLog_flush();
         }
 
-        if(distance >= minTriggerDistance && distance <= maxTriggerDistance) {
+        if(result == Detect_Trigger) {
             //something is in range - let's move!!!
+            Latency_mark(Latency_TriggerConfirmed);
+            Metrics_increment(Metrics_ConfirmedTriggers);
 
-            state = RisingMode;
+            changeState(RisingMode);
+            Latency_mark(Latency_StateTransition);
+            showStartTick = Clock_getTicks();
 
             //raise body
-            if(logDistSensor) {
-                System_printf("Raising body...\n");
-                System_flush();
-            }
-            GPIO_write(transistorGatePin, 1);     // powers transistor (and an inline LED so we can see it happen)
+            AppLog_printf(AppLog_DistSensor, AppLog_Info, "Raising body...\n");
+            writePin(transistorGatePin, 1);     // powers transistor (and an inline LED so we can see it happen)
+            Latency_mark(Latency_FirstGpio);
+            FlashLog_append(FlashLog_Trigger, distance);
 
             //stop breathing
-            GPIO_write(breathingPin, 1);
+            writePin(breathingPin, 1);
 
             Task_sleep(lengthOfRisingMode);               // wait for length of mode
 
-            state = HowlingMode;
+            changeState(HowlingMode);
+            Latency_endRising();
             Task_sleep(headLiftMillisForHowlingMode);
             //howl();
-            GPIO_write(howlingPin, 1);                  //high turns it off
-            GPIO_write(howlingPin, 0);                  //low turns it on
+            writePin(howlingPin, 1);                  //high turns it off
+            howlStartTick = Clock_getTicks();           //mouth follows the envelope from here
+            howlPlaying = true;
+            writePin(howlingPin, 0);                  //low turns it on
             Task_sleep(lengthOfHowlMillis);
-            GPIO_write(howlingPin, 1);                  //high turns it off
+            writePin(howlingPin, 1);                  //high turns it off
+            howlPlaying = false;
             Task_sleep(lengthOfHowlingMode);            // wait for length of mode
 
 
-            state = LoweringMode;
+            changeState(LoweringMode);
             //lower body
-            if(logDistSensor) {
-                System_printf("Lowering body...\n");
-                System_flush();
-            }
-            GPIO_write(transistorGatePin, 0);      // power off transistor (and thus solenoid)
+            AppLog_printf(AppLog_DistSensor, AppLog_Info, "Lowering body...\n");
+            writePin(transistorGatePin, 0);      // power off transistor (and thus solenoid)
+            Metrics_increment(Metrics_SolenoidCycles);
             Task_sleep(lengthOfLoweringingMode);               // wait for length of mode
 
-            state = PanningMode;
+            changeState(PanningMode);
+            FlashLog_append(FlashLog_ShowDone, (Clock_getTicks() - showStartTick) * Clock_tickPeriod / 1000);
+            FlashLog_flush();
             //start breathing
-            GPIO_write(breathingPin, 1);                  //high turns it off
-            GPIO_write(breathingPin, 0);                  //low turns it on
+            writePin(breathingPin, 1);                  //high turns it off
+            writePin(breathingPin, 0);                  //low turns it on
 
             // delay long enough to allow body to lower and ready for next go...
             Task_sleep(resetMillis);
         }
 
         //delay before repeating sensing
-        Task_sleep(500);
+        Task_sleep(pingIntervalMillis);
     }
 }
 
@@ -378,10 +542,8 @@ int pulseDuration(int pinIndex) {
     // wait for any previous pulse to end
     while(GPIO_read(Dist_Sensor_Echo) == 1) {
         if(echo_loop_count++ == max_echo_loops) {
-            if(logDistSensor) {
-                System_printf("Pulse already in progress expired the time...\n");
-                System_flush();
-            }
+            Trace_event(Trace_EchoTimeout, 0, echo_loop_count);    // pulse already in progress expired the time
+            Metrics_increment(Metrics_EchoTimeouts);
             return 0;
         }
     }
@@ -389,10 +551,8 @@ int pulseDuration(int pinIndex) {
     // wait for pulse to start
     while(GPIO_read(Dist_Sensor_Echo) == 0) {
         if(echo_loop_count++ == max_echo_loops) {
-            if(logDistSensor) {
-                System_printf("Pulse never started...\n");
-                System_flush();
-            }
+            Trace_event(Trace_EchoTimeout, 1, echo_loop_count);    // pulse never started
+            Metrics_increment(Metrics_EchoTimeouts);
             return 0;
         }
     }
@@ -400,34 +560,30 @@ int pulseDuration(int pinIndex) {
     while (GPIO_read(Dist_Sensor_Echo) == 1) {
         duration++;
         if(echo_loop_count++ == max_echo_loops) {
-            if(logDistSensor) {
-                System_printf("Pulse maxed out...");
-                System_flush();
-            }
+            Trace_event(Trace_EchoTimeout, 2, echo_loop_count);    // pulse maxed out
+            Metrics_increment(Metrics_EchoTimeouts);
             return 0;
         }
     }
+    Latency_mark(Latency_EchoEdge);
 
     return duration;
 
 }
 
 Void logHeadTurnFxn(String text) {
-    if(logHeadTurn) {
+    if(AppLog_enabled(AppLog_HeadTurn, AppLog_Info)) {
         logFxn(text);
     }
 }
 Void logDistanceSensorFxn(String text) {
-    if(logDistSensor) {
+    if(AppLog_enabled(AppLog_DistSensor, AppLog_Info)) {
         logFxn(text);
     }
 }
-Void logFxn(text) {
-    System_printf("logging\n");
+Void logFxn(String text) {
+    // SysMin keeps this in its buffer until the next flush - no flush per message
     System_printf("%s\n",text);
-    System_flush();
-    System_printf("after logging\n");
-    System_flush();
 }
 
 /*
@@ -437,6 +593,7 @@ int main(void)
 {
     Task_Params tskParams;
     Task_Params headUpAndDownTaskParams;
+    Task_Params mouthOpenCloseTaskParams;
     Task_Params distSensorTaskParams;
 
     /* Call board init functions. */
@@ -444,6 +601,37 @@ int main(void)
     Board_initGPIO();
     Board_initPWM();
 
+    AppLog_setLevel(AppLog_HeadTurn, logHeadTurn);
+    AppLog_setLevel(AppLog_HeadLift, logHeadLift);
+    AppLog_setLevel(AppLog_MouthOpenClose, logMouthOpenClose);
+    AppLog_setLevel(AppLog_DistSensor, logDistSensor);
+
+    Trace_init();
+
+#if Bench_IMAGE
+    /* benchmark image: time the kernels (bench.h) instead of running the prop */
+    Bench_start();
+    BIOS_start();
+    return (0);
+#endif
+
+    CrashLog_init();
+    if (FlashLog_init()) {
+        FlashLog_append(FlashLog_Boot, (CrashLog_previous() != NULL) ? CrashLog_previous()->reason : CrashLog_None);
+    }
+    // a crash with the body up cut that show short
+    if (CrashLog_previous() != NULL && CrashLog_previous()->stateCount != 0 &&
+        CrashLog_previous()->states[CrashLog_previous()->stateCount - 1].state != PanningMode) {
+        Metrics_increment(Metrics_AbortedShows);
+    }
+    if (!UartLink_init()) {
+        System_printf("UART trace link did not open - trace stays in RAM\n");
+    }
+    TaskMon_init();
+    Profile_init();
+    Latency_init();
+    Metrics_init();
+
     /* Construct headSideToSide Task thread */
     Task_Params_init(&tskParams);
     tskParams.stackSize = TASKSTACKSIZE;
@@ -452,6 +640,7 @@ int main(void)
     Task_construct(&headSideToSide_Struct, (Task_FuncPtr)headSideToSideFxn, &tskParams, NULL);
     /* Obtain instance handle */
     headSideToSideTask = Task_handle(&headSideToSide_Struct);
+    TaskMon_watch(TaskMon_HeadSideToSide, headSideToSideTask);
 
     /* Construct headUpAndDown Task thread */
     Task_Params_init(&headUpAndDownTaskParams);
@@ -461,6 +650,17 @@ int main(void)
     Task_construct(&headUpAndDown_Struct, (Task_FuncPtr)headUpAndDownFxn, &headUpAndDownTaskParams, NULL);
     /* Obtain instance handle */
     headUpAndDownTask = Task_handle(&headUpAndDown_Struct);
+    TaskMon_watch(TaskMon_HeadUpDown, headUpAndDownTask);
+
+    /* Construct mouthOpenClose Task thread */
+    Task_Params_init(&mouthOpenCloseTaskParams);
+    mouthOpenCloseTaskParams.stackSize = TASKSTACKSIZE;
+    mouthOpenCloseTaskParams.stack = &mouthOpenClose_Stack;
+    mouthOpenCloseTaskParams.arg0 = 50;
+    Task_construct(&mouthOpenClose_Struct, (Task_FuncPtr)mouthOpenCloseFxn, &mouthOpenCloseTaskParams, NULL);
+    /* Obtain instance handle */
+    mouthOpenCloseTask = Task_handle(&mouthOpenClose_Struct);
+    TaskMon_watch(TaskMon_MouthOpenClose, mouthOpenCloseTask);
 
     /* Construct distance sensor Task thread */
     Task_Params_init(&distSensorTaskParams);
@@ -471,6 +671,7 @@ int main(void)
 
     /* Obtain instance handle */
     distSensorTask = Task_handle(&distSensorTask_Struct);
+    TaskMon_watch(TaskMon_DistSensor, distSensorTask);
 
     /* Turn on user LED */
     GPIO_write(Board_LED0, Board_LED_ON);